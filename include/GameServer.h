@@ -53,7 +53,7 @@ public:
     
     // 消息处理
     void registerMessageHandlers();
-    void sendResponse(const std::string& clientId, ResponseType responseType, const std::string& message, const std::string& data);
+    void sendResponse(ConnectionId clientId, ResponseType responseType, const std::string& message, const std::string& data);
 
 private:
     void setupSignalHandlers();
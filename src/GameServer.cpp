@@ -3,6 +3,7 @@
 
 #include "GameServer.h"
 #include "logging/Log.h"
+#include "main/ThreadPlacement.h"
 #include "../messaging/message.h"
 #include "messaging/result.h"
 
@@ -106,6 +107,12 @@ bool GameServerApp::initialize()
 
         displayConfiguration();
         
+        // 线程放置须在创建日志、数据库和网络线程之前确定
+        if (!ThreadPlacement::configure(config))
+        {
+            cerr << "Some [Threads] CPU lists have no usable CPUs, those threads will not be pinned" << endl;
+        }
+        
         // 初始化日志系统
         cout << "=================================" << endl;
         cout << "Initializing logging system..." << endl;
@@ -157,6 +164,8 @@ bool GameServerApp::initialize()
         cout << "=================================" << endl;
         cout << "Creating main loop..." << endl;
         mainLoop = new MainLoop();
+        mainLoop->setBatchBudget(static_cast<size_t>(max(1, config->getMainLoopBatchBudget())));
+        mainLoop->setSlowBatchThreshold(config->getMainLoopSlowBatchMs());
         cout << "Main loop created" << endl;
         
         // 将网络服务器引用传递给主循环
@@ -214,11 +223,75 @@ void GameServerApp::run()
         LOG_INFO("Main loop started");
     }
     
+    uint64_t lastListenOverflows = server ? server->getAcceptStats().listenOverflows : 0;
+    PollStats lastPollStats = server ? server->getPollStats() : PollStats();
+    MainLoopStats lastMainLoopStats = mainLoop ? mainLoop->collectStats() : MainLoopStats();
+    bool draining = false;
+    chrono::steady_clock::time_point drainDeadline;
     while (isRunning && server && server->isServerRunning())
     {
+        // 热重启：连接已交给新进程，剩下交接不了的连接断开或超时后退出
+        if (server->isHandedOver())
+        {
+            if (!draining)
+            {
+                draining = true;
+                drainDeadline = chrono::steady_clock::now() + chrono::seconds(max(0, config->getHandoverDrainTimeout()));
+                LOG_INFO("Handed over to the new server process, draining {} remaining connection(s)", server->getActiveConnections());
+            }
+            if (server->getActiveConnections() == 0 || chrono::steady_clock::now() >= drainDeadline)
+            {
+                LOG_INFO("Drain finished with {} connection(s) left, exiting", server->getActiveConnections());
+                break;
+            }
+        }
+        
         // 显示服务器状态
         LOG_INFO("\rActive connections: {} | Press Ctrl+C to stop", server->getActiveConnections());
         
+        // 监听队列溢出时报告，说明accept跟不上连接速度
+        NetworkServer::AcceptStats acceptStats = server->getAcceptStats();
+        if (acceptStats.listenOverflows > lastListenOverflows)
+        {
+            LOG_WARN("Listen queue overflowed {} time(s) in the last second (accepted: {}, capped wakeups: {}, backlog full: {})",
+                     acceptStats.listenOverflows - lastListenOverflows, acceptStats.accepted,
+                     acceptStats.cappedWakeups, acceptStats.backlogFull);
+        }
+        lastListenOverflows = acceptStats.listenOverflows;
+        
+        // 开启自旋等待时报告上一秒自旋与阻塞唤醒的比例，用于权衡CPU占用和延迟
+        PollStats pollStats = server->getPollStats();
+        uint64_t spinWakeups = pollStats.spinWakeups - lastPollStats.spinWakeups;
+        uint64_t blockWakeups = pollStats.blockWakeups - lastPollStats.blockWakeups;
+        if (config->getBusyPollMicros() > 0 && spinWakeups + blockWakeups > 0)
+        {
+            LOG_INFO("Reactor wakeups in the last second: {} spin / {} block ({:.1f}% spin), spun {} us, spin budget {} us",
+                     spinWakeups, blockWakeups, 100.0 * spinWakeups / (spinWakeups + blockWakeups),
+                     pollStats.spinMicros - lastPollStats.spinMicros, pollStats.spinBudgetUs);
+        }
+        lastPollStats = pollStats;
+        
+        // 主循环上一秒的批处理情况：排队延迟应为微秒级，批处理时间反映业务处理的负载
+        if (mainLoop)
+        {
+            MainLoopStats loopStats = mainLoop->collectStats();
+            uint64_t batches = loopStats.batches - lastMainLoopStats.batches;
+            if (batches > 0)
+            {
+                LOG_DEBUG("Main loop in the last second: {} message(s) in {} batch(es), busy {} us, "
+                          "largest batch {}, longest batch {} us, max queue delay {} us",
+                          loopStats.messages - lastMainLoopStats.messages, batches,
+                          loopStats.handleMicros - lastMainLoopStats.handleMicros, loopStats.maxBatchSize,
+                          loopStats.maxBatchMicros, loopStats.maxQueueDelayMicros);
+            }
+            if (loopStats.droppedMessages > lastMainLoopStats.droppedMessages)
+            {
+                LOG_WARN("Main loop queue dropped {} message(s) in the last second",
+                         loopStats.droppedMessages - lastMainLoopStats.droppedMessages);
+            }
+            lastMainLoopStats = loopStats;
+        }
+        
         // 睡眠1秒
         this_thread::sleep_for(chrono::seconds(1));
     }
@@ -380,6 +453,10 @@ void GameServerApp::registerMessageHandlers()
             try {
                 bool success = accountDB->verifyPassword(loginMsg->getUsername(), loginMsg->getPassword());
                 if (success) {
+                    // 登录成功后连接只受心跳超时约束
+                    if (server) {
+                        server->setClientAuthenticated(loginMsg->getClientId());
+                    }
                     sendResponse(loginMsg->getClientId(), ResponseType::SUCCESS, "Login successful", "");
                 } else {
                     sendResponse(loginMsg->getClientId(), ResponseType::SERVICE_ERROR, "Invalid credentials", "");
@@ -419,9 +496,9 @@ void GameServerApp::registerMessageHandlers()
     LOG_INFO("Message handlers registered successfully");
 }
 
-void GameServerApp::sendResponse(const std::string& clientId, ResponseType responseType, const std::string& message, const std::string& data)
+void GameServerApp::sendResponse(ConnectionId clientId, ResponseType responseType, const std::string& message, const std::string& data)
 {
-    LOG_INFO("Sending response to client {}: [{}] {}", clientId, static_cast<int>(responseType), message);
+    LOG_INFO("Sending response to client {}: [{}] {}", clientId.value(), static_cast<int>(responseType), message);
     
     if (server) {
         server->sendResponseToClient(clientId, responseType, message, data);
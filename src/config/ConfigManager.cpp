@@ -240,6 +240,16 @@ int ConfigManager::getRequestTimeout() const
     return reader ? reader->getInt("Performance", "RequestTimeout", 30) : 30;
 }
 
+int ConfigManager::getMainLoopBatchBudget() const
+{
+    return reader ? reader->getInt("Performance", "MainLoopBatchBudget", 256) : 256;
+}
+
+int ConfigManager::getMainLoopSlowBatchMs() const
+{
+    return reader ? reader->getInt("Performance", "MainLoopSlowBatchMs", 50) : 50;
+}
+
 // Cache Configuration
 bool ConfigManager::isCacheEnabled() const
 {
@@ -338,6 +348,21 @@ int ConfigManager::getRateLimitWindow() const
     return reader ? reader->getInt("Features", "RateLimitWindow", 60) : 60;
 }
 
+std::string ConfigManager::getRateLimitPolicy() const
+{
+    return reader ? reader->getString("Features", "RateLimitPolicy", "drop") : "drop";
+}
+
+std::string ConfigManager::getRateLimitMessages() const
+{
+    return reader ? reader->getString("Features", "RateLimitMessages", "") : "";
+}
+
+int ConfigManager::getMaxInboundBufferBytes() const
+{
+    return reader ? reader->getInt("Features", "MaxInboundBufferBytes", 65536) : 65536;
+}
+
 // Network Configuration
 bool ConfigManager::isSSLEnabled() const
 {
@@ -374,6 +399,187 @@ std::string ConfigManager::getAllowedHeaders() const
     return reader ? reader->getString("Network", "AllowedHeaders", "*") : "*";
 }
 
+int ConfigManager::getReactorThreads() const
+{
+    return reader ? reader->getInt("Network", "ReactorThreads", 1) : 1;
+}
+
+std::string ConfigManager::getIOBackend() const
+{
+    return reader ? reader->getString("Network", "IOBackend", "epoll") : "epoll";
+}
+
+bool ConfigManager::isEdgeTriggeredEnabled() const
+{
+    return reader ? reader->getBool("Network", "EnableEdgeTriggered", false) : false;
+}
+
+int ConfigManager::getIOBudgetBytes() const
+{
+    return reader ? reader->getInt("Network", "IOBudgetBytes", 65536) : 65536;
+}
+
+int ConfigManager::getAcceptBatchSize() const
+{
+    return reader ? reader->getInt("Network", "AcceptBatchSize", 64) : 64;
+}
+
+int ConfigManager::getWriteHighWatermark() const
+{
+    return reader ? reader->getInt("Network", "WriteHighWatermark", 1048576) : 1048576;
+}
+
+int ConfigManager::getWriteLowWatermark() const
+{
+    return reader ? reader->getInt("Network", "WriteLowWatermark", 262144) : 262144;
+}
+
+int ConfigManager::getSlowClientTimeout() const
+{
+    return reader ? reader->getInt("Network", "SlowClientTimeout", 10) : 10;
+}
+
+int ConfigManager::getBusyPollMicros() const
+{
+    return reader ? reader->getInt("Network", "BusyPollMicros", 0) : 0;
+}
+
+int ConfigManager::getSocketBusyPollMicros() const
+{
+    return reader ? reader->getInt("Network", "SocketBusyPollMicros", 0) : 0;
+}
+
+int ConfigManager::getUdpPort() const
+{
+    return reader ? reader->getInt("Network", "UdpPort", 0) : 0;
+}
+
+int ConfigManager::getUdpMtu() const
+{
+    return reader ? reader->getInt("Network", "UdpMtu", 1200) : 1200;
+}
+
+int ConfigManager::getUdpInterval() const
+{
+    return reader ? reader->getInt("Network", "UdpInterval", 10) : 10;
+}
+
+int ConfigManager::getUdpSendWindow() const
+{
+    return reader ? reader->getInt("Network", "UdpSendWindow", 128) : 128;
+}
+
+int ConfigManager::getUdpReceiveWindow() const
+{
+    return reader ? reader->getInt("Network", "UdpReceiveWindow", 128) : 128;
+}
+
+int ConfigManager::getUdpFastResend() const
+{
+    return reader ? reader->getInt("Network", "UdpFastResend", 2) : 2;
+}
+
+int ConfigManager::getUdpMinRto() const
+{
+    return reader ? reader->getInt("Network", "UdpMinRto", 30) : 30;
+}
+
+int ConfigManager::getUdpDeadLinkResends() const
+{
+    return reader ? reader->getInt("Network", "UdpDeadLinkResends", 20) : 20;
+}
+
+int ConfigManager::getUdpSimulatedLoss() const
+{
+    return reader ? reader->getInt("Network", "UdpSimulatedLoss", 0) : 0;
+}
+
+std::string ConfigManager::getUnixSocketPath() const
+{
+    return reader ? reader->getString("Network", "UnixSocketPath", "") : "";
+}
+
+std::string ConfigManager::getSharedMemorySocketPath() const
+{
+    return reader ? reader->getString("Network", "SharedMemorySocketPath", "") : "";
+}
+
+int ConfigManager::getSharedMemoryRingBytes() const
+{
+    return reader ? reader->getInt("Network", "SharedMemoryRingBytes", 4194304) : 4194304;
+}
+
+std::string ConfigManager::getGatewayToken() const
+{
+    return reader ? reader->getString("Network", "GatewayToken", "") : "";
+}
+
+int ConfigManager::getMaxGatewaySessions() const
+{
+    return reader ? reader->getInt("Network", "MaxGatewaySessions", 100000) : 100000;
+}
+
+std::string ConfigManager::getHandoverSocketPath() const
+{
+    return reader ? reader->getString("Network", "HandoverSocketPath", "") : "";
+}
+
+int ConfigManager::getHandoverDrainTimeout() const
+{
+    return reader ? reader->getInt("Network", "HandoverDrainTimeout", 30) : 30;
+}
+
+bool ConfigManager::isCompressionEnabled() const
+{
+    return reader ? reader->getBool("Network", "EnableCompression", false) : false;
+}
+
+int ConfigManager::getCompressionThreshold() const
+{
+    return reader ? reader->getInt("Network", "CompressionThreshold", 0) : 0;
+}
+
+std::string ConfigManager::getCompressionThresholds() const
+{
+    return reader ? reader->getString("Network", "CompressionThresholds", "") : "";
+}
+
+std::string ConfigManager::getCompressionDictionary() const
+{
+    return reader ? reader->getString("Network", "CompressionDictionary", "") : "";
+}
+
+// Thread Placement Configuration
+std::string ConfigManager::getReactorCpus() const
+{
+    return reader ? reader->getString("Threads", "ReactorCpus", "") : "";
+}
+
+bool ConfigManager::isPinReactorPerCpu() const
+{
+    return reader ? reader->getBool("Threads", "PinReactorPerCpu", true) : true;
+}
+
+std::string ConfigManager::getMainLoopCpus() const
+{
+    return reader ? reader->getString("Threads", "MainLoopCpus", "") : "";
+}
+
+std::string ConfigManager::getDatabaseCpus() const
+{
+    return reader ? reader->getString("Threads", "DatabaseCpus", "") : "";
+}
+
+std::string ConfigManager::getLoggingCpus() const
+{
+    return reader ? reader->getString("Threads", "LoggingCpus", "") : "";
+}
+
+std::string ConfigManager::getTransportCpus() const
+{
+    return reader ? reader->getString("Threads", "TransportCpus", "") : "";
+}
+
 // Development Configuration
 bool ConfigManager::isDebugMode() const
 {
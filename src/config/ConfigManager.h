@@ -88,6 +88,8 @@ public:
     int getReceiveBufferSize() const;
     int getSendBufferSize() const;
     int getRequestTimeout() const;
+    int getMainLoopBatchBudget() const;
+    int getMainLoopSlowBatchMs() const;
 
     // Cache Configuration
     bool isCacheEnabled() const;
@@ -113,6 +115,9 @@ public:
     bool isRateLimitEnabled() const;
     int getRateLimitRequests() const;
     int getRateLimitWindow() const;
+    std::string getRateLimitPolicy() const;
+    std::string getRateLimitMessages() const;
+    int getMaxInboundBufferBytes() const;
 
     // Network Configuration
     bool isSSLEnabled() const;
@@ -122,6 +127,44 @@ public:
     std::string getAllowedOrigins() const;
     std::string getAllowedMethods() const;
     std::string getAllowedHeaders() const;
+    int getReactorThreads() const;
+    std::string getIOBackend() const;
+    bool isEdgeTriggeredEnabled() const;
+    int getIOBudgetBytes() const;
+    int getAcceptBatchSize() const;
+    int getWriteHighWatermark() const;
+    int getWriteLowWatermark() const;
+    int getSlowClientTimeout() const;
+    int getBusyPollMicros() const;
+    int getSocketBusyPollMicros() const;
+    int getUdpPort() const;
+    int getUdpMtu() const;
+    int getUdpInterval() const;
+    int getUdpSendWindow() const;
+    int getUdpReceiveWindow() const;
+    int getUdpFastResend() const;
+    int getUdpMinRto() const;
+    int getUdpDeadLinkResends() const;
+    int getUdpSimulatedLoss() const;
+    std::string getUnixSocketPath() const;
+    std::string getSharedMemorySocketPath() const;
+    int getSharedMemoryRingBytes() const;
+    std::string getGatewayToken() const;
+    int getMaxGatewaySessions() const;
+    std::string getHandoverSocketPath() const;
+    int getHandoverDrainTimeout() const;
+    bool isCompressionEnabled() const;
+    int getCompressionThreshold() const;
+    std::string getCompressionThresholds() const;
+    std::string getCompressionDictionary() const;
+
+    // Thread Placement Configuration
+    std::string getReactorCpus() const;
+    bool isPinReactorPerCpu() const;
+    std::string getMainLoopCpus() const;
+    std::string getDatabaseCpus() const;
+    std::string getLoggingCpus() const;
+    std::string getTransportCpus() const;
 
     // Development Configuration
     bool isDebugMode() const;
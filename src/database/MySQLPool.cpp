@@ -1,5 +1,6 @@
 #include "MySQLPool.h"
 #include "Log.h"
+#include "ThreadPlacement.h"
 #include <algorithm>
 
 MySQLPool::MySQLPool(const Config& config)
@@ -229,6 +230,7 @@ void MySQLPool::cleanupIdleConnections() {
 }
 
 void MySQLPool::connectionHealthCheck() {
+    ThreadPlacement::apply(ThreadRole::DATABASE, "db-health");
     while (!shutdown_) {
         std::this_thread::sleep_for(healthCheckInterval_);
         
@@ -247,6 +249,7 @@ void MySQLPool::connectionHealthCheck() {
 }
 
 void MySQLPool::cleanupThreadFunc() {
+    ThreadPlacement::apply(ThreadRole::DATABASE, "db-cleanup");
     while (!shutdown_) {
         std::this_thread::sleep_for(std::chrono::seconds(60)); // Run every minute
         
@@ -4,7 +4,7 @@
 #include <sstream>
 #include <iomanip>
 
-std::unique_ptr<Message> convertNetworkMessageToMessage(const NetworkMessage& networkMessage, uint64_t clientId) {
+std::unique_ptr<Message> convertNetworkMessageToMessage(const NetworkMessage& networkMessage, ConnectionId clientId) {
     const auto& header = networkMessage.getHeader();
     const auto& body = networkMessage.getBody();
     
@@ -32,61 +32,78 @@ std::unique_ptr<Message> convertNetworkMessageToMessage(const NetworkMessage& ne
             break;
     }
     
+    // 字段在消息体的视图上切分，只复制最终需要的字段
+    std::string_view bodyData = body.getSlice().view();
     switch (type) {
         case MessageType::LOGIN: {
             std::string username, password;
-            std::string bodyData(reinterpret_cast<const char*>(body.getData()), body.getSize());
             size_t pos = bodyData.find('|');
-            if (pos != std::string::npos) {
-                username = bodyData.substr(0, pos);
-                password = bodyData.substr(pos + 1);
+            if (pos != std::string_view::npos) {
+                username = std::string(bodyData.substr(0, pos));
+                password = std::string(bodyData.substr(pos + 1));
             }
-            return std::make_unique<LoginMessage>(username, password, std::to_string(clientId));
+            return std::make_unique<LoginMessage>(username, password, clientId);
         }
         case MessageType::REGISTER: {
             std::string username, password, email;
-            std::string bodyData(reinterpret_cast<const char*>(body.getData()), body.getSize());
             size_t pos1 = bodyData.find('|');
             size_t pos2 = bodyData.find('|', pos1 + 1);
-            if (pos1 != std::string::npos && pos2 != std::string::npos) {
-                username = bodyData.substr(0, pos1);
-                password = bodyData.substr(pos1 + 1, pos2 - pos1 - 1);
-                email = bodyData.substr(pos2 + 1);
+            if (pos1 != std::string_view::npos && pos2 != std::string_view::npos) {
+                username = std::string(bodyData.substr(0, pos1));
+                password = std::string(bodyData.substr(pos1 + 1, pos2 - pos1 - 1));
+                email = std::string(bodyData.substr(pos2 + 1));
             }
-            return std::make_unique<RegisterMessage>(username, password, email, std::to_string(clientId));
+            return std::make_unique<RegisterMessage>(username, password, email, clientId);
         }
         default: {
-            std::string payload(reinterpret_cast<const char*>(body.getData()), body.getSize());
-            return std::make_unique<Message>(type, payload, std::to_string(clientId));
+            // payload与消息体共享存储
+            return std::make_unique<Message>(type, body.getSlice(), clientId);
         }
     }
 }
 
 std::unique_ptr<NetworkMessage> MessageParser::parseMessage(const std::vector<uint8_t>& data) {
-    if (data.size() < sizeof(MessageHeader)) {
+    return parseMessage(data.data(), data.size());
+}
+
+std::unique_ptr<NetworkMessage> MessageParser::parseMessage(const uint8_t* data, size_t size) {
+    if (size < sizeof(MessageHeader)) {
         return nullptr;
     }
     
     auto message = std::make_unique<NetworkMessage>();
-    if (message->deserialize(data.data(), data.size())) {
+    if (message->deserialize(data, size)) {
         return message;
     }
     
     return nullptr;
 }
 
-bool MessageParser::isCompleteMessage(const std::vector<uint8_t>& data) {
-    if (data.size() < sizeof(MessageHeader)) {
-        return false;
+std::unique_ptr<NetworkMessage> MessageParser::parseMessage(const BufferSlice& frame) {
+    if (frame.size() < sizeof(MessageHeader)) {
+        return nullptr;
+    }
+    
+    auto message = std::make_unique<NetworkMessage>();
+    if (message->deserialize(frame)) {
+        return message;
     }
     
+    return nullptr;
+}
+
+bool MessageParser::isCompleteMessage(const std::vector<uint8_t>& data) {
+    return getCompleteMessageSize(data.data(), data.size()) > 0;
+}
+
+size_t MessageParser::getCompleteMessageSize(const uint8_t* data, size_t size) {
     MessageHeader header;
-    if (!header.deserialize(data.data(), data.size())) {
-        return false;
+    if (!header.deserialize(data, size)) {
+        return 0;
     }
     
     size_t expectedSize = sizeof(MessageHeader) + header.dataLength;
-    return data.size() >= expectedSize;
+    return size >= expectedSize ? expectedSize : 0;
 }
 
 NetworkMessage MessageParser::createLoginMessage(const std::string& username, const std::string& password) {
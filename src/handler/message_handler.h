@@ -7,14 +7,20 @@
 #include <string>
 #include <cstdint>
 
-std::unique_ptr<Message> convertNetworkMessageToMessage(const NetworkMessage& networkMessage, uint64_t clientId);
+std::unique_ptr<Message> convertNetworkMessageToMessage(const NetworkMessage& networkMessage, ConnectionId clientId);
 
 class MessageParser {
 public:
     static std::unique_ptr<NetworkMessage> parseMessage(const std::vector<uint8_t>& data);
+    static std::unique_ptr<NetworkMessage> parseMessage(const uint8_t* data, size_t size);
+    // 消息体直接引用frame的存储，不复制
+    static std::unique_ptr<NetworkMessage> parseMessage(const BufferSlice& frame);
     
     static bool isCompleteMessage(const std::vector<uint8_t>& data);
     
+    // 返回data开头完整帧的总长度（头 + 体），数据不完整时返回0
+    static size_t getCompleteMessageSize(const uint8_t* data, size_t size);
+    
     static NetworkMessage createLoginMessage(const std::string& username, const std::string& password);
     
     static NetworkMessage createRegisterMessage(const std::string& username, const std::string& password, const std::string& email);
@@ -1,5 +1,6 @@
 #include "Log.h"
 #include "ConfigManager.h"
+#include "ThreadPlacement.h"
 
 #ifdef _WIN32
     #ifndef WIN32_LEAN_AND_MEAN
@@ -14,13 +15,16 @@
 #else
     #include <unistd.h>
     #include <errno.h>
+    #include <sys/stat.h>
 #endif
 
 #include <cstdio>
+#include <cstring>
 
 #include <algorithm>
 #include <iostream>
 #include <thread>
+#include <atomic>
 #include <chrono>
 
 bool Log::initialize(ConfigManager *config)
@@ -67,7 +71,13 @@ bool Log::initialize(ConfigManager *config)
             // 确保线程数至少为1，队列大小至少为1024
             int threadCount = asyncThreadCount > 0 ? asyncThreadCount : 1;
             int queueSize = asyncQueueSize > 0 ? asyncQueueSize : 8192;
-            spdlog::init_thread_pool(queueSize, threadCount); // 使用配置的队列大小和工作线程数
+            // 日志线程按log-N命名并绑定到LoggingCpus；此时日志尚未初始化，绑定失败也不输出
+            // 回调在线程池各线程中异步执行，计数器不能放在栈上
+            static std::atomic<int> logThreadIndex{0};
+            spdlog::init_thread_pool(queueSize, threadCount, []() {
+                int index = logThreadIndex++;
+                ThreadPlacement::apply(ThreadRole::LOGGING, "log-" + std::to_string(index), index);
+            }); // 使用配置的队列大小和工作线程数
         }
 
         // 设置全局日志级别
@@ -280,15 +290,23 @@ spdlog::level::level_enum Log::getSpdLogLevel(const std::string &level)
 std::string Log::getLogDirectory()
 {
     // 获取可执行文件目录
+#ifdef _WIN32
     char buffer[MAX_PATH];
     GetModuleFileNameA(NULL, buffer, MAX_PATH);
-
     std::string exePath(buffer);
+    const char* separator = "\\";
+#else
+    char buffer[4096];
+    ssize_t length = readlink("/proc/self/exe", buffer, sizeof(buffer) - 1);
+    std::string exePath(buffer, length > 0 ? static_cast<size_t>(length) : 0);
+    const char* separator = "/";
+#endif
+
     size_t lastSlash = exePath.find_last_of("\\/");
     if (lastSlash != std::string::npos)
     {
         std::string exeDir = exePath.substr(0, lastSlash);
-        std::string logDir = exeDir + "\\logs";
+        std::string logDir = exeDir + separator + "logs";
 
         // 输出调试信息
         std::cout << "Executable path: " << exePath << std::endl;
@@ -298,7 +316,11 @@ std::string Log::getLogDirectory()
     }
 
     // 如果获取失败，返回绝对路径
+#ifdef _WIN32
     return "D:\\work\\AccountSvr\\vs_project\\Debug\\logs";
+#else
+    return "logs";
+#endif
 }
 
 void Log::createLogDirectory(const std::string &directory)
@@ -1,6 +1,7 @@
 #include "MainLoop.h"
 #include "database/DatabaseManager.h"
 #include "Log.h"
+#include "ThreadPlacement.h"
 #include "network/NetworkServer.h"
 #include "messaging/result.h"
 #include "../messaging/message.h"
@@ -40,6 +41,8 @@ void MainLoop::stop() {
     
     LOG_INFO("Stopping MainLoop");
     running_ = false;
+    // 唤醒在waitForMessage中休眠的主循环线程，不必等满IDLE_WAIT_MS；关闭后reactor的addMessage立即失败
+    messageQueue_.shutdown();
     
     if (loopThread_.joinable()) {
         loopThread_.join();
@@ -52,31 +55,122 @@ bool MainLoop::isRunning() const {
     return running_;
 }
 
+bool MainLoop::isIdle() const {
+    return !handling_.load() && messageQueue_.empty();
+}
+
+void MainLoop::setBatchBudget(size_t budget) {
+    batchBudget_ = std::min(std::max<size_t>(1, budget), messageQueue_.capacity());
+}
+
+MainLoopStats MainLoop::collectStats() {
+    MainLoopStats stats;
+    stats.batches = batches_.load(std::memory_order_relaxed);
+    stats.messages = handledMessages_.load(std::memory_order_relaxed);
+    stats.handleMicros = handleMicros_.load(std::memory_order_relaxed);
+    stats.droppedMessages = droppedMessages_.load(std::memory_order_relaxed);
+    stats.maxBatchSize = maxBatchSize_.exchange(0, std::memory_order_relaxed);
+    stats.maxBatchMicros = maxBatchMicros_.exchange(0, std::memory_order_relaxed);
+    stats.maxQueueDelayMicros = maxQueueDelayMicros_.exchange(0, std::memory_order_relaxed);
+    return stats;
+}
+
+void MainLoop::recordBatch(size_t size, uint64_t handleMicros, uint64_t queueDelayMicros) {
+    // 只有主循环线程写入，峰值与collectStats的重置之间偶尔丢失一次更新无妨
+    batches_.fetch_add(1, std::memory_order_relaxed);
+    handledMessages_.fetch_add(size, std::memory_order_relaxed);
+    handleMicros_.fetch_add(handleMicros, std::memory_order_relaxed);
+    if (size > maxBatchSize_.load(std::memory_order_relaxed)) {
+        maxBatchSize_.store(size, std::memory_order_relaxed);
+    }
+    if (handleMicros > maxBatchMicros_.load(std::memory_order_relaxed)) {
+        maxBatchMicros_.store(handleMicros, std::memory_order_relaxed);
+    }
+    if (queueDelayMicros > maxQueueDelayMicros_.load(std::memory_order_relaxed)) {
+        maxQueueDelayMicros_.store(queueDelayMicros, std::memory_order_relaxed);
+    }
+}
+
 MessagePtr MainLoop::getNextMessage() {
     return messageQueue_.pop(false);
 }
 
-void MainLoop::addMessage(MessagePtr message) {
-    if (message) {
-        messageQueue_.push(std::move(message));
+bool MainLoop::addMessage(MessagePtr message) {
+    if (!message) {
+        return false;
     }
+    if (messageQueue_.push(std::move(message))) {
+        return true;
+    }
+    // 主循环跟不上时丢弃新消息，日志按2的幂次间隔输出，避免在过载时刷屏
+    uint64_t dropped = droppedMessages_.fetch_add(1, std::memory_order_relaxed) + 1;
+    if ((dropped & (dropped - 1)) == 0) {
+        LOG_WARN("MainLoop queue is full ({} messages), {} message(s) dropped so far", messageQueue_.capacity(), dropped);
+    }
+    return false;
+}
+
+MessagePtr MainLoop::expandFrame(const Message& message) {
+    if (!networkServer_) {
+        return nullptr;
+    }
+    
+    BufferSlice frame = networkServer_->getFrameCompressor().decode(message.getPayload());
+    auto networkMessage = frame.empty() ? nullptr : MessageParser::parseMessage(frame);
+    if (!networkMessage) {
+        LOG_WARN("Dropping corrupted compressed frame from client {}", message.getClientId().value());
+        return nullptr;
+    }
+    if (networkMessage->getHeader().messageId == MessageIds::HEARTBEAT) {
+        return nullptr;
+    }
+    return convertNetworkMessageToMessage(*networkMessage, message.getClientId());
 }
 
 void MainLoop::runLoop() {
+    if (!ThreadPlacement::apply(ThreadRole::MAIN_LOOP, "main-loop")) {
+        LOG_WARN("Failed to pin MainLoop thread to its configured CPUs");
+    }
     LOG_INFO("MainLoop thread started");
     
+    std::vector<MessagePtr> batch;
+    batch.reserve(batchBudget_);
     while (running_) {
-        try {
-            auto message = getNextMessage();
-            
-            if (message) {
-                messageHandler_.handleMessage(*message);
-            } else {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        // 取出消息前先置位，isIdle不会在消息出队后、处理完成前返回true
+        handling_ = true;
+        // 一次取出所有待处理的消息（不超过预算），队列的开销按批而不是按条支付
+        if (messageQueue_.popBatch(batch, batchBudget_, 0) == 0) {
+            // 休眠期间不算在处理中；生产者入队或stop关闭队列后立即唤醒
+            handling_ = false;
+            messageQueue_.waitForMessage(IDLE_WAIT_MS);
+            continue;
+        }
+        
+        // 消息按入队顺序排列，第一条等待得最久
+        auto batchStart = std::chrono::steady_clock::now();
+        auto queueDelay = std::chrono::system_clock::now() - batch.front()->getTimestamp();
+        for (auto& message : batch) {
+            try {
+                if (message->getType() == MessageType::COMPRESSED_FRAME) {
+                    message = expandFrame(*message);
+                }
+                if (message) {
+                    messageHandler_.handleMessage(*message);
+                }
+            } catch (const std::exception& e) {
+                LOG_ERROR("Exception in MainLoop: {}", e.what());
             }
-        } catch (const std::exception& e) {
-            LOG_ERROR("Exception in MainLoop: {}", e.what());
         }
+        
+        uint64_t handleMicros = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - batchStart).count());
+        int64_t queueDelayMicros = std::chrono::duration_cast<std::chrono::microseconds>(queueDelay).count();
+        recordBatch(batch.size(), handleMicros, static_cast<uint64_t>(std::max<int64_t>(0, queueDelayMicros)));
+        if (slowBatchMicros_ > 0 && handleMicros >= slowBatchMicros_) {
+            LOG_WARN("MainLoop batch of {} message(s) took {} ms", batch.size(), handleMicros / 1000);
+        }
+        batch.clear();
+        handling_ = false;
     }
     
     LOG_INFO("MainLoop thread ended");
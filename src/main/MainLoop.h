@@ -4,12 +4,24 @@
 #include <memory>
 #include <atomic>
 #include <mutex>
+#include <algorithm>
 #include "database/AccountDB.h"
 #include "Log.h"
 #include "../handler/MainLoopHandler.h"
 
 class NetworkServer;
 
+// 主循环处理统计，按批记录；计数为累计值，峰值在每次collectStats后重新统计
+struct MainLoopStats {
+    uint64_t batches = 0;
+    uint64_t messages = 0;
+    uint64_t handleMicros = 0;          // 累计处理时间
+    uint64_t droppedMessages = 0;       // 队列已满被丢弃的消息
+    uint64_t maxBatchSize = 0;
+    uint64_t maxBatchMicros = 0;        // 单批最长处理时间
+    uint64_t maxQueueDelayMicros = 0;   // 批中最早的消息从创建到开始处理的最长时间
+};
+
 class MainLoop {
 public:
     MainLoop();
@@ -18,9 +30,19 @@ public:
     void start();
     void stop();
     bool isRunning() const;
+    // 队列为空且没有正在处理的消息（热重启交接时等待已收到的请求处理完）
+    bool isIdle() const;
 
     MessagePtr getNextMessage();
-    void addMessage(MessagePtr message);
+    // 队列已满或已关闭时丢弃消息并返回false，由调用方决定如何答复客户端
+    bool addMessage(MessagePtr message);
+
+    // 每批最多处理的消息数，超出的留到下一批，其间可以检查running_
+    void setBatchBudget(size_t budget);
+    // 单批处理超过该毫秒数时记录警告，0为不检查
+    void setSlowBatchThreshold(int ms) { slowBatchMicros_ = static_cast<uint64_t>(std::max(0, ms)) * 1000; }
+    // 取统计并重置峰值（只应由一个监控线程调用）
+    MainLoopStats collectStats();
 
     void setNetworkServer(NetworkServer* networkServer) {
         networkServer_ = networkServer;
@@ -32,12 +54,29 @@ public:
 
 private:
     void runLoop();
+    // 解压COMPRESSED_FRAME消息并转换为原消息类型，帧无效或为心跳时返回nullptr
+    MessagePtr expandFrame(const Message& message);
 
 private:
+    static constexpr size_t DEFAULT_BATCH_BUDGET = 256;
+    static constexpr int IDLE_WAIT_MS = 100;
+
+    void recordBatch(size_t size, uint64_t handleMicros, uint64_t queueDelayMicros);
+
     std::atomic<bool> running_;
+    std::atomic<bool> handling_{false};
     std::thread loopThread_;
     MessageQueue messageQueue_;
-    std::mutex messageQueueMutex_;
+    std::atomic<uint64_t> droppedMessages_{0};
+    size_t batchBudget_ = DEFAULT_BATCH_BUDGET;
+    uint64_t slowBatchMicros_ = 0;
+    // 处理统计，由主循环线程写入
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> handledMessages_{0};
+    std::atomic<uint64_t> handleMicros_{0};
+    std::atomic<uint64_t> maxBatchSize_{0};
+    std::atomic<uint64_t> maxBatchMicros_{0};
+    std::atomic<uint64_t> maxQueueDelayMicros_{0};
     AccountDB* accountDB_;
     NetworkServer* networkServer_;
     MainLoopHandler messageHandler_;
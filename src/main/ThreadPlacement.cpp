@@ -0,0 +1,168 @@
+#include "ThreadPlacement.h"
+#include "ConfigManager.h"
+
+#include <cstdlib>
+#include <sstream>
+
+#ifdef __linux__
+    #include <pthread.h>
+    #include <sched.h>
+    #include <dirent.h>
+    #include <unistd.h>
+    #include <sys/syscall.h>
+    #include <cstring>
+#endif
+
+namespace {
+
+struct RolePlacement {
+    std::vector<int> cpus;
+    bool perThread = false;     // 按index逐个绑定到集合中的一个CPU
+    int numaNode = -1;          // 集合中的CPU都在同一节点时为该节点
+};
+
+RolePlacement placements[static_cast<int>(ThreadRole::COUNT)];
+
+#ifdef __linux__
+// 与<numaif.h>中的定义相同，避免依赖libnuma
+constexpr int MPOL_PREFERRED_MODE = 1;
+#endif
+
+}
+
+bool ThreadPlacement::configure(ConfigManager* config)
+{
+    const std::string specs[] = {
+        config->getReactorCpus(),
+        config->getMainLoopCpus(),
+        config->getDatabaseCpus(),
+        config->getLoggingCpus(),
+        config->getTransportCpus(),
+    };
+
+#ifdef __linux__
+    long onlineCpus = sysconf(_SC_NPROCESSORS_CONF);
+#else
+    long onlineCpus = 0;
+#endif
+
+    bool valid = true;
+    for (int role = 0; role < static_cast<int>(ThreadRole::COUNT); ++role) {
+        RolePlacement& placement = placements[role];
+        placement = RolePlacement();
+        for (int cpu : parseCpuList(specs[role])) {
+            if (onlineCpus <= 0 || cpu < onlineCpus) {
+                placement.cpus.push_back(cpu);
+            }
+        }
+        if (placement.cpus.empty()) {
+            valid = valid && specs[role].empty();
+            continue;
+        }
+
+        placement.numaNode = numaNodeOf(placement.cpus.front());
+        for (int cpu : placement.cpus) {
+            if (numaNodeOf(cpu) != placement.numaNode) {
+                placement.numaNode = -1;
+                break;
+            }
+        }
+    }
+    placements[static_cast<int>(ThreadRole::REACTOR)].perThread = config->isPinReactorPerCpu();
+    return valid;
+}
+
+bool ThreadPlacement::apply(ThreadRole role, const std::string& name, int index)
+{
+#ifdef __linux__
+    pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+
+    const RolePlacement& placement = placements[static_cast<int>(role)];
+    if (placement.cpus.empty()) {
+        return true;
+    }
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    int numaNode = placement.numaNode;
+    if (placement.perThread && index >= 0) {
+        int cpu = placement.cpus[static_cast<size_t>(index) % placement.cpus.size()];
+        CPU_SET(cpu, &cpuSet);
+        numaNode = numaNodeOf(cpu);
+    } else {
+        for (int cpu : placement.cpus) {
+            CPU_SET(cpu, &cpuSet);
+        }
+    }
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) != 0) {
+        return false;
+    }
+
+    // 只在集合位于单个节点时设置，跨节点的集合保持默认的本地分配
+    if (numaNode >= 0 && numaNode < static_cast<int>(sizeof(unsigned long) * 8)) {
+        unsigned long nodeMask = 1UL << numaNode;
+        syscall(SYS_set_mempolicy, MPOL_PREFERRED_MODE, &nodeMask, sizeof(nodeMask) * 8);
+    }
+    return true;
+#else
+    (void)role;
+    (void)name;
+    (void)index;
+    return true;
+#endif
+}
+
+std::vector<int> ThreadPlacement::parseCpuList(const std::string& spec)
+{
+    std::vector<int> cpus;
+    std::istringstream stream(spec);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        char* end = nullptr;
+        long first = std::strtol(item.c_str(), &end, 10);
+        if (end == item.c_str() || first < 0) {
+            continue;
+        }
+        long last = first;
+        if (*end == '-') {
+            const char* rangeEnd = end + 1;
+            last = std::strtol(rangeEnd, &end, 10);
+            if (end == rangeEnd || last < first) {
+                continue;
+            }
+        }
+        for (long cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+
+int ThreadPlacement::numaNodeOf(int cpu)
+{
+#ifdef __linux__
+    // /sys/devices/system/cpu/cpuN/下有指向所在节点的nodeM链接
+    std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        return -1;
+    }
+    int node = -1;
+    while (struct dirent* entry = readdir(dir)) {
+        if (strncmp(entry->d_name, "node", 4) == 0 && entry->d_name[4] >= '0' && entry->d_name[4] <= '9') {
+            node = std::atoi(entry->d_name + 4);
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+#else
+    (void)cpu;
+    return -1;
+#endif
+}
+
+const std::vector<int>& ThreadPlacement::cpusOf(ThreadRole role)
+{
+    return placements[static_cast<int>(role)].cpus;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+class ConfigManager;
+
+// 线程角色，每个角色在[Threads]中配置各自的CPU集合
+enum class ThreadRole {
+    REACTOR,        // 网络事件循环（每个reactor一个线程）
+    MAIN_LOOP,      // 业务主循环
+    DATABASE,       // 连接池维护线程
+    LOGGING,        // spdlog异步日志线程
+    TRANSPORT,      // 可靠UDP与共享内存传输线程
+    COUNT
+};
+
+// 线程放置 - 按角色把线程绑定到配置的CPU集合，并设置线程名便于profiler区分
+// 绑定后线程首次访问的内存分配在所在NUMA节点上；CPU集合都在同一节点时显式设为优先该节点，
+// 不受启动进程时继承的内存策略（如numactl --interleave）影响，reactor在自己线程中分配的缓冲区因此都在本节点
+// configure须在创建各角色线程之前调用；apply在新线程开头调用，只影响调用线程
+class ThreadPlacement {
+public:
+    // 读取[Threads]配置，有角色的CPU列表无法解析出可用CPU时返回false（该角色不绑定）
+    static bool configure(ConfigManager* config);
+
+    // 设置当前线程名（最长15个字符）并按角色绑定CPU；
+    // index>=0且该角色配置为逐个绑定时只绑定集合中第index个CPU（按集合大小取模），否则绑定到整个集合
+    // 角色未配置CPU时只设置线程名；绑定失败返回false。非Linux平台不做任何事
+    static bool apply(ThreadRole role, const std::string& name, int index = -1);
+
+    // 解析"0-3,8,10-11"格式的CPU列表，忽略无法解析的项
+    static std::vector<int> parseCpuList(const std::string& spec);
+
+    // CPU所在的NUMA节点，无法确定时返回-1
+    static int numaNodeOf(int cpu);
+
+    // 角色配置的CPU集合，用于启动时输出
+    static const std::vector<int>& cpusOf(ThreadRole role);
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 引用计数的只读字节切片 - 多个切片共享同一块不可变的底层存储
+// 拷贝切片或取子切片只增加引用计数，不复制数据；最后一个引用该存储的切片销毁时存储才被释放
+// 生命周期规则：需要跨tick保留数据时保存BufferSlice本身（拷贝即可），不要保存data()返回的裸指针
+class BufferSlice {
+public:
+    BufferSlice() = default;
+
+    // 接管字符串的存储，传入右值时不复制数据
+    BufferSlice(std::string data) {
+        if (!data.empty()) {
+            length_ = data.size();
+            storage_ = std::make_shared<const std::string>(std::move(data));
+        }
+    }
+
+    BufferSlice(const char* str) : BufferSlice(std::string(str ? str : "")) {}
+
+    // 复制一段数据到新的存储中
+    static BufferSlice copyFrom(const void* data, size_t size) {
+        return BufferSlice(std::string(static_cast<const char*>(data), size));
+    }
+
+    const uint8_t* data() const {
+        return storage_ ? reinterpret_cast<const uint8_t*>(storage_->data()) + offset_ : nullptr;
+    }
+    size_t size() const { return length_; }
+    bool empty() const { return length_ == 0; }
+
+    const uint8_t* begin() const { return data(); }
+    const uint8_t* end() const { return data() + length_; }
+
+    // 取子切片，与当前切片共享存储；越界部分被截断
+    BufferSlice slice(size_t offset, size_t length = std::string::npos) const {
+        BufferSlice result;
+        if (offset >= length_) {
+            return result;
+        }
+        result.storage_ = storage_;
+        result.offset_ = offset_ + offset;
+        result.length_ = std::min(length, length_ - offset);
+        return result;
+    }
+
+    // 只读视图，不复制数据，有效期不超过当前切片
+    std::string_view view() const {
+        return std::string_view(reinterpret_cast<const char*>(data()), length_);
+    }
+
+    // 复制为独立的字符串
+    std::string toString() const {
+        return std::string(view());
+    }
+
+    std::vector<uint8_t> toVector() const {
+        return std::vector<uint8_t>(begin(), end());
+    }
+
+private:
+    std::shared_ptr<const std::string> storage_;
+    size_t offset_ = 0;
+    size_t length_ = 0;
+};
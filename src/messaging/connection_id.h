@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+// 连接句柄 - 低32位为连接记录的槽位，高32位为创建连接时分配的代数
+// 槽位在连接关闭后会被复用，但代数不同，旧句柄校验失败，发给已关闭连接的响应不会落到复用同一fd或槽位的新连接上
+// 代数从1开始，值为0的句柄无效；代数的最高两位标记非TCP的传输：
+// 可靠UDP会话以conv为槽位、其余代数位为UdpTransport分配的会话代数，共享内存通道以通道ID为槽位、代数为SHARED_MEMORY_FLAG，
+// 经网关复用链路接入的逻辑会话两位都置位，槽位和其余代数位由GatewayMux分配
+class ConnectionId {
+public:
+    constexpr ConnectionId() = default;
+    constexpr ConnectionId(uint32_t slot, uint32_t generation)
+        : value_((static_cast<uint64_t>(generation) << 32) | slot) {}
+
+    // TCP连接的代数不使用这两位
+    static constexpr uint32_t DATAGRAM_FLAG = 0x80000000u;
+    static constexpr uint32_t SHARED_MEMORY_FLAG = 0x40000000u;
+    static constexpr uint32_t TRANSPORT_MASK = DATAGRAM_FLAG | SHARED_MEMORY_FLAG;
+    static constexpr uint32_t MULTIPLEXED_FLAG = TRANSPORT_MASK;
+
+    static constexpr ConnectionId datagram(uint32_t conv, uint32_t sessionGeneration) {
+        return ConnectionId(conv, DATAGRAM_FLAG | (sessionGeneration & ~TRANSPORT_MASK));
+    }
+
+    static constexpr ConnectionId sharedMemory(uint32_t channelId) {
+        return ConnectionId(channelId, SHARED_MEMORY_FLAG);
+    }
+
+    static constexpr ConnectionId multiplexed(uint32_t slot, uint32_t generation) {
+        return ConnectionId(slot, MULTIPLEXED_FLAG | (generation & ~TRANSPORT_MASK));
+    }
+
+    static constexpr ConnectionId fromValue(uint64_t value) {
+        ConnectionId id;
+        id.value_ = value;
+        return id;
+    }
+
+    constexpr uint32_t slot() const { return static_cast<uint32_t>(value_); }
+    constexpr uint32_t generation() const { return static_cast<uint32_t>(value_ >> 32); }
+    constexpr uint64_t value() const { return value_; }
+    // 去掉传输标记后的代数，即可靠UDP的会话代数或网关会话的代数
+    constexpr uint32_t transportGeneration() const { return generation() & ~TRANSPORT_MASK; }
+    constexpr bool isValid() const { return generation() != 0; }
+    constexpr bool isDatagram() const { return (generation() & TRANSPORT_MASK) == DATAGRAM_FLAG; }
+    constexpr bool isSharedMemory() const { return (generation() & TRANSPORT_MASK) == SHARED_MEMORY_FLAG; }
+    constexpr bool isMultiplexed() const { return (generation() & TRANSPORT_MASK) == MULTIPLEXED_FLAG; }
+
+    constexpr bool operator==(const ConnectionId& other) const { return value_ == other.value_; }
+    constexpr bool operator!=(const ConnectionId& other) const { return value_ != other.value_; }
+
+private:
+    uint64_t value_ = 0;
+};
+
+namespace std {
+template <>
+struct hash<ConnectionId> {
+    size_t operator()(const ConnectionId& id) const noexcept {
+        return std::hash<uint64_t>()(id.value());
+    }
+};
+}
@@ -0,0 +1,349 @@
+#include "frame_compressor.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// LZ4块格式的常量
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t LAST_LITERALS = 5;     // 块的最后5个字节必须是字面量
+constexpr size_t MF_LIMIT = 12;         // 最后一个匹配必须在块结束前12字节之前开始
+constexpr size_t MAX_OFFSET = 65535;
+constexpr unsigned SKIP_TRIGGER = 6;    // 连续找不到匹配时逐渐加大步长，不可压缩的数据很快扫过
+
+inline uint32_t read32(const uint8_t* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint32_t hashOf(uint32_t sequence, int hashLog) {
+    return (sequence * 2654435761u) >> (32 - hashLog);
+}
+
+inline void writeBigEndian32(uint8_t* p, uint32_t value) {
+    p[0] = static_cast<uint8_t>(value >> 24);
+    p[1] = static_cast<uint8_t>(value >> 16);
+    p[2] = static_cast<uint8_t>(value >> 8);
+    p[3] = static_cast<uint8_t>(value);
+}
+
+inline uint32_t readBigEndian32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+// 长度超过15时的扩展字节：若干个255，最后一个小于255
+inline uint8_t* writeLength(uint8_t* op, size_t length) {
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = static_cast<uint8_t>(length);
+    return op;
+}
+
+inline bool readLength(const uint8_t*& ip, const uint8_t* iend, size_t& length) {
+    uint8_t value;
+    do {
+        if (ip >= iend) {
+            return false;
+        }
+        value = *ip++;
+        length += value;
+    } while (value == 255);
+    return true;
+}
+
+// 连续区域内的匹配长度，按8字节比较
+inline size_t countMatch(const uint8_t* ip, const uint8_t* ref, const uint8_t* limit) {
+    const uint8_t* start = ip;
+    while (ip + sizeof(uint64_t) <= limit) {
+        uint64_t a, b;
+        memcpy(&a, ip, sizeof(a));
+        memcpy(&b, ref, sizeof(b));
+        if (a != b) {
+            break;
+        }
+        ip += sizeof(uint64_t);
+        ref += sizeof(uint64_t);
+    }
+    while (ip < limit && *ip == *ref) {
+        ++ip;
+        ++ref;
+    }
+    return static_cast<size_t>(ip - start);
+}
+
+} // namespace
+
+size_t FrameCompressor::thresholdFor(uint32_t messageId) const {
+    auto it = thresholds_.find(messageId);
+    return it != thresholds_.end() ? it->second : defaultThreshold_;
+}
+
+bool FrameCompressor::enabled() const {
+    if (defaultThreshold_ > 0) {
+        return true;
+    }
+    return std::any_of(thresholds_.begin(), thresholds_.end(),
+                       [](const std::pair<const uint32_t, size_t>& entry) { return entry.second > 0; });
+}
+
+void FrameCompressor::setDictionary(std::string dictionary) {
+    if (dictionary.size() > MAX_DICTIONARY_SIZE) {
+        dictionary.erase(0, dictionary.size() - MAX_DICTIONARY_SIZE);
+    }
+    dictionary_ = std::move(dictionary);
+    dictionaryTable_.clear();
+    dictionaryId_ = 0;
+    if (dictionary_.empty()) {
+        return;
+    }
+
+    // 字典ID取内容的FNV-1a散列，0保留给不使用字典的帧
+    uint32_t id = 2166136261u;
+    for (unsigned char c : dictionary_) {
+        id = (id ^ c) * 16777619u;
+    }
+    dictionaryId_ = id != 0 ? id : 1;
+
+    dictionaryTable_.assign(size_t(1) << HASH_LOG, EMPTY_SLOT);
+    const uint8_t* dict = reinterpret_cast<const uint8_t*>(dictionary_.data());
+    for (size_t pos = 0; pos + MIN_MATCH <= dictionary_.size(); ++pos) {
+        dictionaryTable_[hashOf(read32(dict + pos), HASH_LOG)] = static_cast<uint32_t>(pos);
+    }
+}
+
+size_t FrameCompressor::compressBlock(const uint8_t* src, size_t size, uint8_t* dst) const {
+    // 位置按字典在前、输入在后的连续地址记录，匹配可以引用字典中的数据
+    const uint8_t* dict = reinterpret_cast<const uint8_t*>(dictionary_.data());
+    const size_t dictSize = dictionary_.size();
+    const uint8_t* iend = src + size;
+    const uint8_t* anchor = src;
+    uint8_t* op = dst;
+
+    if (size >= MF_LIMIT + 1) {
+        // 每个线程一张哈希表，编码线程之间不共享状态
+        thread_local std::vector<uint32_t> table;
+        if (dictionaryTable_.empty()) {
+            table.assign(size_t(1) << HASH_LOG, EMPTY_SLOT);
+        } else {
+            table = dictionaryTable_;
+        }
+
+        const uint8_t* mflimit = iend - MF_LIMIT;
+        const uint8_t* matchLimit = iend - LAST_LITERALS;
+        const uint8_t* ip = src;
+        while (ip < mflimit) {
+            uint32_t& slot = table[hashOf(read32(ip), HASH_LOG)];
+            uint32_t candidate = slot;
+            uint32_t pos = static_cast<uint32_t>(dictSize + (ip - src));
+            slot = pos;
+
+            bool inDictionary = candidate < dictSize;
+            const uint8_t* ref = nullptr;
+            if (candidate != EMPTY_SLOT && pos - candidate <= MAX_OFFSET) {
+                ref = inDictionary ? dict + candidate : src + (candidate - dictSize);
+            }
+            if (!ref || read32(ref) != read32(ip)) {
+                ip += 1 + (static_cast<size_t>(ip - anchor) >> SKIP_TRIGGER);
+                continue;
+            }
+            size_t offset = pos - candidate;
+
+            // 向前扩展匹配，把前面的字面量并入匹配
+            const uint8_t* lowLimit = inDictionary ? dict : src;
+            while (ip > anchor && ref > lowLimit && ip[-1] == ref[-1]) {
+                --ip;
+                --ref;
+            }
+
+            // 从字典开始的匹配可以一直延续到输入的开头
+            size_t matchLength = MIN_MATCH;
+            if (inDictionary) {
+                const uint8_t* dictEnd = dict + dictSize;
+                size_t limit = std::min(static_cast<size_t>(matchLimit - (ip + MIN_MATCH)),
+                                        static_cast<size_t>(dictEnd - (ref + MIN_MATCH)));
+                matchLength += countMatch(ip + MIN_MATCH, ref + MIN_MATCH, ip + MIN_MATCH + limit);
+                if (ref + matchLength == dictEnd) {
+                    matchLength += countMatch(ip + matchLength, src, matchLimit);
+                }
+            } else {
+                matchLength += countMatch(ip + MIN_MATCH, ref + MIN_MATCH, matchLimit);
+            }
+
+            // 序列：标记字节（高4位字面量长度，低4位匹配长度-4）、字面量、2字节小端偏移、扩展长度
+            size_t literals = static_cast<size_t>(ip - anchor);
+            uint8_t* token = op++;
+            *token = static_cast<uint8_t>(std::min<size_t>(literals, 15) << 4);
+            if (literals >= 15) {
+                op = writeLength(op, literals - 15);
+            }
+            memcpy(op, anchor, literals);
+            op += literals;
+            *op++ = static_cast<uint8_t>(offset);
+            *op++ = static_cast<uint8_t>(offset >> 8);
+            size_t extra = matchLength - MIN_MATCH;
+            *token |= static_cast<uint8_t>(std::min<size_t>(extra, 15));
+            if (extra >= 15) {
+                op = writeLength(op, extra - 15);
+            }
+
+            ip += matchLength;
+            anchor = ip;
+            if (ip < mflimit) {
+                // 匹配内部的位置没有加入哈希表，补上紧邻末尾的一个
+                const uint8_t* p = ip - 2;
+                table[hashOf(read32(p), HASH_LOG)] = static_cast<uint32_t>(dictSize + (p - src));
+            }
+        }
+    }
+
+    // 最后一个序列只有字面量
+    size_t literals = static_cast<size_t>(iend - anchor);
+    *op++ = static_cast<uint8_t>(std::min<size_t>(literals, 15) << 4);
+    if (literals >= 15) {
+        op = writeLength(op, literals - 15);
+    }
+    if (literals > 0) {
+        memcpy(op, anchor, literals);
+        op += literals;
+    }
+    return static_cast<size_t>(op - dst);
+}
+
+bool FrameCompressor::decompressBlock(const uint8_t* src, size_t size, uint8_t* dst, size_t rawSize) const {
+    const uint8_t* dict = reinterpret_cast<const uint8_t*>(dictionary_.data());
+    const size_t dictSize = dictionary_.size();
+    const uint8_t* ip = src;
+    const uint8_t* iend = src + size;
+    uint8_t* op = dst;
+    uint8_t* oend = dst + rawSize;
+
+    for (;;) {
+        if (ip >= iend) {
+            return false;
+        }
+        uint8_t token = *ip++;
+
+        size_t literals = token >> 4;
+        if (literals == 15 && !readLength(ip, iend, literals)) {
+            return false;
+        }
+        if (literals > static_cast<size_t>(iend - ip) || literals > static_cast<size_t>(oend - op)) {
+            return false;
+        }
+        if (literals > 0) {
+            memcpy(op, ip, literals);
+            ip += literals;
+            op += literals;
+        }
+        if (ip == iend) {
+            return op == oend;
+        }
+
+        if (iend - ip < 2) {
+            return false;
+        }
+        size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !readLength(ip, iend, matchLength)) {
+            return false;
+        }
+        matchLength += MIN_MATCH;
+
+        size_t produced = static_cast<size_t>(op - dst);
+        if (offset == 0 || offset > produced + dictSize || matchLength > static_cast<size_t>(oend - op)) {
+            return false;
+        }
+        if (offset > produced) {
+            // 匹配从字典末尾开始，剩余部分接着从输出的开头复制
+            size_t fromDictionary = std::min(matchLength, offset - produced);
+            memcpy(op, dict + dictSize - (offset - produced), fromDictionary);
+            op += fromDictionary;
+            matchLength -= fromDictionary;
+            if (matchLength == 0) {
+                continue;
+            }
+        }
+
+        const uint8_t* match = op - offset;
+        if (offset >= matchLength) {
+            memcpy(op, match, matchLength);
+            op += matchLength;
+        } else {
+            // 源与目标重叠，逐字节复制以重复最近的数据
+            for (size_t i = 0; i < matchLength; ++i) {
+                *op++ = *match++;
+            }
+        }
+    }
+}
+
+BufferSlice FrameCompressor::encode(const NetworkMessage& message) const {
+    const MessageHeader& header = message.getHeader();
+    const MessageBody& body = message.getBody();
+    size_t bodySize = body.getSize();
+
+    size_t threshold = thresholdFor(header.baseId());
+    if (threshold > 0 && bodySize >= threshold && bodySize <= MAX_DECOMPRESSED_SIZE) {
+        std::string frame(sizeof(MessageHeader) + COMPRESSED_HEADER_SIZE + compressBound(bodySize), '\0');
+        uint8_t* out = reinterpret_cast<uint8_t*>(&frame[0]);
+        size_t compressed = compressBlock(body.getData(), bodySize,
+                                          out + sizeof(MessageHeader) + COMPRESSED_HEADER_SIZE);
+        size_t dataLength = COMPRESSED_HEADER_SIZE + compressed;
+        // 压缩后没有变小的消息体原样发送
+        if (dataLength < bodySize) {
+            writeBigEndian32(out, header.baseId() | MessageHeader::COMPRESSED_FLAG);
+            writeBigEndian32(out + 4, static_cast<uint32_t>(dataLength));
+            writeBigEndian32(out + sizeof(MessageHeader), static_cast<uint32_t>(bodySize));
+            writeBigEndian32(out + sizeof(MessageHeader) + 4, dictionaryId_);
+            frame.resize(sizeof(MessageHeader) + dataLength);
+            return BufferSlice(std::move(frame));
+        }
+    }
+
+    // 直接写入一块存储，不经过serialize的中间vector
+    std::string frame(sizeof(MessageHeader) + bodySize, '\0');
+    uint8_t* out = reinterpret_cast<uint8_t*>(&frame[0]);
+    writeBigEndian32(out, header.messageId);
+    writeBigEndian32(out + 4, header.dataLength);
+    if (bodySize > 0) {
+        memcpy(out + sizeof(MessageHeader), body.getData(), bodySize);
+    }
+    return BufferSlice(std::move(frame));
+}
+
+BufferSlice FrameCompressor::decode(const BufferSlice& frame) const {
+    MessageHeader header;
+    if (!header.deserialize(frame.data(), frame.size()) ||
+        frame.size() < sizeof(MessageHeader) + header.dataLength) {
+        return BufferSlice();
+    }
+    if (!header.isCompressed()) {
+        return frame;
+    }
+    if (header.dataLength < COMPRESSED_HEADER_SIZE) {
+        return BufferSlice();
+    }
+
+    const uint8_t* body = frame.data() + sizeof(MessageHeader);
+    uint32_t rawSize = readBigEndian32(body);
+    uint32_t dictionaryId = readBigEndian32(body + 4);
+    size_t blockSize = header.dataLength - COMPRESSED_HEADER_SIZE;
+    // LZ4的压缩比不超过255，超出的原始长度必然是伪造的
+    if (dictionaryId != dictionaryId_ || rawSize > MAX_DECOMPRESSED_SIZE || rawSize > blockSize * 255) {
+        return BufferSlice();
+    }
+
+    std::string expanded(sizeof(MessageHeader) + rawSize, '\0');
+    uint8_t* out = reinterpret_cast<uint8_t*>(&expanded[0]);
+    writeBigEndian32(out, header.baseId());
+    writeBigEndian32(out + 4, rawSize);
+    if (!decompressBlock(body + COMPRESSED_HEADER_SIZE, blockSize, out + sizeof(MessageHeader), rawSize)) {
+        return BufferSlice();
+    }
+    return BufferSlice(std::move(expanded));
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "buffer_slice.h"
+#include "message_header.h"
+
+// 帧压缩器 - 内置的LZ4块格式压缩，按消息ID的阈值决定是否压缩消息体
+// 压缩帧的消息ID带MessageHeader::COMPRESSED_FLAG，消息体为：
+//   原始长度(4字节) + 字典ID(4字节) + LZ4块，两个整数均为大端序
+// 字典ID为0表示未使用字典；使用共享字典时双方须加载同一份字典，ID不符的帧无法解压
+// 启动时配置，之后只读，可由多个线程同时编码和解码
+class FrameCompressor {
+public:
+    static constexpr size_t COMPRESSED_HEADER_SIZE = 8;
+    static constexpr size_t MAX_DICTIONARY_SIZE = 64 * 1024;            // LZ4的偏移量为16位，更早的数据无法引用
+    static constexpr size_t MAX_DECOMPRESSED_SIZE = 16 * 1024 * 1024;   // 防止伪造的原始长度耗尽内存
+
+    // 未单独设置阈值的消息ID使用默认阈值；阈值为0表示不压缩
+    void setDefaultThreshold(size_t threshold) { defaultThreshold_ = threshold; }
+    void setThreshold(uint32_t messageId, size_t threshold) { thresholds_[messageId] = threshold; }
+    size_t thresholdFor(uint32_t messageId) const;
+    // 是否有任何消息会被压缩
+    bool enabled() const;
+
+    // 字典超过MAX_DICTIONARY_SIZE时只保留末尾部分（重复率最高的内容应放在字典末尾）
+    void setDictionary(std::string dictionary);
+    uint32_t dictionaryId() const { return dictionaryId_; }
+
+    // 编码为完整的帧：消息体达到阈值且压缩后更小时压缩，否则原样序列化
+    BufferSlice encode(const NetworkMessage& message) const;
+    // 把压缩帧展开为未压缩的帧，未压缩的帧原样返回；数据损坏或字典不符时返回空切片
+    BufferSlice decode(const BufferSlice& frame) const;
+
+    // LZ4块接口：dst至少要有compressBound(size)字节，返回压缩后的长度
+    static size_t compressBound(size_t size) { return size + size / 255 + 16; }
+    size_t compressBlock(const uint8_t* src, size_t size, uint8_t* dst) const;
+    // 块必须恰好解出rawSize字节，越界或长度不符时返回false
+    bool decompressBlock(const uint8_t* src, size_t size, uint8_t* dst, size_t rawSize) const;
+
+private:
+    static constexpr int HASH_LOG = 12;
+    static constexpr uint32_t EMPTY_SLOT = 0xFFFFFFFFu;
+
+    size_t defaultThreshold_ = 0;
+    std::unordered_map<uint32_t, size_t> thresholds_;
+
+    std::string dictionary_;
+    uint32_t dictionaryId_ = 0;
+    // 字典各位置的哈希表，每次压缩以它的副本作为初始状态，不必重新扫描字典
+    std::vector<uint32_t> dictionaryTable_;
+};
@@ -1,65 +1,202 @@
 #include "message.h"
 #include <stdexcept>
+#include <cstdint>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <ctime>
+#endif
+
+#ifdef __linux__
+namespace {
+
+// futex直接作用在原子变量的存储上
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be 32 bits");
+
+void futexWait(std::atomic<uint32_t>& word, uint32_t expected, int timeoutMs) {
+    struct timespec timeout;
+    struct timespec* timeoutPtr = nullptr;
+    if (timeoutMs >= 0) {
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_nsec = static_cast<long>(timeoutMs % 1000) * 1000000;
+        timeoutPtr = &timeout;
+    }
+    // 值已不等于expected（唤醒发生在休眠之前）时立即返回
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, timeoutPtr, nullptr, 0);
+}
+
+void futexWake(std::atomic<uint32_t>& word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+
+} // namespace
+#endif
 
 // MessageQueue implementation
-void MessageQueue::push(MessagePtr message) {
+MessageQueue::MessageQueue(size_t capacity) {
+    size_t rounded = 2;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    mask_ = rounded - 1;
+    cells_.reset(new Cell[rounded]);
+    for (size_t i = 0; i < rounded; ++i) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool MessageQueue::push(MessagePtr message) {
     if (!message) {
         throw std::invalid_argument("Cannot push null message to queue");
     }
-    
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (shutdown_) {
-        throw std::runtime_error("Cannot push message to shutdown queue");
+
+    if (shutdown_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    // 占用写位置：槽位序号等于位置时可写，小于位置说明消费者还没取走上一轮的消息，队列已满
+    Cell* cell;
+    size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    for (;;) {
+        cell = &cells_[pos & mask_];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
     }
-    
-    queue_.push(std::move(message));
-    condition_.notify_one();
+
+    cell->message = std::move(message);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    wake();
+    return true;
+}
+
+MessagePtr MessageQueue::tryPop() {
+    size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+    Cell& cell = cells_[pos & mask_];
+    if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+        // 为空，或占用该位置的生产者还未写完
+        return nullptr;
+    }
+
+    MessagePtr message = std::move(cell.message);
+    // 槽位留给下一轮的同一位置
+    cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+    dequeuePos_.store(pos + 1, std::memory_order_release);
+    return message;
 }
 
 MessagePtr MessageQueue::pop(bool wait) {
-    std::unique_lock<std::mutex> lock(mutex_);
-    
-    if (wait) {
-        // 等待条件变量，直到队列非空或关闭
-        condition_.wait(lock, [this] {
-            return shutdown_ || !queue_.empty();
-        });
-        
-        // 如果队列已关闭且为空，返回nullptr
-        if (shutdown_ && queue_.empty()) {
-            return nullptr;
+    for (;;) {
+        MessagePtr message = tryPop();
+        // 如果队列已关闭且为空，或不等待，返回nullptr
+        if (message || !wait || shutdown_.load(std::memory_order_acquire)) {
+            return message;
         }
-    } else {
-        // 如果队列为空且不等待，立即返回
-        if (queue_.empty()) {
-            return nullptr;
+        waitForMessage(-1);
+    }
+}
+
+size_t MessageQueue::popBatch(std::vector<MessagePtr>& out, size_t maxCount, int timeoutMs) {
+    size_t count = 0;
+    for (;;) {
+        while (count < maxCount) {
+            MessagePtr message = tryPop();
+            if (!message) {
+                break;
+            }
+            out.push_back(std::move(message));
+            ++count;
+        }
+        if (count > 0 || timeoutMs == 0 || shutdown_.load(std::memory_order_acquire)) {
+            return count;
+        }
+        waitForMessage(timeoutMs);
+        // 有限的超时只等一次，醒来后再取一遍即返回
+        if (timeoutMs > 0) {
+            timeoutMs = 0;
         }
     }
-    
-    // 获取并移动消息
-    MessagePtr message = std::move(const_cast<MessagePtr&>(queue_.front()));
-    queue_.pop();
-    
-    return message;
+}
+
+void MessageQueue::waitForMessage(int timeoutMs) {
+    // 先登记再检查队列：生产者发布消息后检查登记，两边各有一道全序屏障，
+    // 要么消费者看到新消息不休眠，要么生产者看到登记并唤醒
+    uint32_t sequence = wakeSequence_.load(std::memory_order_acquire);
+    sleeping_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!empty() || shutdown_.load(std::memory_order_acquire)) {
+        sleeping_.store(false, std::memory_order_relaxed);
+        return;
+    }
+
+#ifdef __linux__
+    futexWait(wakeSequence_, sequence, timeoutMs);
+#else
+    std::unique_lock<std::mutex> lock(waitMutex_);
+    auto woken = [this, sequence] { return wakeSequence_.load(std::memory_order_acquire) != sequence; };
+    if (timeoutMs < 0) {
+        waitCondition_.wait(lock, woken);
+    } else {
+        waitCondition_.wait_for(lock, std::chrono::milliseconds(timeoutMs), woken);
+    }
+#endif
+    sleeping_.store(false, std::memory_order_relaxed);
+}
+
+void MessageQueue::wake() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    // 消费者在忙时不做任何系统调用；多个生产者同时看到登记时只有一个负责唤醒
+    if (!sleeping_.load(std::memory_order_relaxed) || !sleeping_.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+
+#ifdef __linux__
+    wakeSequence_.fetch_add(1, std::memory_order_release);
+    futexWake(wakeSequence_);
+#else
+    {
+        std::lock_guard<std::mutex> lock(waitMutex_);
+        wakeSequence_.fetch_add(1, std::memory_order_release);
+    }
+    waitCondition_.notify_one();
+#endif
 }
 
 bool MessageQueue::empty() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return queue_.empty();
+    return enqueuePos_.load(std::memory_order_acquire) == dequeuePos_.load(std::memory_order_acquire);
 }
 
 size_t MessageQueue::size() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return queue_.size();
+    size_t dequeued = dequeuePos_.load(std::memory_order_acquire);
+    size_t enqueued = enqueuePos_.load(std::memory_order_acquire);
+    return enqueued > dequeued ? enqueued - dequeued : 0;
 }
 
 void MessageQueue::shutdown() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    shutdown_.store(true);
-    condition_.notify_all();
+    shutdown_.store(true, std::memory_order_release);
+    // 无论消费者是否登记等待都唤醒一次
+#ifdef __linux__
+    wakeSequence_.fetch_add(1, std::memory_order_release);
+    futexWake(wakeSequence_);
+#else
+    {
+        std::lock_guard<std::mutex> lock(waitMutex_);
+        wakeSequence_.fetch_add(1, std::memory_order_release);
+    }
+    waitCondition_.notify_all();
+#endif
 }
 
 bool MessageQueue::is_shutdown() const {
     return shutdown_.load();
-}
\ No newline at end of file
+}
@@ -10,6 +10,8 @@
 #include <vector>
 #include <functional>
 #include <unordered_map>
+#include "buffer_slice.h"
+#include "connection_id.h"
 
 // 消息类型
 enum class MessageType {
@@ -18,27 +20,31 @@ enum class MessageType {
     LOGOUT = 3,
     QUERY_DATA = 4,
     UPDATE_DATA = 5,
+    COMPRESSED_FRAME = 6,   // 未解压的压缩帧，payload为整帧，由主循环展开后按原消息类型分发
     CUSTOM = 100
 };
 
 // 消息基类
+// payload与网络层接收缓冲区共享存储；处理器需要跨tick保留payload时拷贝BufferSlice（只增加引用计数），
+// 不要保存getPayload().data()等裸指针
 class Message {
 public:
-    Message(MessageType type, const std::string& payload, const std::string& clientId = "")
+    Message(MessageType type, const BufferSlice& payload, ConnectionId clientId = ConnectionId())
         : type_(type), payload_(payload), clientId_(clientId), id_(generateId()), timestamp_(std::chrono::system_clock::now()) {}
 
     virtual ~Message() = default;
 
     MessageType getType() const { return type_; }
-    const std::string& getPayload() const { return payload_; }
-    const std::string& getClientId() const { return clientId_; }
+    const BufferSlice& getPayload() const { return payload_; }
+    // 发送方连接的句柄，响应时原样传给NetworkServer的发送接口
+    ConnectionId getClientId() const { return clientId_; }
     size_t getId() const { return id_; }
     std::chrono::system_clock::time_point getTimestamp() const { return timestamp_; }
 
 private:
     MessageType type_;
-    std::string payload_;
-    std::string clientId_;
+    BufferSlice payload_;
+    ConnectionId clientId_;
     size_t id_;
     std::chrono::system_clock::time_point timestamp_;
 
@@ -51,7 +57,7 @@ private:
 // 具体消息类型
 class LoginMessage : public Message {
 public:
-    LoginMessage(const std::string& username, const std::string& password, const std::string& clientId = "")
+    LoginMessage(const std::string& username, const std::string& password, ConnectionId clientId = ConnectionId())
         : Message(MessageType::LOGIN, "{}", clientId), username_(username), password_(password) {
         // 构造实际的消息体
     }
@@ -66,7 +72,7 @@ private:
 
 class RegisterMessage : public Message {
 public:
-    RegisterMessage(const std::string& username, const std::string& password, const std::string& email, const std::string& clientId = "")
+    RegisterMessage(const std::string& username, const std::string& password, const std::string& email, ConnectionId clientId = ConnectionId())
         : Message(MessageType::REGISTER, "{}", clientId), username_(username), password_(password), email_(email) {}
 
     const std::string& getUsername() const { return username_; }
@@ -95,15 +101,22 @@ inline const char* getMessageTypeName(MessageType type) {
         case MessageType::LOGOUT: return "LOGOUT";
         case MessageType::QUERY_DATA: return "QUERY_DATA";
         case MessageType::UPDATE_DATA: return "UPDATE_DATA";
+        case MessageType::COMPRESSED_FRAME: return "COMPRESSED_FRAME";
         case MessageType::CUSTOM: return "CUSTOM";
         default: return "UNKNOWN";
     }
 }
 
-// 线程安全的消息队列
+// 有界无锁多生产者单消费者消息队列
+// 环形数组的每个槽位带序号：生产者以CAS占用写位置后填入消息再发布序号，唯一的消费者按顺序取出，全程不加锁
+// 消费者只在队列为空并决定休眠时才登记等待，生产者只在看到登记后才发出唤醒（Linux上为futex），
+// 队列繁忙时入队和出队都不进入内核
 class MessageQueue {
 public:
-    MessageQueue() = default;
+    static constexpr size_t DEFAULT_CAPACITY = 65536;
+
+    // 容量向上取整为2的幂
+    explicit MessageQueue(size_t capacity = DEFAULT_CAPACITY);
     ~MessageQueue() = default;
 
     // 禁止拷贝和移动
@@ -112,29 +125,55 @@ public:
     MessageQueue(MessageQueue&&) = delete;
     MessageQueue& operator=(MessageQueue&&) = delete;
 
-    // 添加消息到队列（生产者调用）
-    void push(MessagePtr message);
+    // 添加消息到队列（生产者调用，可多线程）
+    // 队列已满或已关闭时返回false，消息被丢弃
+    bool push(MessagePtr message);
 
-    // 从队列中获取消息（消费者调用）
+    // 从队列中获取消息（仅消费者线程调用）
     // 如果队列为空且wait为true，则阻塞等待
-    // 如果wait为false且队列为空，则返回nullptr
+    // 如果wait为false且队列为空，或队列已关闭且为空，则返回nullptr
     MessagePtr pop(bool wait = true);
 
-    // 检查队列是否为空
+    // 批量取出最多maxCount条追加到out，返回取出的条数（仅消费者线程调用）
+    // 队列为空时最多等待timeoutMs毫秒，-1为一直等到有消息或队列关闭，0为不等待
+    size_t popBatch(std::vector<MessagePtr>& out, size_t maxCount, int timeoutMs = -1);
+
+    // 队列为空时休眠，直到有消息入队、队列关闭或超过timeoutMs毫秒（-1为不超时），不取出消息（仅消费者线程调用）
+    void waitForMessage(int timeoutMs);
+
+    // 检查队列是否为空（任意线程可调用，结果为瞬时值）
     bool empty() const;
 
-    // 获取队列大小
+    // 获取队列大小（近似值）
     size_t size() const;
+    size_t capacity() const { return mask_ + 1; }
 
-    // 关闭队列，不再接受新消息，并通知等待线程
+    // 关闭队列，不再接受新消息，并唤醒等待的消费者；已入队的消息仍可取出
     void shutdown();
 
     // 检查队列是否已关闭
     bool is_shutdown() const;
 
 private:
-    mutable std::mutex mutex_;
-    std::condition_variable condition_;
-    std::queue<MessagePtr> queue_;
+    struct Cell {
+        std::atomic<size_t> sequence{0};    // 等于位置时可写，等于位置+1时可读
+        MessagePtr message;
+    };
+
+    // 取出下一条已发布的消息，没有时返回nullptr
+    MessagePtr tryPop();
+    // 生产者：消费者已登记等待时唤醒它
+    void wake();
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> enqueuePos_{0};
+    alignas(64) std::atomic<size_t> dequeuePos_{0};     // 只由消费者写入
+    alignas(64) std::atomic<bool> sleeping_{false};     // 消费者已登记等待
+    std::atomic<uint32_t> wakeSequence_{0};             // futex字，每次唤醒加一
     std::atomic<bool> shutdown_{false};
-};
\ No newline at end of file
+#ifndef __linux__
+    std::mutex waitMutex_;
+    std::condition_variable waitCondition_;
+#endif
+};
@@ -3,12 +3,19 @@
 #include <cstdint>
 #include <string>
 #include <vector>
+#include "buffer_slice.h"
 
 // 消息头结构体 - 固定长度，包含消息ID和数据长度
 struct MessageHeader {
     uint32_t messageId;     // 消息ID (4字节)
     uint32_t dataLength;    // 消息体数据长度 (4字节)
-    
+
+    // 消息ID的最高位标记消息体已压缩（格式见FrameCompressor），其余位为实际的消息ID
+    static constexpr uint32_t COMPRESSED_FLAG = 0x80000000u;
+
+    uint32_t baseId() const { return messageId & ~COMPRESSED_FLAG; }
+    bool isCompressed() const { return (messageId & COMPRESSED_FLAG) != 0; }
+
     MessageHeader() : messageId(0), dataLength(0) {}
     
     MessageHeader(uint32_t id, uint32_t length) 
@@ -47,44 +54,52 @@ struct MessageHeader {
 };
 
 // 消息体类 - 存储二进制数据
+// 数据以BufferSlice保存，从接收缓冲区解析出的消息体直接引用该缓冲区，不复制
 class MessageBody {
 private:
-    std::vector<uint8_t> data_;
+    BufferSlice data_;
     
 public:
     MessageBody() = default;
     
-    explicit MessageBody(const std::vector<uint8_t>& data) : data_(data) {}
+    explicit MessageBody(const std::vector<uint8_t>& data) : data_(BufferSlice::copyFrom(data.data(), data.size())) {}
     
-    explicit MessageBody(const std::string& str) {
-        data_.assign(str.begin(), str.end());
-    }
+    explicit MessageBody(const std::string& str) : data_(str) {}
+    
+    explicit MessageBody(const BufferSlice& slice) : data_(slice) {}
     
     // 获取二进制数据
     const uint8_t* getData() const { return data_.data(); }
     size_t getSize() const { return data_.size(); }
     
+    // 获取共享的数据切片，跨tick保留消息体时持有该切片即可
+    const BufferSlice& getSlice() const { return data_; }
+    
     // 设置二进制数据
     void setData(const uint8_t* data, size_t size) {
-        data_.assign(data, data + size);
+        data_ = BufferSlice::copyFrom(data, size);
     }
     
     void setData(const std::vector<uint8_t>& data) {
-        data_ = data;
+        data_ = BufferSlice::copyFrom(data.data(), data.size());
+    }
+    
+    void setData(const BufferSlice& slice) {
+        data_ = slice;
     }
     
     // 字符串转换
     std::string toString() const {
-        return std::string(data_.begin(), data_.end());
+        return data_.toString();
     }
     
     void fromString(const std::string& str) {
-        data_.assign(str.begin(), str.end());
+        data_ = BufferSlice(str);
     }
     
     // 清空数据
     void clear() {
-        data_.clear();
+        data_ = BufferSlice();
     }
     
     // 检查是否为空
@@ -159,6 +174,21 @@ public:
         
         return true;
     }
+    
+    // 从切片反序列化，消息体引用切片的存储而不复制
+    bool deserialize(const BufferSlice& data) {
+        if (!header_.deserialize(data.data(), data.size())) {
+            return false;
+        }
+        
+        size_t expectedSize = sizeof(MessageHeader) + header_.dataLength;
+        if (data.size() < expectedSize) {
+            return false;
+        }
+        
+        body_.setData(data.slice(sizeof(MessageHeader), header_.dataLength));
+        return true;
+    }
 };
 
 // 预定义的消息ID常量
@@ -169,6 +199,10 @@ namespace MessageIds {
     constexpr uint32_t QUERY_DATA = 2001;
     constexpr uint32_t UPDATE_DATA = 2002;
     constexpr uint32_t HEARTBEAT = 3001;
+    // 网关复用链路，见GatewayMux
+    constexpr uint32_t GATEWAY_HELLO = 4001;
+    constexpr uint32_t GATEWAY_FORWARD = 4002;
+    constexpr uint32_t GATEWAY_CLOSE = 4003;
     constexpr uint32_t ERROR_RESPONSE = 9001;
     constexpr uint32_t SUCCESS_RESPONSE = 9002;
 }
\ No newline at end of file
@@ -41,13 +41,17 @@
 #include <condition_variable>
 #include <string>
 #include "Log.h"
+#include "../messaging/buffer_slice.h"
 
 // Async I/O event types
 enum class IOEventType : uint32_t {
     ACCEPT = 0x01,
     READ = 0x02,
     WRITE = 0x04,
-    IOERROR = 0x08
+    IOERROR = 0x08,
+    // 发送队列水位变化（只作为事件类型投递，不用于注册）
+    HIGH_WATERMARK = 0x10,      // 待发送数据超过高水位，已暂停读取该socket
+    LOW_WATERMARK = 0x20        // 待发送数据回落到低水位，已恢复读取
 };
 
 // Overload bitwise OR operator for IOEventType
@@ -57,18 +61,52 @@ inline IOEventType operator|(IOEventType lhs, IOEventType rhs) {
     );
 }
 
+// 按位与：用于判断事件集合中是否包含某个事件
+inline bool operator&(IOEventType lhs, IOEventType rhs) {
+    return (static_cast<uint32_t>(lhs) & static_cast<uint32_t>(rhs)) != 0;
+}
+
 // I/O event structure
 struct IOEvent {
     socket_t socket;
     IOEventType eventType;
-    std::string data;
+    BufferSlice data;           // 引用计数的数据切片，回调需要保留数据时拷贝切片而不是复制内容
     std::function<void(const IOEvent&)> callback;
+    // ACCEPT事件：后端已完成accept时为新连接的socket（如io_uring多发accept），否则由上层自行accept
+    socket_t acceptedSocket = INVALID_SOCKET_VALUE;
+};
+
+// Async I/O backend types
+enum class AsyncIOBackend {
+    EPOLL,
+    IO_URING
+};
+
+// Async I/O backend options
+struct AsyncIOOptions {
+    AsyncIOBackend backend = AsyncIOBackend::EPOLL;  // Linux后端，io_uring不可用时回退到epoll
+    bool edgeTriggered = false;         // epoll边缘触发：每次唤醒读写直到EAGAIN
+    size_t ioBudget = 64 * 1024;        // 单个socket每次唤醒最多读写的字节数，保证连接间公平
+    size_t writeHighWatermark = 0;      // 单个socket待发送字节数达到此值时暂停读取，0为不限制
+    size_t writeLowWatermark = 0;       // 暂停后待发送字节数回落到此值时恢复读取
+    uint32_t busyPollUs = 0;            // 阻塞等待前以零超时轮询自旋的最长微秒数，按空闲时长自适应缩减，0为不自旋
+    int socketBusyPollUs = 0;           // 连接的SO_BUSY_POLL（微秒），0为不设置
+    std::function<void()> onThreadStart;    // 事件循环线程开始时调用，用于设置线程名和CPU绑定
+};
+
+// 事件循环等待统计，用于按部署权衡自旋占用的CPU和唤醒延迟
+struct PollStats {
+    uint64_t spinWakeups = 0;   // 自旋期间等到事件的次数
+    uint64_t blockWakeups = 0;  // 自旋未等到事件、进入阻塞等待的次数
+    uint64_t spinMicros = 0;    // 累计自旋时间
+    uint32_t spinBudgetUs = 0;  // 当前的自旋时长上限
 };
 
 // Async I/O manager interface
 class AsyncIO {
 public:
     using EventCallback = std::function<void(const IOEvent&)>;
+    using TickCallback = std::function<void()>;
     
     AsyncIO() = default;
     virtual ~AsyncIO() = default;
@@ -84,13 +122,25 @@ public:
     virtual void shutdown() = 0;
     
     // Socket management
+    // socket须已为非阻塞模式（如accept4使用SOCK_NONBLOCK），后端不再额外设置
     virtual bool addSocket(socket_t socket, IOEventType events) = 0;
     virtual bool removeSocket(socket_t socket) = 0;
     virtual bool modifySocket(socket_t socket, IOEventType events) = 0;
     
     // Async operations
     virtual bool asyncRead(socket_t socket, const std::string& buffer, EventCallback callback) = 0;
-    virtual bool asyncWrite(socket_t socket, const std::string& data, EventCallback callback) = 0;
+    // 发送队列保存切片的引用，同一切片可以加入多个socket的发送队列而不复制数据
+    virtual bool asyncWrite(socket_t socket, const BufferSlice& data, EventCallback callback) = 0;
+    // 把同一份数据加入多个socket的发送队列，返回成功加入的数量；后端可以一次投递整批以减少跨线程唤醒
+    virtual size_t asyncWriteBatch(const std::vector<socket_t>& sockets, const BufferSlice& data, EventCallback callback) {
+        size_t queued = 0;
+        for (socket_t socket : sockets) {
+            if (asyncWrite(socket, data, callback)) {
+                ++queued;
+            }
+        }
+        return queued;
+    }
     virtual bool asyncAccept(socket_t serverSocket, EventCallback callback) = 0;
     
     // Event loop
@@ -98,27 +148,53 @@ public:
     virtual void stopEventLoop() = 0;
     virtual bool isEventLoopRunning() const = 0;
     
+    // 周期性回调，在事件循环线程中约每intervalMs调用一次（由等待超时驱动，不额外占用fd），
+    // 须在startEventLoop之前设置；后端不支持时返回false
+    virtual bool setTickCallback(int intervalMs, TickCallback callback) {
+        (void)intervalMs;
+        (void)callback;
+        return false;
+    }
+    
     // Status queries
     virtual int getActiveConnections() const = 0;
     virtual bool isSocketRegistered(socket_t socket) const = 0;
+    // 不支持自旋等待的后端返回全零
+    virtual PollStats getPollStats() const { return PollStats(); }
+    
+    // 热重启交接：在事件循环线程中执行task（事件循环未运行时直接执行），不支持的后端返回false
+    virtual bool runInLoop(std::function<void()> task) {
+        (void)task;
+        return false;
+    }
+    // 从后端摘除socket但不关闭，取出发送队列中尚未发出的数据，未完成的发送回调不再调用；
+    // 须在事件循环线程中（或事件循环未运行时）调用，不支持的后端返回false
+    virtual bool releaseSocket(socket_t socket, std::string& unsent) {
+        (void)socket;
+        (void)unsent;
+        return false;
+    }
+    // 是否支持releaseSocket；io_uring的在途recv/send持有socket，摘除前须等待其完成，暂不支持
+    virtual bool canReleaseSockets() const { return false; }
 };
 
 // Async I/O manager factory
 class AsyncIOFactory {
 public:
-    static std::unique_ptr<AsyncIO> createAsyncIO();
+    static std::unique_ptr<AsyncIO> createAsyncIO(const AsyncIOOptions& options = AsyncIOOptions());
 };
 
 // Cross-platform async I/O manager
 class AsyncIOManager {
 public:
     using EventCallback = std::function<void(const IOEvent&)>;
+    using TickCallback = AsyncIO::TickCallback;
     
     AsyncIOManager();
     ~AsyncIOManager();
     
     // Initialization
-    bool initialize();
+    bool initialize(const AsyncIOOptions& options = AsyncIOOptions());
     void shutdown();
     
     // Socket management
@@ -133,11 +209,12 @@ public:
     
     // Async operations
     bool asyncRead(socket_t socket, const std::string& buffer, EventCallback callback);
-    bool asyncWrite(socket_t socket, const std::string& data, EventCallback callback);
+    bool asyncWrite(socket_t socket, const BufferSlice& data, EventCallback callback);
+    size_t asyncWriteBatch(const std::vector<socket_t>& sockets, const BufferSlice& data, EventCallback callback);
     bool asyncAccept(socket_t serverSocket, EventCallback callback);
     
     bool startAsyncRead(socket_t socket, EventCallback callback);
-    bool startAsyncWrite(socket_t socket, const std::string& data, EventCallback callback);
+    bool startAsyncWrite(socket_t socket, const BufferSlice& data, EventCallback callback);
     bool startAsyncAccept(socket_t serverSocket, EventCallback callback);
     
     // Event loop control
@@ -150,24 +227,33 @@ public:
     void setReadCallback(EventCallback callback) { readCallback_ = callback; }
     void setWriteCallback(EventCallback callback) { writeCallback_ = callback; }
     void setErrorCallback(EventCallback callback) { errorCallback_ = callback; }
+    void setBackpressureCallback(EventCallback callback) { backpressureCallback_ = callback; }
+    
+    // 事件循环线程中的周期性回调（定时器驱动），须在startEventLoop之前设置
+    bool setTickCallback(int intervalMs, TickCallback callback);
     
     // Status queries
     int getActiveConnections() const;
+    PollStats getPollStats() const;
+    
+    // 热重启交接，见AsyncIO::runInLoop/releaseSocket
+    bool runInLoop(std::function<void()> task);
+    bool releaseSocket(socket_t socket, std::string& unsent);
+    bool canReleaseSockets() const { return asyncIO_ && asyncIO_->canReleaseSockets(); }
     
 private:
-    void eventLoop();
+    // 将后端事件按类型分发到已设置的回调
+    void dispatchEvent(const IOEvent& event);
     
     std::unique_ptr<AsyncIO> asyncIO_;
     std::atomic<bool> isRunning_{false};
-    std::thread eventLoopThread_;
-    std::mutex mutex_;
-    std::condition_variable condition_;
     
     // Callback functions
     EventCallback acceptCallback_;
     EventCallback readCallback_;
     EventCallback writeCallback_;
     EventCallback errorCallback_;
+    EventCallback backpressureCallback_;
     
     // Active connection count
     std::atomic<int> activeConnections_{0};
@@ -1,15 +1,22 @@
 #include "AsyncIO.h"
 #include "LinuxEpoll.h"
+#include "LinuxIoUring.h"
 #include "WindowsIOCP.h"
 
 #include <memory>
 
 // AsyncIOFactory实现
-std::unique_ptr<AsyncIO> AsyncIOFactory::createAsyncIO() {
+std::unique_ptr<AsyncIO> AsyncIOFactory::createAsyncIO(const AsyncIOOptions& options) {
 #ifdef _WIN32
+    (void)options;
     return std::make_unique<WindowsIOCP>();
 #else
-    return std::make_unique<LinuxEpoll>();
+#ifdef HAS_IO_URING
+    if (options.backend == AsyncIOBackend::IO_URING) {
+        return std::make_unique<LinuxIoUring>(options);
+    }
+#endif
+    return std::make_unique<LinuxEpoll>(options);
 #endif
 }
 
@@ -25,17 +32,27 @@ AsyncIOManager::~AsyncIOManager()
     shutdown();
 }
 
-bool AsyncIOManager::initialize()
+bool AsyncIOManager::initialize(const AsyncIOOptions& options)
 {
     // 创建平台特定的异步I/O实现
-    asyncIO_ = AsyncIOFactory::createAsyncIO();
+    asyncIO_ = AsyncIOFactory::createAsyncIO(options);
     if (!asyncIO_) {
         LOG_ERROR("Failed to create async I/O implementation");
         return false;
     }
     
     // 初始化异步I/O实现
-    if (!asyncIO_->initialize()) {
+    bool initialized = asyncIO_->initialize();
+    if (!initialized && options.backend == AsyncIOBackend::IO_URING) {
+        // io_uring不可用（内核过旧或被seccomp禁用）时回退到epoll
+        LOG_WARN("io_uring backend unavailable, falling back to epoll");
+        AsyncIOOptions fallbackOptions = options;
+        fallbackOptions.backend = AsyncIOBackend::EPOLL;
+        asyncIO_ = AsyncIOFactory::createAsyncIO(fallbackOptions);
+        initialized = asyncIO_ && asyncIO_->initialize();
+    }
+    
+    if (!initialized) {
         LOG_ERROR("Failed to initialize async I/O implementation");
         asyncIO_.reset();
         return false;
@@ -68,8 +85,9 @@ bool AsyncIOManager::addClient(socket_t socket)
         return false;
     }
     
-    // 注册socket用于读和错误事件
-    bool success = asyncIO_->addSocket(socket, IOEventType::READ | IOEventType::IOERROR);
+    // 注册socket用于读和错误事件，事件统一经dispatchEvent分发到已设置的回调
+    bool success = asyncIO_->addSocket(socket, IOEventType::READ | IOEventType::IOERROR) &&
+                   asyncIO_->asyncRead(socket, "", [this](const IOEvent& event) { dispatchEvent(event); });
     if (success) {
         activeConnections_++;
         LOG_DEBUG("Socket {} added to async I/O manager", socket);
@@ -133,11 +151,21 @@ bool AsyncIOManager::asyncRead(socket_t socket, const std::string& buffer, Event
     return startAsyncRead(socket, callback);
 }
 
-bool AsyncIOManager::asyncWrite(socket_t socket, const std::string& data, EventCallback callback)
+bool AsyncIOManager::asyncWrite(socket_t socket, const BufferSlice& data, EventCallback callback)
 {
     return startAsyncWrite(socket, data, callback);
 }
 
+size_t AsyncIOManager::asyncWriteBatch(const std::vector<socket_t>& sockets, const BufferSlice& data, EventCallback callback)
+{
+    if (!asyncIO_) {
+        LOG_ERROR("AsyncIOManager not initialized");
+        return 0;
+    }
+    
+    return asyncIO_->asyncWriteBatch(sockets, data, callback);
+}
+
 bool AsyncIOManager::asyncAccept(socket_t serverSocket, EventCallback callback)
 {
     return startAsyncAccept(serverSocket, callback);
@@ -153,7 +181,7 @@ bool AsyncIOManager::startAsyncRead(socket_t socket, EventCallback callback)
     return asyncIO_->asyncRead(socket, "", callback);
 }
 
-bool AsyncIOManager::startAsyncWrite(socket_t socket, const std::string& data, EventCallback callback)
+bool AsyncIOManager::startAsyncWrite(socket_t socket, const BufferSlice& data, EventCallback callback)
 {
     if (!asyncIO_) {
         LOG_ERROR("AsyncIOManager not initialized");
@@ -173,6 +201,16 @@ bool AsyncIOManager::startAsyncAccept(socket_t serverSocket, EventCallback callb
     return asyncIO_->asyncAccept(serverSocket, callback);
 }
 
+bool AsyncIOManager::setTickCallback(int intervalMs, TickCallback callback)
+{
+    if (!asyncIO_) {
+        LOG_ERROR("AsyncIOManager not initialized");
+        return false;
+    }
+    
+    return asyncIO_->setTickCallback(intervalMs, std::move(callback));
+}
+
 bool AsyncIOManager::startEventLoop()
 {
     if (!asyncIO_) {
@@ -185,7 +223,7 @@ bool AsyncIOManager::startEventLoop()
         return true;
     }
     
-    // 启动异步I/O的事件循环
+    // 启动异步I/O的事件循环，事件循环线程由具体后端持有（epoll_wait / IOCP工作线程）
     if (!asyncIO_->startEventLoop()) {
         LOG_ERROR("Failed to start async I/O event loop");
         return false;
@@ -193,9 +231,6 @@ bool AsyncIOManager::startEventLoop()
     
     isRunning_ = true;
     
-    // 启动管理线程来处理事件分发
-    eventLoopThread_ = std::thread(&AsyncIOManager::eventLoop, this);
-    
     LOG_INFO("AsyncIOManager event loop started");
     return true;
 }
@@ -207,18 +242,13 @@ void AsyncIOManager::stopEventLoop()
         return;
     }
     
-    // 停止异步I/O事件循环
+    // 停止异步I/O事件循环，后端负责唤醒并等待其线程结束
     if (asyncIO_) {
         asyncIO_->stopEventLoop();
     }
     
     isRunning_ = false;
     
-    // 等待事件循环线程结束
-    if (eventLoopThread_.joinable()) {
-        eventLoopThread_.join();
-    }
-    
     LOG_INFO("AsyncIOManager event loop stopped");
 }
 
@@ -227,25 +257,49 @@ int AsyncIOManager::getActiveConnections() const
     return activeConnections_.load();
 }
 
-void AsyncIOManager::eventLoop()
+PollStats AsyncIOManager::getPollStats() const
 {
-    LOG_INFO("AsyncIOManager event loop thread started");
-    
-    while (isRunning_.load()) {
-        // 检查是否有活跃连接
-        int activeConnections = getActiveConnections();
-        if (activeConnections == 0) {
-            // 没有活跃连接时休眠一段时间
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            continue;
-        }
-        
-        // 在实际实现中，这里会检查异步I/O的状态
-        // 并调用相应的回调函数
-        
-        // 短暂休眠以避免过度占用CPU
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    return asyncIO_ ? asyncIO_->getPollStats() : PollStats();
+}
+
+bool AsyncIOManager::runInLoop(std::function<void()> task)
+{
+    return asyncIO_ && asyncIO_->runInLoop(std::move(task));
+}
+
+bool AsyncIOManager::releaseSocket(socket_t socket, std::string& unsent)
+{
+    if (!asyncIO_ || !asyncIO_->releaseSocket(socket, unsent)) {
+        return false;
+    }
+    activeConnections_--;
+    return true;
+}
+
+void AsyncIOManager::dispatchEvent(const IOEvent& event)
+{
+    EventCallback callback;
+    switch (event.eventType) {
+        case IOEventType::ACCEPT:
+            callback = acceptCallback_;
+            break;
+        case IOEventType::READ:
+            callback = readCallback_;
+            break;
+        case IOEventType::WRITE:
+            callback = writeCallback_;
+            break;
+        case IOEventType::HIGH_WATERMARK:
+        case IOEventType::LOW_WATERMARK:
+            callback = backpressureCallback_;
+            break;
+        case IOEventType::IOERROR:
+        default:
+            callback = errorCallback_;
+            break;
     }
     
-    LOG_INFO("AsyncIOManager event loop thread ended");
+    if (callback) {
+        callback(event);
+    }
 }
\ No newline at end of file
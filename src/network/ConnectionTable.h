@@ -0,0 +1,146 @@
+#pragma once
+
+#include "SocketTypes.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+// 连接记录表 - 按槽位分配的slab加上按fd索引的平坦数组，插入、查找、删除均为O(1)
+// 记录按缓存行对齐，分块存储，扩容时已有记录的地址不变，可以直接保存在epoll_event.data.ptr中
+// detach只解除fd映射，记录在release之前保持有效，槽位也不会被复用，
+// 调用方可以在事件处理完成后再release，避免fd被复用时旧事件落到新连接上
+template <typename T>
+class ConnectionTable {
+public:
+    static constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+
+    ConnectionTable() = default;
+
+    ConnectionTable(const ConnectionTable&) = delete;
+    ConnectionTable& operator=(const ConnectionTable&) = delete;
+
+    // 为fd分配一条默认构造的记录，fd已存在或无效时返回nullptr
+    T* insert(socket_t fd) {
+        if (fd == INVALID_SOCKET_VALUE) {
+            return nullptr;
+        }
+        size_t index = static_cast<size_t>(fd);
+        if (index >= fdSlots_.size()) {
+            fdSlots_.resize(std::max(index + 1, fdSlots_.size() * 2), INVALID_SLOT);
+        }
+        if (fdSlots_[index] != INVALID_SLOT) {
+            return nullptr;
+        }
+
+        uint32_t slot = allocateSlot();
+        fdSlots_[index] = slot;
+        ++size_;
+        return &*slotAt(slot).record;
+    }
+
+    T* find(socket_t fd) const {
+        uint32_t slot = slotOf(fd);
+        return slot != INVALID_SLOT ? &*slotAt(slot).record : nullptr;
+    }
+
+    uint32_t slotOf(socket_t fd) const {
+        if (fd == INVALID_SOCKET_VALUE || static_cast<size_t>(fd) >= fdSlots_.size()) {
+            return INVALID_SLOT;
+        }
+        return fdSlots_[static_cast<size_t>(fd)];
+    }
+
+    // 按槽位取记录（包括已detach但尚未release的记录）
+    T* at(uint32_t slot) const {
+        if (slot >= capacity()) {
+            return nullptr;
+        }
+        auto& entry = slotAt(slot);
+        return entry.record ? &*entry.record : nullptr;
+    }
+
+    // 解除fd映射并返回记录所在槽位，记录保持有效直到release
+    uint32_t detach(socket_t fd) {
+        uint32_t slot = slotOf(fd);
+        if (slot != INVALID_SLOT) {
+            fdSlots_[static_cast<size_t>(fd)] = INVALID_SLOT;
+            --size_;
+        }
+        return slot;
+    }
+
+    // 析构记录并回收槽位
+    void release(uint32_t slot) {
+        if (slot >= capacity() || !slotAt(slot).record) {
+            return;
+        }
+        slotAt(slot).record.reset();
+        freeSlots_.push_back(slot);
+    }
+
+    bool erase(socket_t fd) {
+        uint32_t slot = detach(fd);
+        if (slot == INVALID_SLOT) {
+            return false;
+        }
+        release(slot);
+        return true;
+    }
+
+    // 当前映射中的连接数（不含已detach的记录）
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // 遍历所有映射中的连接
+    template <typename Func>
+    void forEach(Func&& func) const {
+        for (size_t fd = 0; fd < fdSlots_.size(); ++fd) {
+            if (fdSlots_[fd] != INVALID_SLOT) {
+                func(static_cast<socket_t>(fd), *slotAt(fdSlots_[fd]).record);
+            }
+        }
+    }
+
+    void clear() {
+        fdSlots_.clear();
+        freeSlots_.clear();
+        chunks_.clear();
+        size_ = 0;
+    }
+
+private:
+    static constexpr size_t CHUNK_SIZE = 1024;
+
+    struct alignas(64) Slot {
+        std::optional<T> record;
+    };
+
+    size_t capacity() const { return chunks_.size() * CHUNK_SIZE; }
+
+    Slot& slotAt(uint32_t slot) const {
+        return chunks_[slot / CHUNK_SIZE][slot % CHUNK_SIZE];
+    }
+
+    uint32_t allocateSlot() {
+        if (freeSlots_.empty()) {
+            // 新增一块槽位，已有块不移动
+            uint32_t base = static_cast<uint32_t>(capacity());
+            chunks_.push_back(std::make_unique<Slot[]>(CHUNK_SIZE));
+            for (size_t i = CHUNK_SIZE; i > 0; --i) {
+                freeSlots_.push_back(base + static_cast<uint32_t>(i - 1));
+            }
+        }
+        uint32_t slot = freeSlots_.back();
+        freeSlots_.pop_back();
+        slotAt(slot).record.emplace();
+        return slot;
+    }
+
+    std::vector<std::unique_ptr<Slot[]>> chunks_;
+    std::vector<uint32_t> fdSlots_;     // fd -> 槽位
+    std::vector<uint32_t> freeSlots_;   // 空闲槽位（栈，优先复用最近释放的槽位）
+    size_t size_ = 0;
+};
@@ -0,0 +1,207 @@
+#include "GatewayMux.h"
+#include "../messaging/message_header.h"
+
+#include <string>
+
+namespace {
+
+void appendUint32(std::string& out, uint32_t value)
+{
+    out.push_back(static_cast<char>((value >> 24) & 0xFF));
+    out.push_back(static_cast<char>((value >> 16) & 0xFF));
+    out.push_back(static_cast<char>((value >> 8) & 0xFF));
+    out.push_back(static_cast<char>(value & 0xFF));
+}
+
+void appendHeader(std::string& out, uint32_t messageId, uint32_t dataLength)
+{
+    appendUint32(out, messageId);
+    appendUint32(out, dataLength);
+}
+
+}
+
+GatewayMux::GatewayMux(size_t maxSessions)
+    : maxSessions_(maxSessions)
+{
+}
+
+bool GatewayMux::addLink(ConnectionId link)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return links_.emplace(link, std::unordered_map<uint32_t, uint32_t>()).second;
+}
+
+bool GatewayMux::isLink(ConnectionId link) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return links_.count(link) != 0;
+}
+
+std::vector<ConnectionId> GatewayMux::removeLink(ConnectionId link)
+{
+    std::vector<ConnectionId> closed;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = links_.find(link);
+    if (it == links_.end()) {
+        return closed;
+    }
+
+    closed.reserve(it->second.size());
+    for (const auto& session : it->second) {
+        closed.push_back(releaseSession(session.second));
+    }
+    links_.erase(it);
+    return closed;
+}
+
+ConnectionId GatewayMux::openSession(ConnectionId link, uint32_t sessionId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto linkIt = links_.find(link);
+    if (linkIt == links_.end()) {
+        return ConnectionId();
+    }
+
+    auto sessionIt = linkIt->second.find(sessionId);
+    if (sessionIt != linkIt->second.end()) {
+        const Session& session = sessions_[sessionIt->second];
+        return ConnectionId(sessionIt->second, session.generation);
+    }
+
+    if (activeSessions_ >= maxSessions_) {
+        return ConnectionId();
+    }
+
+    uint32_t slot;
+    if (!freeSlots_.empty()) {
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(sessions_.size());
+        sessions_.emplace_back();
+    }
+
+    // 代数只用低30位，最高两位为传输标记
+    ConnectionId id = ConnectionId::multiplexed(slot, nextGeneration_++);
+    if ((nextGeneration_ & ConnectionId::TRANSPORT_MASK) != 0) {
+        nextGeneration_ = 1;
+    }
+
+    Session& session = sessions_[slot];
+    session.link = link;
+    session.sessionId = sessionId;
+    session.generation = id.generation();
+    linkIt->second.emplace(sessionId, slot);
+    ++activeSessions_;
+    return id;
+}
+
+ConnectionId GatewayMux::closeSession(ConnectionId link, uint32_t sessionId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto linkIt = links_.find(link);
+    if (linkIt == links_.end()) {
+        return ConnectionId();
+    }
+    auto sessionIt = linkIt->second.find(sessionId);
+    if (sessionIt == linkIt->second.end()) {
+        return ConnectionId();
+    }
+
+    uint32_t slot = sessionIt->second;
+    linkIt->second.erase(sessionIt);
+    return releaseSession(slot);
+}
+
+bool GatewayMux::closeSession(ConnectionId connectionId, ConnectionId& link, uint32_t& sessionId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Session* session = findSession(connectionId);
+    if (!session) {
+        return false;
+    }
+
+    link = session->link;
+    sessionId = session->sessionId;
+    links_[link].erase(sessionId);
+    releaseSession(connectionId.slot());
+    return true;
+}
+
+bool GatewayMux::resolve(ConnectionId connectionId, ConnectionId& link, uint32_t& sessionId) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Session* session = findSession(connectionId);
+    if (!session) {
+        return false;
+    }
+    link = session->link;
+    sessionId = session->sessionId;
+    return true;
+}
+
+size_t GatewayMux::sessionCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return activeSessions_;
+}
+
+size_t GatewayMux::linkCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return links_.size();
+}
+
+const GatewayMux::Session* GatewayMux::findSession(ConnectionId connectionId) const
+{
+    if (!connectionId.isMultiplexed() || connectionId.slot() >= sessions_.size()) {
+        return nullptr;
+    }
+    // 槽位复用后代数不同，旧句柄视为已关闭
+    const Session& session = sessions_[connectionId.slot()];
+    return session.generation == connectionId.generation() ? &session : nullptr;
+}
+
+ConnectionId GatewayMux::releaseSession(uint32_t slot)
+{
+    Session& session = sessions_[slot];
+    ConnectionId id(slot, session.generation);
+    session = Session();
+    freeSlots_.push_back(slot);
+    --activeSessions_;
+    return id;
+}
+
+BufferSlice GatewayMux::encodeForward(uint32_t sessionId, const BufferSlice& frame)
+{
+    std::string out;
+    out.reserve(sizeof(MessageHeader) + SESSION_ID_SIZE + frame.size());
+    appendHeader(out, MessageIds::GATEWAY_FORWARD, static_cast<uint32_t>(SESSION_ID_SIZE + frame.size()));
+    appendUint32(out, sessionId);
+    out.append(frame.view());
+    return BufferSlice(std::move(out));
+}
+
+BufferSlice GatewayMux::encodeClose(uint32_t sessionId)
+{
+    std::string out;
+    out.reserve(sizeof(MessageHeader) + SESSION_ID_SIZE);
+    appendHeader(out, MessageIds::GATEWAY_CLOSE, SESSION_ID_SIZE);
+    appendUint32(out, sessionId);
+    return BufferSlice(std::move(out));
+}
+
+bool GatewayMux::decodeSessionId(const BufferSlice& body, uint32_t& sessionId, BufferSlice& inner)
+{
+    if (body.size() < SESSION_ID_SIZE) {
+        return false;
+    }
+    const uint8_t* data = body.data();
+    sessionId = (static_cast<uint32_t>(data[0]) << 24) |
+                (static_cast<uint32_t>(data[1]) << 16) |
+                (static_cast<uint32_t>(data[2]) << 8) |
+                static_cast<uint32_t>(data[3]);
+    inner = body.slice(SESSION_ID_SIZE);
+    return true;
+}
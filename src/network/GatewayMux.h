@@ -0,0 +1,70 @@
+#pragma once
+
+#include "../messaging/buffer_slice.h"
+#include "../messaging/connection_id.h"
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// 网关复用链路上的逻辑会话表
+// 受信任的前置网关用少量连接（TCP、AF_UNIX、共享内存或可靠UDP均可）承载大量玩家：
+// 链路建立后网关先发送GATEWAY_HELLO，消息体为配置的GatewayToken，校验通过后服务端回复消息体为空的GATEWAY_HELLO；
+// 之后每个玩家的帧包装在GATEWAY_FORWARD中，消息体为4字节会话ID（大端）加一个完整的内层帧，两个方向格式相同；
+// GATEWAY_CLOSE的消息体只有会话ID，网关发出表示玩家已断开，服务端发出表示踢出该会话
+// 每个(链路, 会话ID)对应一个独立的ConnectionId，首次收到该会话的帧时创建，会话或链路关闭后旧句柄失效
+// 服务端在链路上直接发送的未包装帧（如全服广播）表示发给该链路上的所有会话
+// 所有操作由内部互斥锁保护，可从任意线程调用
+class GatewayMux {
+public:
+    static constexpr size_t SESSION_ID_SIZE = 4;
+
+    explicit GatewayMux(size_t maxSessions);
+
+    GatewayMux(const GatewayMux&) = delete;
+    GatewayMux& operator=(const GatewayMux&) = delete;
+
+    // 链路通过认证后登记，已登记时返回false
+    bool addLink(ConnectionId link);
+    bool isLink(ConnectionId link) const;
+    // 链路断开时移除其所有会话，返回被移除的会话句柄
+    std::vector<ConnectionId> removeLink(ConnectionId link);
+
+    // 查找或创建会话；链路未登记或会话总数达到上限时返回无效句柄
+    ConnectionId openSession(ConnectionId link, uint32_t sessionId);
+    // 网关通知会话结束，返回被关闭的句柄，会话不存在时返回无效句柄
+    ConnectionId closeSession(ConnectionId link, uint32_t sessionId);
+    // 服务端主动关闭会话，返回所在链路和网关侧会话ID用于通知网关；会话已关闭时返回false
+    bool closeSession(ConnectionId connectionId, ConnectionId& link, uint32_t& sessionId);
+    // 由会话句柄查出所在链路和网关侧会话ID，会话已关闭时返回false
+    bool resolve(ConnectionId connectionId, ConnectionId& link, uint32_t& sessionId) const;
+
+    size_t sessionCount() const;
+    size_t linkCount() const;
+
+    // 编码发往网关的GATEWAY_FORWARD/GATEWAY_CLOSE帧
+    static BufferSlice encodeForward(uint32_t sessionId, const BufferSlice& frame);
+    static BufferSlice encodeClose(uint32_t sessionId);
+    // 解析GATEWAY_FORWARD/GATEWAY_CLOSE的消息体，inner为会话ID之后的部分，引用body的存储
+    static bool decodeSessionId(const BufferSlice& body, uint32_t& sessionId, BufferSlice& inner);
+
+private:
+    struct Session {
+        ConnectionId link;
+        uint32_t sessionId = 0;
+        uint32_t generation = 0;    // 带MULTIPLEXED_FLAG，0表示槽位空闲
+    };
+
+    // 以下函数调用方需持有mutex_
+    const Session* findSession(ConnectionId connectionId) const;
+    ConnectionId releaseSession(uint32_t slot);
+
+    size_t maxSessions_;
+    std::vector<Session> sessions_;
+    std::vector<uint32_t> freeSlots_;
+    uint32_t nextGeneration_ = 1;
+    size_t activeSessions_ = 0;
+    std::unordered_map<ConnectionId, std::unordered_map<uint32_t, uint32_t>> links_;    // 链路 -> 会话ID -> 槽位
+    mutable std::mutex mutex_;
+};
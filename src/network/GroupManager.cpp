@@ -0,0 +1,181 @@
+#include "GroupManager.h"
+
+#include <algorithm>
+#include <atomic>
+
+bool GroupManager::createGroup(GroupId groupId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return groups_.emplace(groupId, Group()).second;
+}
+
+bool GroupManager::destroyGroup(GroupId groupId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = groups_.find(groupId);
+    if (it == groups_.end()) {
+        return false;
+    }
+
+    // 删除每个成员记录中指向该分组的一项；已取得的快照仍然有效
+    for (const auto& list : it->second.members) {
+        if (!list) {
+            continue;
+        }
+        for (const Member& member : *list) {
+            std::vector<Membership>* memberships = membershipsOf(member.first);
+            if (!memberships) {
+                continue;
+            }
+            auto entry = std::find_if(memberships->begin(), memberships->end(),
+                                      [groupId](const Membership& m) { return m.groupId == groupId; });
+            if (entry != memberships->end()) {
+                *entry = memberships->back();
+                memberships->pop_back();
+            }
+        }
+    }
+    groups_.erase(it);
+    return true;
+}
+
+bool GroupManager::hasGroup(GroupId groupId) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return groups_.find(groupId) != groups_.end();
+}
+
+bool GroupManager::join(GroupId groupId, socket_t socket, ConnectionId connectionId, size_t reactorIndex) {
+    if (socket == INVALID_SOCKET_VALUE) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = groups_.find(groupId);
+    if (it == groups_.end()) {
+        return false;
+    }
+
+    size_t index = static_cast<size_t>(socket);
+    if (index >= memberships_.size()) {
+        memberships_.resize(std::max(index + 1, memberships_.size() * 2));
+    }
+    std::vector<Membership>& memberships = memberships_[index];
+    for (const Membership& membership : memberships) {
+        if (membership.groupId == groupId) {
+            return false;
+        }
+    }
+
+    Group& group = it->second;
+    if (reactorIndex >= group.members.size()) {
+        group.members.resize(reactorIndex + 1);
+    }
+    std::vector<Member>& members = writableMembers(group, reactorIndex);
+    memberships.push_back(Membership{groupId, static_cast<uint32_t>(reactorIndex), static_cast<uint32_t>(members.size())});
+    members.emplace_back(socket, connectionId);
+    ++group.size;
+    return true;
+}
+
+bool GroupManager::leave(GroupId groupId, socket_t socket) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Membership>* memberships = membershipsOf(socket);
+    auto groupIt = groups_.find(groupId);
+    if (!memberships || groupIt == groups_.end()) {
+        return false;
+    }
+
+    auto entry = std::find_if(memberships->begin(), memberships->end(),
+                              [groupId](const Membership& m) { return m.groupId == groupId; });
+    if (entry == memberships->end()) {
+        return false;
+    }
+
+    Membership membership = *entry;
+    *entry = memberships->back();
+    memberships->pop_back();
+    removeMember(groupIt->second, groupId, membership);
+    return true;
+}
+
+void GroupManager::leaveAll(socket_t socket) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Membership>* memberships = membershipsOf(socket);
+    if (!memberships) {
+        return;
+    }
+
+    // 先取出记录，removeMember修正其他成员的位置时不会再访问到本socket的记录
+    std::vector<Membership> leaving;
+    leaving.swap(*memberships);
+    for (const Membership& membership : leaving) {
+        auto groupIt = groups_.find(membership.groupId);
+        if (groupIt != groups_.end()) {
+            removeMember(groupIt->second, membership.groupId, membership);
+        }
+    }
+    // 保留容量，fd被复用时无需重新分配
+    leaving.clear();
+    memberships->swap(leaving);
+}
+
+size_t GroupManager::memberCount(GroupId groupId) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = groups_.find(groupId);
+    return it != groups_.end() ? it->second.size : 0;
+}
+
+bool GroupManager::snapshotMembers(GroupId groupId, std::vector<MemberList>& out) const {
+    out.clear();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = groups_.find(groupId);
+    if (it == groups_.end()) {
+        return false;
+    }
+    out.assign(it->second.members.begin(), it->second.members.end());
+    return true;
+}
+
+size_t GroupManager::groupCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return groups_.size();
+}
+
+std::vector<GroupManager::Membership>* GroupManager::membershipsOf(socket_t socket) {
+    if (socket == INVALID_SOCKET_VALUE || static_cast<size_t>(socket) >= memberships_.size()) {
+        return nullptr;
+    }
+    return &memberships_[static_cast<size_t>(socket)];
+}
+
+std::vector<GroupManager::Member>& GroupManager::writableMembers(Group& group, size_t reactorIndex) {
+    std::shared_ptr<std::vector<Member>>& list = group.members[reactorIndex];
+    if (!list) {
+        list = std::make_shared<std::vector<Member>>();
+    } else if (list.use_count() > 1) {
+        list = std::make_shared<std::vector<Member>>(*list);
+    } else {
+        // 快照只在锁内产生，计数为1时没有其他引用；与reactor线程释放快照时的计数递减同步后再修改
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    return *list;
+}
+
+void GroupManager::removeMember(Group& group, GroupId groupId, const Membership& membership) {
+    std::vector<Member>& members = writableMembers(group, membership.reactorIndex);
+    socket_t moved = members.back().first;
+    members[membership.position] = members.back();
+    members.pop_back();
+    --group.size;
+
+    // 末尾成员被移到空出的位置，更新它的记录
+    if (membership.position < members.size()) {
+        std::vector<Membership>* movedMemberships = membershipsOf(moved);
+        if (movedMemberships) {
+            for (Membership& entry : *movedMemberships) {
+                if (entry.groupId == groupId) {
+                    entry.position = membership.position;
+                    break;
+                }
+            }
+        }
+    }
+}
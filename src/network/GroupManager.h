@@ -0,0 +1,73 @@
+#pragma once
+
+#include "SocketTypes.h"
+#include "../messaging/connection_id.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 组播分组（房间/频道/公会）的成员表
+// 每个分组按reactor把成员（socket及加入时的连接句柄）存放在连续数组中，发布时逐个reactor整批投递，不需要按成员查表；
+// reactor线程按句柄核对，成员断开后fd被复用时不会发给新连接
+// 成员数组写时复制：发布只在锁内复制数组的引用，数组本身在锁外交给reactor；加入/离开时数组仍被发布引用才复制一份
+// 每个socket在按fd索引的数组中记录自己所在的分组和数组下标，离开分组时交换删除为O(1)，断开连接时按此清理
+// 所有操作由内部互斥锁保护，可从任意线程调用
+class GroupManager {
+public:
+    using GroupId = uint64_t;
+    using Member = std::pair<socket_t, ConnectionId>;
+    // 某个reactor上成员数组的只读快照，发布后成员变化不影响已取得的快照
+    using MemberList = std::shared_ptr<const std::vector<Member>>;
+
+    GroupManager() = default;
+
+    GroupManager(const GroupManager&) = delete;
+    GroupManager& operator=(const GroupManager&) = delete;
+
+    // 分组已存在时返回false
+    bool createGroup(GroupId groupId);
+    // 解散分组并移除所有成员，分组不存在时返回false
+    bool destroyGroup(GroupId groupId);
+    bool hasGroup(GroupId groupId) const;
+
+    // 把socket加入分组，reactorIndex为连接所属的reactor；分组不存在或已是成员时返回false
+    bool join(GroupId groupId, socket_t socket, ConnectionId connectionId, size_t reactorIndex);
+    bool leave(GroupId groupId, socket_t socket);
+    // 连接断开时退出所有分组
+    void leaveAll(socket_t socket);
+
+    size_t memberCount(GroupId groupId) const;
+    size_t groupCount() const;
+
+    // 取得分组在每个reactor上的成员数组快照，out[reactorIndex]为空指针或空数组表示该reactor上没有成员
+    // 锁内只复制引用；调用方预留out的容量（reactor数量）时锁内不分配内存。分组不存在时返回false
+    bool snapshotMembers(GroupId groupId, std::vector<MemberList>& out) const;
+
+private:
+    struct Group {
+        std::vector<std::shared_ptr<std::vector<Member>>> members;  // 按reactor划分的成员数组
+        size_t size = 0;
+    };
+
+    // socket所在的一个分组及其在该分组成员数组中的位置
+    struct Membership {
+        GroupId groupId;
+        uint32_t reactorIndex;
+        uint32_t position;
+    };
+
+    // 以下函数调用方需持有mutex_
+    std::vector<Membership>* membershipsOf(socket_t socket);
+    // 取得可修改的成员数组：数组仍被某个快照引用时先复制一份，不影响正在发布的reactor
+    static std::vector<Member>& writableMembers(Group& group, size_t reactorIndex);
+    // 从分组的成员数组中交换删除，并修正被移动成员记录的位置
+    void removeMember(Group& group, GroupId groupId, const Membership& membership);
+
+    std::unordered_map<GroupId, Group> groups_;
+    std::vector<std::vector<Membership>> memberships_;     // fd -> 所在分组，一个连接通常只在少数分组中
+    mutable std::mutex mutex_;
+};
@@ -0,0 +1,395 @@
+#include "HotRestart.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef __linux__
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <cerrno>
+
+namespace {
+
+bool fillUnixAddress(const std::string& path, struct sockaddr_un& address) {
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        LOG_ERROR("Invalid handover socket path '{}'", path);
+        return false;
+    }
+    memcpy(address.sun_path, path.c_str(), path.size());
+    return true;
+}
+
+void setIoTimeout(int socket, int seconds) {
+    struct timeval timeout;
+    timeout.tv_sec = seconds;
+    timeout.tv_usec = 0;
+    setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+}
+
+// 交接通道传递的是监听套接字和客户端连接，只接受同一用户的进程
+bool peerIsSameUser(int socket) {
+    struct ucred credentials;
+    socklen_t length = sizeof(credentials);
+    if (getsockopt(socket, SOL_SOCKET, SO_PEERCRED, &credentials, &length) == -1) {
+        LOG_ERROR("Failed to read handover peer credentials: {}", strerror(errno));
+        return false;
+    }
+    if (credentials.uid != geteuid()) {
+        LOG_WARN("Rejecting handover peer pid {} with uid {} (expected {})", credentials.pid, credentials.uid, geteuid());
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+HotRestart::HotRestart(socket_t socket) : socket_(socket) {
+    setIoTimeout(socket_, IO_TIMEOUT_SECONDS);
+}
+
+HotRestart::~HotRestart() {
+    if (socket_ != INVALID_SOCKET_VALUE) {
+        close(socket_);
+    }
+}
+
+std::unique_ptr<HotRestart> HotRestart::connect(const std::string& path) {
+    struct sockaddr_un address;
+    if (!fillUnixAddress(path, address)) {
+        return nullptr;
+    }
+
+    int channelSocket = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (channelSocket == -1) {
+        LOG_ERROR("Failed to create handover socket: {}", strerror(errno));
+        return nullptr;
+    }
+    std::unique_ptr<HotRestart> channel(new HotRestart(channelSocket));
+    if (::connect(channelSocket, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) == -1) {
+        // 没有旧进程（或只剩上次运行残留的套接字文件）是正常的冷启动
+        if (errno != ENOENT && errno != ECONNREFUSED) {
+            LOG_WARN("Failed to connect to handover socket {}: {}", path, strerror(errno));
+        }
+        return nullptr;
+    }
+    // 监听方可能不是旧的服务进程（他人抢先绑定了同一路径），不接收其发来的fd
+    if (!peerIsSameUser(channelSocket)) {
+        return nullptr;
+    }
+
+    Record request;
+    request.type = RECORD_REQUEST;
+    if (!channel->sendRecord(request, nullptr, 0)) {
+        return nullptr;
+    }
+    return channel;
+}
+
+socket_t HotRestart::listen(const std::string& path) {
+    struct sockaddr_un address;
+    if (!fillUnixAddress(path, address)) {
+        return INVALID_SOCKET_VALUE;
+    }
+
+    int listenSocket = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (listenSocket == -1) {
+        LOG_ERROR("Failed to create handover socket: {}", strerror(errno));
+        return INVALID_SOCKET_VALUE;
+    }
+    // 套接字文件只允许本用户连接：bind按socket inode的权限创建文件，先fchmod则不受进程umask影响，
+    // 绑定后再chmod一次，不依赖这一行为的系统上也能收紧权限（不修改进程umask，其他线程可能正在创建文件）
+    if (fchmod(listenSocket, S_IRUSR | S_IWUSR) == -1) {
+        LOG_WARN("Failed to restrict handover socket permissions: {}", strerror(errno));
+    }
+    // 接管完成的旧进程关闭监听时不删除套接字文件，由这里删除后重新绑定
+    unlink(path.c_str());
+    if (bind(listenSocket, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) == -1 ||
+        chmod(path.c_str(), S_IRUSR | S_IWUSR) == -1 ||
+        ::listen(listenSocket, 1) == -1) {
+        LOG_ERROR("Failed to listen on handover socket {}: {}", path, strerror(errno));
+        close(listenSocket);
+        return INVALID_SOCKET_VALUE;
+    }
+    return listenSocket;
+}
+
+std::unique_ptr<HotRestart> HotRestart::accept(socket_t listenSocket) {
+    int channelSocket = ::accept4(listenSocket, nullptr, nullptr, SOCK_CLOEXEC);
+    if (channelSocket == -1) {
+        LOG_ERROR("Failed to accept handover request: {}", strerror(errno));
+        return nullptr;
+    }
+    std::unique_ptr<HotRestart> channel(new HotRestart(channelSocket));
+    if (!peerIsSameUser(channelSocket)) {
+        return nullptr;
+    }
+
+    Record request;
+    size_t fdCount = 0;
+    if (!channel->receiveRecord(request, nullptr, 0, fdCount) || request.type != RECORD_REQUEST) {
+        LOG_WARN("Ignoring invalid handover request");
+        return nullptr;
+    }
+    return channel;
+}
+
+bool HotRestart::sendListeners(const std::vector<socket_t>& listeners, socket_t unixListener) {
+    std::vector<socket_t> fds(listeners);
+    if (unixListener != INVALID_SOCKET_VALUE) {
+        fds.push_back(unixListener);
+    }
+    if (fds.size() > MAX_FDS) {
+        LOG_ERROR("Too many listening sockets to hand over: {}", fds.size());
+        return false;
+    }
+
+    Record record;
+    record.type = RECORD_LISTENERS;
+    record.count = static_cast<uint32_t>(listeners.size());
+    record.flags = unixListener != INVALID_SOCKET_VALUE ? 1 : 0;
+    return sendRecord(record, fds.data(), fds.size());
+}
+
+bool HotRestart::receiveListeners(std::vector<socket_t>& listeners, socket_t& unixListener) {
+    Record record;
+    socket_t fds[MAX_FDS];
+    size_t fdCount = 0;
+    if (!receiveRecord(record, fds, MAX_FDS, fdCount)) {
+        return false;
+    }
+    if (record.type != RECORD_LISTENERS || fdCount != record.count + (record.flags ? 1 : 0)) {
+        LOG_ERROR("Unexpected handover record {} with {} fd(s) while waiting for listeners", record.type, fdCount);
+        for (size_t i = 0; i < fdCount; ++i) {
+            close(fds[i]);
+        }
+        return false;
+    }
+    listeners.assign(fds, fds + record.count);
+    unixListener = record.flags ? fds[record.count] : INVALID_SOCKET_VALUE;
+    return true;
+}
+
+bool HotRestart::sendConnection(const HandoverConnection& connection) {
+    Record record;
+    record.type = RECORD_CONNECTION;
+    record.count = static_cast<uint32_t>(connection.reactorIndex);
+    record.flags = (connection.authenticated ? CONNECTION_AUTHENTICATED : 0) |
+                   (connection.gatewayLink ? CONNECTION_GATEWAY_LINK : 0);
+    record.inboundBytes = connection.inbound.size();
+    record.outboundBytes = connection.outbound.size();
+    return sendRecord(record, &connection.socket, 1) && sendData(connection.inbound) && sendData(connection.outbound);
+}
+
+bool HotRestart::receiveConnection(HandoverConnection& connection, bool& finished) {
+    finished = false;
+    Record record;
+    socket_t fd = INVALID_SOCKET_VALUE;
+    size_t fdCount = 0;
+    if (!receiveRecord(record, &fd, 1, fdCount)) {
+        return false;
+    }
+    if (record.type == RECORD_FINISHED) {
+        finished = true;
+        return false;
+    }
+    if (record.type != RECORD_CONNECTION || fdCount != 1) {
+        LOG_ERROR("Unexpected handover record {} with {} fd(s) while waiting for connections", record.type, fdCount);
+        if (fdCount == 1) {
+            close(fd);
+        }
+        return false;
+    }
+
+    connection.socket = fd;
+    connection.reactorIndex = static_cast<int>(record.count);
+    connection.authenticated = (record.flags & CONNECTION_AUTHENTICATED) != 0;
+    connection.gatewayLink = (record.flags & CONNECTION_GATEWAY_LINK) != 0;
+    if (!receiveData(connection.inbound, record.inboundBytes) || !receiveData(connection.outbound, record.outboundBytes)) {
+        close(fd);
+        connection.socket = INVALID_SOCKET_VALUE;
+        return false;
+    }
+    return true;
+}
+
+bool HotRestart::sendFinished() {
+    Record record;
+    record.type = RECORD_FINISHED;
+    return sendRecord(record, nullptr, 0);
+}
+
+bool HotRestart::sendRecord(const Record& record, const socket_t* fds, size_t fdCount) {
+    struct iovec iov;
+    iov.iov_base = const_cast<Record*>(&record);
+    iov.iov_len = sizeof(record);
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int) * MAX_FDS)];
+    memset(control, 0, sizeof(control));
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    if (fdCount > 0) {
+        message.msg_control = control;
+        message.msg_controllen = CMSG_SPACE(sizeof(int) * fdCount);
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fdCount);
+        memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * fdCount);
+    }
+
+    ssize_t sent;
+    do {
+        sent = sendmsg(socket_, &message, MSG_NOSIGNAL);
+    } while (sent == -1 && errno == EINTR);
+    if (sent != static_cast<ssize_t>(sizeof(record))) {
+        LOG_ERROR("Failed to send handover record {}: {}", record.type, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool HotRestart::receiveRecord(Record& record, socket_t* fds, size_t maxFds, size_t& fdCount) {
+    fdCount = 0;
+    struct iovec iov;
+    iov.iov_base = &record;
+    iov.iov_len = sizeof(record);
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int) * MAX_FDS)];
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    ssize_t received;
+    do {
+        received = recvmsg(socket_, &message, MSG_CMSG_CLOEXEC);
+    } while (received == -1 && errno == EINTR);
+    if (received == -1) {
+        LOG_ERROR("Failed to receive handover record: {}", strerror(errno));
+        return false;
+    }
+
+    // 先收下所有描述符，超出调用方预期的一律关闭，避免泄漏
+    bool valid = true;
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+            continue;
+        }
+        size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (size_t i = 0; i < count; ++i) {
+            int fd;
+            memcpy(&fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(fd));
+            if (fdCount < maxFds) {
+                fds[fdCount++] = fd;
+            } else {
+                close(fd);
+                valid = false;
+            }
+        }
+    }
+
+    if (!valid || (message.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) != 0 ||
+        received != static_cast<ssize_t>(sizeof(record)) || record.magic != MAGIC) {
+        LOG_ERROR("Invalid handover record ({} bytes)", received);
+        for (size_t i = 0; i < fdCount; ++i) {
+            close(fds[i]);
+        }
+        fdCount = 0;
+        return false;
+    }
+    return true;
+}
+
+bool HotRestart::sendData(const std::string& data) {
+    for (size_t offset = 0; offset < data.size(); offset += CHUNK_SIZE) {
+        size_t length = std::min(CHUNK_SIZE, data.size() - offset);
+        ssize_t sent;
+        do {
+            sent = send(socket_, data.data() + offset, length, MSG_NOSIGNAL);
+        } while (sent == -1 && errno == EINTR);
+        if (sent != static_cast<ssize_t>(length)) {
+            LOG_ERROR("Failed to send handover data: {}", strerror(errno));
+            return false;
+        }
+    }
+    return true;
+}
+
+bool HotRestart::receiveData(std::string& data, uint64_t size) {
+    data.clear();
+    data.reserve(size);
+    char chunk[CHUNK_SIZE];
+    while (data.size() < size) {
+        ssize_t received;
+        do {
+            received = recv(socket_, chunk, sizeof(chunk), 0);
+        } while (received == -1 && errno == EINTR);
+        if (received <= 0 || data.size() + static_cast<size_t>(received) > size) {
+            LOG_ERROR("Failed to receive handover data: {}", received < 0 ? strerror(errno) : "unexpected size");
+            return false;
+        }
+        data.append(chunk, static_cast<size_t>(received));
+    }
+    return true;
+}
+
+#else // !__linux__
+
+HotRestart::HotRestart(socket_t socket) : socket_(socket) {}
+
+HotRestart::~HotRestart() {}
+
+std::unique_ptr<HotRestart> HotRestart::connect(const std::string& path) {
+    (void)path;
+    return nullptr;
+}
+
+socket_t HotRestart::listen(const std::string& path) {
+    (void)path;
+    LOG_ERROR("Hot restart is only supported on Linux");
+    return INVALID_SOCKET_VALUE;
+}
+
+std::unique_ptr<HotRestart> HotRestart::accept(socket_t listenSocket) {
+    (void)listenSocket;
+    return nullptr;
+}
+
+bool HotRestart::sendListeners(const std::vector<socket_t>& listeners, socket_t unixListener) {
+    (void)listeners;
+    (void)unixListener;
+    return false;
+}
+
+bool HotRestart::receiveListeners(std::vector<socket_t>& listeners, socket_t& unixListener) {
+    (void)listeners;
+    (void)unixListener;
+    return false;
+}
+
+bool HotRestart::sendConnection(const HandoverConnection& connection) {
+    (void)connection;
+    return false;
+}
+
+bool HotRestart::receiveConnection(HandoverConnection& connection, bool& finished) {
+    (void)connection;
+    finished = true;
+    return false;
+}
+
+bool HotRestart::sendFinished() {
+    return false;
+}
+
+#endif // __linux__
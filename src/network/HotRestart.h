@@ -0,0 +1,82 @@
+#pragma once
+
+#include "SocketTypes.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 交接给新进程的一个客户端连接
+struct HandoverConnection {
+    socket_t socket = INVALID_SOCKET_VALUE;
+    int reactorIndex = 0;           // 在旧进程中所属的reactor，新进程按自己的reactor数取模
+    bool authenticated = false;     // 已登录，新进程中不再有登录期限
+    bool gatewayLink = false;       // 已认证的网关复用链路
+    std::string inbound;            // 入站缓冲区中尚未投递的数据（半帧或被限速延后的帧）
+    std::string outbound;           // 发送队列中尚未发出的数据
+};
+
+// 热重启交接通道 - 新进程通过AF_UNIX SOCK_SEQPACKET连接旧进程，以SCM_RIGHTS接收监听套接字和客户端连接
+// 交接顺序：新进程发送请求；旧进程停止accept并先发出监听套接字，之后新进程即可继续accept；
+// 旧进程等主循环处理完已收到的消息后逐个发送连接记录（带fd），记录之后是连接的入站和出站数据块；最后发送结束标记
+// 两个进程在同一台机器上运行同一版本的记录格式，字段按本机字节序传输
+class HotRestart {
+public:
+    ~HotRestart();
+
+    HotRestart(const HotRestart&) = delete;
+    HotRestart& operator=(const HotRestart&) = delete;
+
+    // 新进程：连接旧进程并发送交接请求，没有旧进程在该路径上监听时返回nullptr
+    static std::unique_ptr<HotRestart> connect(const std::string& path);
+    // 旧进程：在path上监听交接请求（删除残留的套接字文件），失败返回INVALID_SOCKET_VALUE
+    static socket_t listen(const std::string& path);
+    // 旧进程：接受一个连接并读取交接请求，不是交接请求时返回nullptr
+    static std::unique_ptr<HotRestart> accept(socket_t listenSocket);
+
+    // 监听套接字：各reactor的TCP监听套接字，以及AF_UNIX监听套接字（没有时为INVALID_SOCKET_VALUE）
+    bool sendListeners(const std::vector<socket_t>& listeners, socket_t unixListener);
+    bool receiveListeners(std::vector<socket_t>& listeners, socket_t& unixListener);
+
+    // 发送成功后对方持有fd的副本，调用方关闭自己的fd不会断开连接
+    bool sendConnection(const HandoverConnection& connection);
+    // 收到结束标记时返回false并置finished为true，出错时返回false
+    bool receiveConnection(HandoverConnection& connection, bool& finished);
+    bool sendFinished();
+
+private:
+    enum RecordType : uint32_t {
+        RECORD_REQUEST = 1,
+        RECORD_LISTENERS = 2,
+        RECORD_CONNECTION = 3,
+        RECORD_FINISHED = 4
+    };
+
+    // 每条记录是一个数据报，fd随记录一起发送
+    struct Record {
+        uint32_t magic = MAGIC;
+        uint32_t type = 0;
+        uint32_t count = 0;         // LISTENERS：TCP监听套接字数量；CONNECTION：reactor序号
+        uint32_t flags = 0;         // LISTENERS：是否带AF_UNIX监听套接字；CONNECTION：CONNECTION_*标志
+        uint64_t inboundBytes = 0;
+        uint64_t outboundBytes = 0;
+    };
+
+    static constexpr uint32_t MAGIC = 0x48525354;          // "HRST"
+    static constexpr uint32_t CONNECTION_AUTHENTICATED = 0x1;
+    static constexpr uint32_t CONNECTION_GATEWAY_LINK = 0x2;
+    static constexpr size_t MAX_FDS = 250;                  // 单条消息的SCM_RIGHTS上限为253
+    static constexpr size_t CHUNK_SIZE = 32 * 1024;         // 连接数据按块发送，不超过SOCK_SEQPACKET的单条消息上限
+    static constexpr int IO_TIMEOUT_SECONDS = 10;           // 对方进程卡住时不无限期阻塞启动或退出
+
+    explicit HotRestart(socket_t socket);
+
+    bool sendRecord(const Record& record, const socket_t* fds, size_t fdCount);
+    // 收到的fd数量不超过maxFds，多余的fd会被关闭并返回false
+    bool receiveRecord(Record& record, socket_t* fds, size_t maxFds, size_t& fdCount);
+    bool sendData(const std::string& data);
+    bool receiveData(std::string& data, uint64_t size);
+
+    socket_t socket_;
+};
@@ -5,6 +5,7 @@
 
 #include <string>
 #include <memory>
+#include "../messaging/buffer_slice.h"
 
 // 网络事件监听器接口 - 用于解耦网络层和业务层
 class INetworkEventListener {
@@ -17,8 +18,8 @@ public:
     // 处理客户端断开连接事件
     virtual void onClientDisconnected(socket_t clientSocket) = 0;
     
-    // 处理接收到的网络数据
-    virtual void onDataReceived(socket_t clientSocket, const std::vector<uint8_t>& data) = 0;
+    // 处理接收到的网络数据，data与接收缓冲区共享存储，需要保留时拷贝切片
+    virtual void onDataReceived(socket_t clientSocket, const BufferSlice& data) = 0;
     
     // 处理数据发送完成事件
     virtual void onDataSent(socket_t clientSocket, size_t bytesSent) = 0;
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+// 连接的入站缓冲区 - 连续内存加读写偏移
+// 消费一帧只移动读偏移，帧在缓冲区内原地解析；仅在尾部空间不足时才把未消费的半帧搬到开头或扩容
+class InboundBuffer {
+public:
+    static constexpr size_t INITIAL_CAPACITY = 4096;
+
+    explicit InboundBuffer(size_t initialCapacity = INITIAL_CAPACITY)
+        : buffer_(initialCapacity), readPos_(0), writePos_(0) {}
+
+    // 未消费数据
+    const uint8_t* data() const { return buffer_.data() + readPos_; }
+    size_t size() const { return writePos_ - readPos_; }
+    bool empty() const { return readPos_ == writePos_; }
+    size_t capacity() const { return buffer_.size(); }
+
+    // 追加接收到的数据
+    void append(const void* data, size_t length) {
+        if (length == 0) {
+            return;
+        }
+        std::memcpy(prepareWrite(length), data, length);
+        writePos_ += length;
+    }
+
+    // 预留至少length字节的可写空间，供recv直接写入，写入后调用commitWrite
+    uint8_t* prepareWrite(size_t length) {
+        ensureWritable(length);
+        return buffer_.data() + writePos_;
+    }
+
+    void commitWrite(size_t length) {
+        writePos_ = std::min(writePos_ + length, buffer_.size());
+    }
+
+    // 消费已处理的帧
+    void consume(size_t length) {
+        readPos_ += std::min(length, size());
+        if (readPos_ == writePos_) {
+            // 全部消费完时复位，下次从头写入，无需搬移
+            readPos_ = 0;
+            writePos_ = 0;
+        }
+    }
+
+    void clear() {
+        readPos_ = 0;
+        writePos_ = 0;
+    }
+
+private:
+    void ensureWritable(size_t length) {
+        if (buffer_.size() - writePos_ >= length) {
+            return;
+        }
+
+        size_t readable = size();
+        if (buffer_.size() - readable < length) {
+            buffer_.resize(std::max(buffer_.size() * 2, readable + length));
+        }
+
+        // 只搬移剩余的未完整帧
+        if (readPos_ > 0 && readable > 0) {
+            std::memmove(buffer_.data(), buffer_.data() + readPos_, readable);
+        }
+        readPos_ = 0;
+        writePos_ = readable;
+    }
+
+    std::vector<uint8_t> buffer_;
+    size_t readPos_;
+    size_t writePos_;
+};
@@ -3,6 +3,7 @@
 #ifdef __linux__
 
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/socket.h>
@@ -12,9 +13,20 @@
 #include <cstring>
 #include <cerrno>
 #include <algorithm>
+#include <limits>
+#include <sys/uio.h>
+#include <poll.h>
+#include <future>
 
-LinuxEpoll::LinuxEpoll() 
-    : epollFd_(-1), initialized_(false), running_(false) {
+LinuxEpoll::LinuxEpoll(const AsyncIOOptions& options)
+    : epollFd_(-1), wakeFd_(-1), edgeTriggered_(options.edgeTriggered),
+      ioBudget_(std::max<size_t>(options.ioBudget, BUFFER_SIZE)),
+      highWatermark_(options.writeHighWatermark),
+      lowWatermark_(std::min(options.writeLowWatermark, options.writeHighWatermark)),
+      busyPollUs_(options.busyPollUs), socketBusyPollUs_(options.socketBusyPollUs), spinBudgetUs_(options.busyPollUs),
+      onThreadStart_(options.onThreadStart),
+      initialized_(false), running_(false), loopActive_(false),
+      wakeupPending_(false), activeSockets_(0) {
 }
 
 LinuxEpoll::~LinuxEpoll() {
@@ -27,14 +39,38 @@ bool LinuxEpoll::initialize() {
     }
     
     // 创建epoll实例
-    epollFd_ = epoll_create1(0);
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
     if (epollFd_ == -1) {
         LOG_ERROR("Failed to create epoll instance: {}", strerror(errno));
         return false;
     }
     
+    // 创建eventfd用于唤醒和停止事件循环
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd_ == -1) {
+        LOG_ERROR("Failed to create eventfd: {}", strerror(errno));
+        close(epollFd_);
+        epollFd_ = -1;
+        return false;
+    }
+    
+    // eventfd的data.ptr为空，用于和socket上下文区分
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = nullptr;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &ev) == -1) {
+        LOG_ERROR("Failed to add eventfd to epoll: {}", strerror(errno));
+        close(wakeFd_);
+        close(epollFd_);
+        wakeFd_ = -1;
+        epollFd_ = -1;
+        return false;
+    }
+    
     initialized_ = true;
-    LOG_INFO("Linux epoll initialized successfully, fd: {}", epollFd_);
+    spinBudgetSnapshot_ = spinBudgetUs_;
+    LOG_INFO("Linux epoll initialized successfully, fd: {}, mode: {}, I/O budget: {} bytes, busy poll: {} us",
+             epollFd_, edgeTriggered_ ? "edge-triggered" : "level-triggered", ioBudget_, busyPollUs_);
     return true;
 }
 
@@ -43,15 +79,20 @@ void LinuxEpoll::shutdown() {
         return;
     }
     
-    running_ = false;
+    stopEventLoop();
     
-    // 清理所有socket上下文
-    {
-        std::lock_guard<std::mutex> lock(contextsMutex_);
-        socketContexts_.clear();
+    // 清理所有socket上下文，事件循环已停止
+    pendingContexts_.clear();
+    closedSlots_.clear();
+    contexts_.clear();
+    activeSockets_ = 0;
+    
+    // 关闭eventfd和epoll fd
+    if (wakeFd_ != -1) {
+        close(wakeFd_);
+        wakeFd_ = -1;
     }
     
-    // 关闭epoll fd
     if (epollFd_ != -1) {
         close(epollFd_);
         epollFd_ = -1;
@@ -61,52 +102,77 @@ void LinuxEpoll::shutdown() {
     LOG_INFO("Linux epoll shutdown completed");
 }
 
+uint32_t LinuxEpoll::toEpollEvents(IOEventType events, bool listening) const {
+    uint32_t epollEvents = 0;
+    if (events & IOEventType::READ) {
+        epollEvents |= EPOLLIN;
+    }
+    if (events & IOEventType::WRITE) {
+        epollEvents |= EPOLLOUT;
+    }
+    // 监听套接字保持水平触发：上层每次事件只accept有限数量的连接
+    if (edgeTriggered_ && !listening) {
+        epollEvents |= EPOLLET;
+    }
+    return epollEvents;
+}
+
 bool LinuxEpoll::addSocket(socket_t socket, IOEventType events) {
     if (!initialized_) {
         LOG_ERROR("Epoll not initialized");
         return false;
     }
     
-    // 设置socket为非阻塞模式
-    int flags = fcntl(socket, F_GETFL, 0);
-    if (flags == -1) {
-        LOG_ERROR("Failed to get socket flags: {}", strerror(errno));
-        return false;
+    // socket由调用方以非阻塞模式创建（accept4的SOCK_NONBLOCK），这里不再调用fcntl
+    // 序号在调用线程分配，之后任何线程发起的removeSocket都能认出这次注册
+    uint64_t registration = nextRegistration_.fetch_add(1);
+    if (!inLoopThread()) {
+        postCommand([this, socket, events, registration]() { registerSocket(socket, events, registration); });
+        return true;
     }
-    
-    if (fcntl(socket, F_SETFL, flags | O_NONBLOCK) == -1) {
-        LOG_ERROR("Failed to set socket non-blocking: {}", strerror(errno));
+    return registerSocket(socket, events, registration);
+}
+
+bool LinuxEpoll::registerSocket(socket_t socket, IOEventType events, uint64_t registration) {
+    // 创建socket上下文，先保存上下文再加入epoll，保证事件到达时上下文已就绪
+    SocketContext* context = contexts_.insert(socket);
+    if (!context) {
+        // fd已被关闭并复用，而其他线程投递的移除命令尚未执行，先执行已投递的命令
+        runCommands();
+        context = contexts_.insert(socket);
+    }
+    if (!context) {
+        LOG_ERROR("Socket {} is already registered", socket);
         return false;
     }
-    
-    // 创建socket上下文
-    auto context = std::make_unique<SocketContext>();
     context->socket = socket;
+    context->slot = contexts_.slotOf(socket);
+    context->registration = registration;
     context->events = events;
     
     // 添加到epoll
     struct epoll_event ev;
-    ev.events = 0;
-    if (events & IOEventType::READ) {
-        ev.events |= EPOLLIN;
-    }
-    if (events & IOEventType::WRITE) {
-        ev.events |= EPOLLOUT;
-    }
-    ev.data.fd = socket;
+    ev.events = toEpollEvents(events);
+    ev.data.ptr = context;
     
     if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, socket, &ev) == -1) {
         LOG_ERROR("Failed to add socket to epoll: {}", strerror(errno));
+        contexts_.erase(socket);
         return false;
     }
     
-    // 保存上下文
-    {
-        std::lock_guard<std::mutex> lock(contextsMutex_);
-        socketContexts_[socket] = std::move(context);
+    activeSockets_++;
+    
+#ifdef SO_BUSY_POLL
+    // 阻塞读取时由内核直接轮询网卡队列；超过net.core.busy_read的值需要CAP_NET_ADMIN
+    if (socketBusyPollUs_ > 0 &&
+        setsockopt(socket, SOL_SOCKET, SO_BUSY_POLL, &socketBusyPollUs_, sizeof(socketBusyPollUs_)) == -1) {
+        LOG_WARN("Failed to set SO_BUSY_POLL to {} us: {}, disabling it", socketBusyPollUs_, strerror(errno));
+        socketBusyPollUs_ = 0;
     }
+#endif
     
-    LOG_INFO("Socket {} added to epoll with events: {}", socket, static_cast<int>(events));
+    LOG_DEBUG("Socket {} added to epoll with events: {}", socket, static_cast<int>(events));
     return true;
 }
 
@@ -115,86 +181,146 @@ bool LinuxEpoll::removeSocket(socket_t socket) {
         return false;
     }
     
-    // 从epoll中移除
+    // 在调用线程中直接从epoll移除（epoll_ctl是线程安全的），调用方随后关闭socket不会有事件再到达
     if (epoll_ctl(epollFd_, EPOLL_CTL_DEL, socket, nullptr) == -1) {
         LOG_ERROR("Failed to remove socket from epoll: {}", strerror(errno));
         return false;
     }
     
-    // 清理上下文
-    {
-        std::lock_guard<std::mutex> lock(contextsMutex_);
-        socketContexts_.erase(socket);
+    // 上下文由事件循环线程清理；调用方随后关闭fd，命令只移除此前已发起的注册，不会误删复用该fd的新连接
+    if (!inLoopThread()) {
+        uint64_t registeredBefore = nextRegistration_.load();
+        postCommand([this, socket, registeredBefore]() { detachSocket(socket, registeredBefore); });
+    } else {
+        detachSocket(socket);
     }
     
-    LOG_INFO("Socket {} removed from epoll", socket);
+    LOG_DEBUG("Socket {} removed from epoll", socket);
     return true;
 }
 
+void LinuxEpoll::detachSocket(socket_t socket, uint64_t registeredBefore) {
+    SocketContext* context = contexts_.find(socket);
+    if (!context || context->registration >= registeredBefore) {
+        return;
+    }
+    // 事件循环可能正持有该上下文，延迟到本轮处理结束后释放
+    uint32_t slot = contexts_.detach(socket);
+    if (slot != ConnectionTable<SocketContext>::INVALID_SLOT) {
+        contexts_.at(slot)->closed = true;
+        closedSlots_.push_back(slot);
+        activeSockets_--;
+    }
+}
+
 bool LinuxEpoll::modifySocket(socket_t socket, IOEventType events) {
     if (!initialized_) {
         return false;
     }
     
-    struct epoll_event ev;
-    ev.events = 0;
-    if (events & IOEventType::READ) {
-        ev.events |= EPOLLIN;
-    }
-    if (events & IOEventType::WRITE) {
-        ev.events |= EPOLLOUT;
-    }
-    ev.data.fd = socket;
-    
-    if (epoll_ctl(epollFd_, EPOLL_CTL_MOD, socket, &ev) == -1) {
-        LOG_ERROR("Failed to modify socket in epoll: {}", strerror(errno));
-        return false;
+    if (!inLoopThread()) {
+        postCommand([this, socket, events]() { updateEvents(socket, events); });
+        return true;
     }
-    
+    return updateEvents(socket, events);
+}
+
+bool LinuxEpoll::updateEvents(socket_t socket, IOEventType events) {
     // 更新上下文中的事件
-    {
-        std::lock_guard<std::mutex> lock(contextsMutex_);
-        auto it = socketContexts_.find(socket);
-        if (it != socketContexts_.end()) {
-            it->second->events = events;
-        }
+    SocketContext* context = contexts_.find(socket);
+    if (!context) {
+        return false;
     }
-    
-    return true;
+    context->events = events;
+    return applyEvents(context);
 }
 
 bool LinuxEpoll::asyncRead(socket_t socket, const std::string& buffer, EventCallback callback) {
     // 对于epoll，读操作通过事件触发处理
     // 这里主要是注册回调函数
-    std::lock_guard<std::mutex> lock(contextsMutex_);
-    auto it = socketContexts_.find(socket);
-    if (it != socketContexts_.end()) {
-        it->second->callback = callback;
+    (void)buffer;
+    if (!inLoopThread()) {
+        postCommand([this, socket, callback]() { setReadCallback(socket, callback); });
         return true;
     }
-    return false;
+    return setReadCallback(socket, callback);
 }
 
-bool LinuxEpoll::asyncWrite(socket_t socket, const std::string& data, EventCallback callback) {
-    // 对于epoll，写操作通过事件触发处理
-    std::lock_guard<std::mutex> lock(contextsMutex_);
-    auto it = socketContexts_.find(socket);
-    if (it != socketContexts_.end()) {
-        it->second->callback = callback;
-        it->second->writeBuffer = data;
+bool LinuxEpoll::setReadCallback(socket_t socket, EventCallback callback) {
+    SocketContext* context = contexts_.find(socket);
+    if (context) {
+        context->callback = std::move(callback);
         return true;
     }
     return false;
 }
 
+bool LinuxEpoll::asyncWrite(socket_t socket, const BufferSlice& data, EventCallback callback) {
+    // 其他线程的发送按投递顺序进入连接的发送队列
+    if (!inLoopThread()) {
+        postCommand([this, socket, data, callback]() {
+            queueWrite(socket, data, callback);
+        });
+        return true;
+    }
+    return queueWrite(socket, data, callback);
+}
+
+size_t LinuxEpoll::asyncWriteBatch(const std::vector<socket_t>& sockets, const BufferSlice& data, EventCallback callback) {
+    // 其他线程的整批发送只投递一条命令、唤醒一次事件循环
+    if (!inLoopThread()) {
+        postCommand([this, sockets, data, callback]() {
+            for (socket_t socket : sockets) {
+                queueWrite(socket, data, callback);
+            }
+        });
+        return sockets.size();
+    }
+    
+    size_t queued = 0;
+    for (socket_t socket : sockets) {
+        if (queueWrite(socket, data, callback)) {
+            ++queued;
+        }
+    }
+    return queued;
+}
+
+bool LinuxEpoll::queueWrite(socket_t socket, const BufferSlice& data, EventCallback callback) {
+    // 对于epoll，写操作通过事件触发处理：追加到发送队列，队列由空变为非空时关注EPOLLOUT
+    SocketContext* context = contexts_.find(socket);
+    if (!context) {
+        return false;
+    }
+    
+    context->queuedBytes += data.size();
+    context->writeQueue.push_back(PendingWrite{data, std::move(callback)});
+    checkWatermarks(context);
+    if (context->writeQueue.size() > 1) {
+        // 已在等待EPOLLOUT，无需重复修改epoll
+        return true;
+    }
+    return updateWriteInterest(context);
+}
+
 bool LinuxEpoll::asyncAccept(socket_t serverSocket, EventCallback callback) {
-    std::lock_guard<std::mutex> lock(contextsMutex_);
-    auto it = socketContexts_.find(serverSocket);
-    if (it != socketContexts_.end()) {
-        it->second->callback = callback;
+    if (!inLoopThread()) {
+        postCommand([this, serverSocket, callback]() { setAcceptCallback(serverSocket, callback); });
         return true;
     }
-    return false;
+    return setAcceptCallback(serverSocket, callback);
+}
+
+bool LinuxEpoll::setAcceptCallback(socket_t serverSocket, EventCallback callback) {
+    SocketContext* context = contexts_.find(serverSocket);
+    if (!context) {
+        return false;
+    }
+    context->callback = std::move(callback);
+    context->listening = true;
+    
+    // 边缘触发模式下addSocket已按普通socket注册，这里改回水平触发
+    return !edgeTriggered_ || updateEvents(serverSocket, context->events);
 }
 
 bool LinuxEpoll::startEventLoop() {
@@ -203,12 +329,25 @@ bool LinuxEpoll::startEventLoop() {
     }
     
     running_ = true;
+    loopActive_ = true;
+    loopThread_ = std::thread(&LinuxEpoll::eventLoop, this);
     LOG_INFO("Starting Linux epoll event loop");
     return true;
 }
 
 void LinuxEpoll::stopEventLoop() {
-    running_ = false;
+    if (!running_.exchange(false)) {
+        return;
+    }
+    
+    // 唤醒阻塞中的epoll_wait，使事件循环线程退出
+    wakeup();
+    if (loopThread_.joinable() && loopThread_.get_id() != std::this_thread::get_id()) {
+        loopThread_.join();
+        // 事件循环已退出，之后的调用在调用线程直接执行；补做退出前尚未执行的命令
+        loopActive_ = false;
+        runCommands();
+    }
     LOG_INFO("Stopping Linux epoll event loop");
 }
 
@@ -216,126 +355,559 @@ bool LinuxEpoll::isEventLoopRunning() const {
     return running_;
 }
 
+bool LinuxEpoll::setTickCallback(int intervalMs, TickCallback callback) {
+    if (running_ || intervalMs <= 0) {
+        return false;
+    }
+    
+    tickCallback_ = std::move(callback);
+    tickInterval_ = std::chrono::milliseconds(intervalMs);
+    return true;
+}
+
 int LinuxEpoll::getActiveConnections() const {
-    std::lock_guard<std::mutex> lock(contextsMutex_);
-    return static_cast<int>(socketContexts_.size());
+    return activeSockets_.load();
+}
+
+PollStats LinuxEpoll::getPollStats() const {
+    PollStats stats;
+    stats.spinWakeups = spinWakeups_.load(std::memory_order_relaxed);
+    stats.blockWakeups = blockWakeups_.load(std::memory_order_relaxed);
+    stats.spinMicros = spinMicros_.load(std::memory_order_relaxed);
+    stats.spinBudgetUs = spinBudgetSnapshot_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool LinuxEpoll::runInLoop(std::function<void()> task) {
+    if (!initialized_) {
+        return false;
+    }
+    if (inLoopThread()) {
+        task();
+    } else {
+        postCommand(std::move(task));
+    }
+    return true;
+}
+
+bool LinuxEpoll::releaseSocket(socket_t socket, std::string& unsent) {
+    SocketContext* context = contexts_.find(socket);
+    if (!context || context->listening) {
+        return false;
+    }
+    if (epoll_ctl(epollFd_, EPOLL_CTL_DEL, socket, nullptr) == -1) {
+        LOG_ERROR("Failed to remove socket from epoll: {}", strerror(errno));
+        return false;
+    }
+    
+    // 队首数据可能已部分发出，从writeOffset开始取
+    unsent.clear();
+    unsent.reserve(context->queuedBytes);
+    size_t offset = context->writeOffset;
+    for (const PendingWrite& write : context->writeQueue) {
+        unsent.append(reinterpret_cast<const char*>(write.data.data()) + offset, write.data.size() - offset);
+        offset = 0;
+    }
+    context->writeQueue.clear();
+    context->writeOffset = 0;
+    context->queuedBytes = 0;
+    detachSocket(socket);
+    return true;
 }
 
 bool LinuxEpoll::isSocketRegistered(socket_t socket) const {
-    std::lock_guard<std::mutex> lock(contextsMutex_);
-    return socketContexts_.find(socket) != socketContexts_.end();
+    if (inLoopThread()) {
+        return contexts_.find(socket) != nullptr;
+    }
+    
+    // 其他线程的查询交给事件循环线程执行并等待结果
+    auto result = std::make_shared<std::promise<bool>>();
+    std::future<bool> future = result->get_future();
+    const_cast<LinuxEpoll*>(this)->postCommand([this, socket, result]() {
+        result->set_value(contexts_.find(socket) != nullptr);
+    });
+    return future.get();
+}
+
+namespace {
+// 当前线程正在运行的事件循环
+thread_local const LinuxEpoll* currentLoop = nullptr;
+}
+
+bool LinuxEpoll::inLoopThread() const {
+    return currentLoop == this || !loopActive_.load(std::memory_order_acquire);
+}
+
+void LinuxEpoll::postCommand(Command command) {
+    commands_.push(std::move(command));
+    // 事件循环取走命令前只需唤醒一次
+    if (!wakeupPending_.exchange(true, std::memory_order_acq_rel)) {
+        wakeup();
+    }
+}
+
+void LinuxEpoll::runCommands() {
+    wakeupPending_.exchange(false, std::memory_order_acq_rel);
+    Command command;
+    while (commands_.pop(command)) {
+        command();
+    }
+}
+
+void LinuxEpoll::serveCommandsUntilStopped() {
+    // 线程直接退出时loopActive_仍为true，其他线程投递的命令无人执行，isSocketRegistered会一直阻塞；
+    // 留在本线程执行命令（与正常运行时相同的单消费者），stopEventLoop唤醒后退出，之后照常补做剩余命令
+    struct pollfd wakeFd;
+    wakeFd.fd = wakeFd_;
+    wakeFd.events = POLLIN;
+    while (running_) {
+        runCommands();
+        wakeFd.revents = 0;
+        if (poll(&wakeFd, 1, -1) > 0 && (wakeFd.revents & POLLIN)) {
+            uint64_t value;
+            while (read(wakeFd_, &value, sizeof(value)) == sizeof(value)) {
+            }
+        }
+    }
+}
+
+void LinuxEpoll::wakeup() {
+    uint64_t one = 1;
+    if (write(wakeFd_, &one, sizeof(one)) != sizeof(one) && errno != EAGAIN) {
+        LOG_ERROR("Failed to wake up epoll loop: {}", strerror(errno));
+    }
+}
+
+void LinuxEpoll::eventLoop() {
+    // 先绑定CPU，之后在本线程分配的事件数组和读缓冲区都在所在NUMA节点
+    if (onThreadStart_) {
+        onThreadStart_();
+    }
+    LOG_INFO("Linux epoll event loop thread started");
+    currentLoop = this;
+    
+    struct epoll_event events[MAX_EVENTS];
+    std::vector<SocketContext*> pending;
+    nextTick_ = std::chrono::steady_clock::now() + tickInterval_;
+    while (running_) {
+        // 阻塞直到有就绪事件、被eventfd唤醒或到达下次周期回调，空闲时不占用CPU
+        // 边缘触发下仍有socket未处理完时不阻塞，先收集新的就绪事件再继续处理
+        int numEvents = waitForEvents(events, computeTimeout());
+        if (numEvents == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ERROR("epoll_wait failed: {}, event loop stops handling I/O", strerror(errno));
+            serveCommandsUntilStopped();
+            break;
+        }
+        
+        // 先执行其他线程投递的命令，再处理I/O事件
+        runCommands();
+        
+        pending.clear();
+        pending.swap(pendingContexts_);
+        
+        processEvents(epollFd_, events, numEvents);
+        processPendingEvents(pending);
+        deliverWatermarkEvents();
+        runTick();
+        
+        // 释放本轮处理中被移除的socket上下文
+        pendingContexts_.erase(
+            std::remove_if(pendingContexts_.begin(), pendingContexts_.end(),
+                           [](SocketContext* context) { return context->closed; }),
+            pendingContexts_.end());
+        for (uint32_t slot : closedSlots_) {
+            contexts_.release(slot);
+        }
+        closedSlots_.clear();
+    }
+    
+    currentLoop = nullptr;
+    LOG_INFO("Linux epoll event loop thread ended");
+}
+
+int LinuxEpoll::computeTimeout() const {
+    if (!pendingContexts_.empty()) {
+        return 0;
+    }
+    if (!tickCallback_) {
+        return -1;
+    }
+    
+    auto remaining = nextTick_ - std::chrono::steady_clock::now();
+    if (remaining <= std::chrono::steady_clock::duration::zero()) {
+        return 0;
+    }
+    // 向上取整，避免提前醒来后空转一轮
+    return static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(remaining).count());
+}
+
+int LinuxEpoll::waitForEvents(struct epoll_event* events, int timeout) {
+    // 已有待处理的工作或未开启自旋时直接等待
+    if (timeout == 0 || busyPollUs_ == 0) {
+        return epoll_wait(epollFd_, events, MAX_EVENTS, timeout);
+    }
+    
+    // 自旋期间不让出CPU，省去睡眠和唤醒的上下文切换；eventfd也在epoll中，其他线程投递的命令同样能及时取到
+    auto start = std::chrono::steady_clock::now();
+    if (spinBudgetUs_ > 0) {
+        auto deadline = start + std::chrono::microseconds(spinBudgetUs_);
+        auto now = start;
+        int numEvents = 0;
+        do {
+            numEvents = epoll_wait(epollFd_, events, MAX_EVENTS, 0);
+            now = std::chrono::steady_clock::now();
+        } while (numEvents == 0 && now < deadline && running_);
+        
+        uint64_t spunUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - start).count());
+        spinMicros_.fetch_add(spunUs, std::memory_order_relaxed);
+        if (numEvents != 0) {
+            spinWakeups_.fetch_add(1, std::memory_order_relaxed);
+            adaptSpinBudget(spunUs);
+            return numEvents;
+        }
+    }
+    
+    // 自旋期间可能已到达下次周期回调，重新计算阻塞时长；自旋上限为0时仍测量阻塞等待的空闲时长
+    blockWakeups_.fetch_add(1, std::memory_order_relaxed);
+    int numEvents = epoll_wait(epollFd_, events, MAX_EVENTS, computeTimeout());
+    adaptSpinBudget(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count()));
+    return numEvents;
+}
+
+void LinuxEpoll::adaptSpinBudget(uint64_t idleUs) {
+    // 事件在配置的自旋时长内到达时恢复完整自旋，否则本次自旋白白占用CPU，自旋上限减半；
+    // 上限降为0后只靠阻塞等待测量空闲时长，负载回升时再恢复自旋
+    if (idleUs <= busyPollUs_) {
+        spinBudgetUs_ = busyPollUs_;
+    } else {
+        spinBudgetUs_ /= 2;
+    }
+    spinBudgetSnapshot_.store(spinBudgetUs_, std::memory_order_relaxed);
+}
+
+void LinuxEpoll::runTick() {
+    if (!tickCallback_) {
+        return;
+    }
+    
+    auto now = std::chrono::steady_clock::now();
+    if (now < nextTick_) {
+        return;
+    }
+    // 按固定间隔推进；落后超过一个间隔（如回调耗时过长）时从当前时间重新计算，不补做错过的回调
+    nextTick_ += tickInterval_;
+    if (nextTick_ <= now) {
+        nextTick_ = now + tickInterval_;
+    }
+    tickCallback_();
 }
 
 void LinuxEpoll::processEvents(int epollFd, struct epoll_event* events, int numEvents) {
+    (void)epollFd;
+    
     for (int i = 0; i < numEvents; ++i) {
-        socket_t fd = events[i].data.fd;
+        // 上下文地址直接取自data.ptr，上下文在本轮处理结束前不会被释放
+        SocketContext* context = static_cast<SocketContext*>(events[i].data.ptr);
         
-        // 查找对应的上下文
-        std::unique_ptr<SocketContext> context;
-        {
-            std::lock_guard<std::mutex> lock(contextsMutex_);
-            auto it = socketContexts_.find(fd);
-            if (it != socketContexts_.end()) {
-                context = std::move(it->second);
-                socketContexts_.erase(it);
+        if (!context) {
+            uint64_t value = 0;
+            while (read(wakeFd_, &value, sizeof(value)) == sizeof(value)) {
             }
+            continue;
         }
         
-        if (!context) {
+        if (context->closed) {
             continue;
         }
         
-        // 处理事件
-        if (events[i].events & (EPOLLIN | EPOLLPRI)) {
-            handleReadEvent(context.get());
+        dispatchEvents(context, events[i].events);
+    }
+}
+
+void LinuxEpoll::dispatchEvents(SocketContext* context, uint32_t events) {
+    // 读暂停期间忽略已取到的可读事件，恢复关注时EPOLL_CTL_MOD会重新检查就绪状态
+    if ((events & (EPOLLIN | EPOLLPRI)) && !context->readPaused) {
+        if (context->listening) {
+            handleAcceptEvent(context);
+        } else {
+            handleReadEvent(context);
         }
-        
-        if (events[i].events & EPOLLOUT) {
-            handleWriteEvent(context.get());
+    }
+    
+    if (!context->closed && (events & EPOLLOUT)) {
+        handleWriteEvent(context);
+    }
+    
+    if (!context->closed && (events & (EPOLLERR | EPOLLHUP))) {
+        IOEvent errorEvent{context->socket, IOEventType::IOERROR, "", context->callback};
+        if (context->callback) {
+            context->callback(errorEvent);
         }
-        
-        if (events[i].events & (EPOLLERR | EPOLLHUP)) {
-            IOEvent errorEvent{context->socket, IOEventType::IOERROR, "", nullptr};
-            if (context->callback) {
-                context->callback(errorEvent);
-            }
+    }
+}
+
+void LinuxEpoll::markPending(SocketContext* context, uint32_t events) {
+    // 边缘触发不会再次通知已就绪但未读写完的socket，由事件循环下一轮补做
+    if (context->pendingEvents == 0) {
+        pendingContexts_.push_back(context);
+    }
+    context->pendingEvents |= events;
+}
+
+void LinuxEpoll::processPendingEvents(std::vector<SocketContext*>& pending) {
+    for (SocketContext* context : pending) {
+        uint32_t events = context->pendingEvents;
+        context->pendingEvents = 0;
+        if (!context->closed && events != 0) {
+            dispatchEvents(context, events);
         }
     }
 }
 
 void LinuxEpoll::handleReadEvent(SocketContext* context) {
-    char buffer[BUFFER_SIZE];
-    ssize_t bytesRead = recv(context->socket, buffer, sizeof(buffer), 0);
+    // 水平触发每次唤醒只读一次；边缘触发读到EAGAIN或本次预算耗尽为止
+    const size_t budget = edgeTriggered_ ? ioBudget_ : BUFFER_SIZE;
+    bool drained = false;
+    bool peerClosed = false;
+    int readError = 0;
     
-    if (bytesRead > 0) {
-        context->readBuffer.append(buffer, bytesRead);
+    context->readBuffer.clear();
+    while (context->readBuffer.size() < budget) {
+        size_t offset = context->readBuffer.size();
+        context->readBuffer.resize(offset + BUFFER_SIZE);
+        ssize_t bytesRead = recv(context->socket, &context->readBuffer[offset], BUFFER_SIZE, 0);
+        
+        if (bytesRead > 0) {
+            context->readBuffer.resize(offset + bytesRead);
+            // 短读说明接收缓冲区已读空，之后到达的数据会产生新的边缘事件
+            if (!edgeTriggered_ || bytesRead < BUFFER_SIZE) {
+                drained = true;
+                break;
+            }
+            continue;
+        }
         
-        IOEvent readEvent{context->socket, IOEventType::READ, context->readBuffer, context->callback};
+        context->readBuffer.resize(offset);
+        if (bytesRead == 0) {
+            peerClosed = true;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            readError = errno;
+        }
+        drained = true;
+        break;
+    }
+    
+    if (!drained && edgeTriggered_) {
+        markPending(context, EPOLLIN);
+    }
+    
+    if (!context->readBuffer.empty()) {
+        // 只投递本次唤醒读到的数据，分帧由上层负责
+        // 读缓冲区的存储直接移交给事件切片，下次读取重新分配，上层可以不复制地引用其中的消息
+        IOEvent readEvent{context->socket, IOEventType::READ, BufferSlice(std::move(context->readBuffer)), context->callback};
         if (context->callback) {
             context->callback(readEvent);
         }
-    } else if (bytesRead == 0) {
+    }
+    
+    if (context->closed) {
+        return;
+    }
+    
+    if (peerClosed) {
         // 连接关闭
         IOEvent errorEvent{context->socket, IOEventType::IOERROR, "Connection closed", context->callback};
         if (context->callback) {
             context->callback(errorEvent);
         }
-    } else {
-        if (errno != EAGAIN && errno != EWOULDBLOCK) {
-            LOG_ERROR("Read error on socket {}: {}", context->socket, strerror(errno));
-            IOEvent errorEvent{context->socket, IOEventType::IOERROR, strerror(errno), context->callback};
-            if (context->callback) {
-                context->callback(errorEvent);
-            }
+    } else if (readError != 0) {
+        LOG_ERROR("Read error on socket {}: {}", context->socket, strerror(readError));
+        IOEvent errorEvent{context->socket, IOEventType::IOERROR, strerror(readError), context->callback};
+        if (context->callback) {
+            context->callback(errorEvent);
         }
     }
 }
 
 void LinuxEpoll::handleWriteEvent(SocketContext* context) {
-    if (context->writeBuffer.empty()) {
-        return;
+    // 水平触发每次唤醒只调用一次sendmsg；边缘触发发送到EAGAIN或本次预算耗尽为止
+    const size_t budget = edgeTriggered_ ? ioBudget_ : std::numeric_limits<size_t>::max();
+    size_t sentThisWakeup = 0;
+    int writeError = 0;
+    std::vector<PendingWrite> completed;
+    while (!context->writeQueue.empty() && sentThisWakeup < budget) {
+        ssize_t bytesSent = flushWriteQueue(context, budget - sentThisWakeup, completed);
+        if (bytesSent > 0) {
+            sentThisWakeup += bytesSent;
+            if (!edgeTriggered_) {
+                break;
+            }
+            continue;
+        }
+        
+        if (bytesSent < 0 && errno == EINTR) {
+            continue;
+        }
+        
+        if (bytesSent < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            writeError = errno;
+        }
+        break;
     }
     
-    ssize_t bytesSent = send(context->socket, context->writeBuffer.data() + context->writeOffset, 
-                           context->writeBuffer.size() - context->writeOffset, 0);
+    if (writeError == 0) {
+        checkWatermarks(context);
+        if (context->writeQueue.empty()) {
+            // 发送队列已清空，不再关注EPOLLOUT
+            updateWriteInterest(context);
+        } else if (edgeTriggered_ && sentThisWakeup >= budget) {
+            markPending(context, EPOLLOUT);
+        }
+    }
     
-    if (bytesSent > 0) {
-        context->writeOffset += bytesSent;
-        
-        if (context->writeOffset >= context->writeBuffer.size()) {
-            // 发送完成
-            IOEvent writeEvent{context->socket, IOEventType::WRITE, context->writeBuffer, context->callback};
-            if (context->callback) {
-                context->callback(writeEvent);
-            }
-            context->writeBuffer.clear();
-            context->writeOffset = 0;
+    // 发送队列已更新完毕，回调中可以继续asyncWrite
+    for (PendingWrite& write : completed) {
+        if (write.callback) {
+            IOEvent writeEvent{context->socket, IOEventType::WRITE, std::move(write.data), write.callback};
+            write.callback(writeEvent);
         }
-    } else {
-        if (errno != EAGAIN && errno != EWOULDBLOCK) {
-            LOG_ERROR("Write error on socket {}: {}", context->socket, strerror(errno));
-            IOEvent errorEvent{context->socket, IOEventType::IOERROR, strerror(errno), context->callback};
-            if (context->callback) {
-                context->callback(errorEvent);
-            }
+    }
+    
+    if (writeError != 0 && !context->closed) {
+        LOG_ERROR("Write error on socket {}: {}", context->socket, strerror(writeError));
+        IOEvent errorEvent{context->socket, IOEventType::IOERROR, strerror(writeError), context->callback};
+        if (context->callback) {
+            context->callback(errorEvent);
         }
     }
 }
 
-void LinuxEpoll::handleAcceptEvent(socket_t serverSocket) {
-    struct sockaddr_in clientAddr;
-    socklen_t addrLen = sizeof(clientAddr);
+ssize_t LinuxEpoll::flushWriteQueue(SocketContext* context, size_t maxBytes, std::vector<PendingWrite>& completed) {
+    // 把队列前部的多个缓冲区组成iovec一次提交，队首从writeOffset处继续
+    struct iovec iov[MAX_IOVECS];
+    int iovCount = 0;
+    size_t total = 0;
+    size_t offset = context->writeOffset;
+    for (auto it = context->writeQueue.begin();
+         it != context->writeQueue.end() && iovCount < MAX_IOVECS && total < maxBytes; ++it) {
+        size_t length = std::min(it->data.size() - offset, maxBytes - total);
+        iov[iovCount].iov_base = const_cast<uint8_t*>(it->data.data()) + offset;
+        iov[iovCount].iov_len = length;
+        ++iovCount;
+        total += length;
+        offset = 0;
+    }
+    
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iovCount;
+    ssize_t bytesSent = sendmsg(context->socket, &msg, MSG_NOSIGNAL);
+    if (bytesSent <= 0) {
+        return bytesSent;
+    }
     
-    socket_t clientSocket = accept(serverSocket, (struct sockaddr*)&clientAddr, &addrLen);
-    if (clientSocket >= 0) {
-        IOEvent acceptEvent{clientSocket, IOEventType::READ, "", nullptr};
-        // 这里需要通过回调处理accept事件
-        LOG_INFO("Accepted new connection from socket {}", clientSocket);
+    // 弹出已完整发送的缓冲区，部分写的缓冲区记录偏移
+    size_t remaining = static_cast<size_t>(bytesSent);
+    while (remaining > 0 && !context->writeQueue.empty()) {
+        PendingWrite& front = context->writeQueue.front();
+        size_t left = front.data.size() - context->writeOffset;
+        if (remaining < left) {
+            context->writeOffset += remaining;
+            context->queuedBytes -= remaining;
+            break;
+        }
+        remaining -= left;
+        context->writeOffset = 0;
+        context->queuedBytes -= front.data.size();
+        completed.push_back(std::move(front));
+        context->writeQueue.pop_front();
+    }
+    return bytesSent;
+}
+
+bool LinuxEpoll::updateWriteInterest(SocketContext* context) {
+    // 发送队列和EPOLLOUT关注都只在事件循环线程修改，二者始终一致
+    uint32_t events = static_cast<uint32_t>(context->events);
+    if (context->writeQueue.empty()) {
+        events &= ~static_cast<uint32_t>(IOEventType::WRITE);
     } else {
-        if (errno != EAGAIN && errno != EWOULDBLOCK) {
-            LOG_ERROR("Accept error: {}", strerror(errno));
+        events |= static_cast<uint32_t>(IOEventType::WRITE);
+    }
+    context->events = static_cast<IOEventType>(events);
+    return applyEvents(context);
+}
+
+bool LinuxEpoll::applyEvents(SocketContext* context) {
+    uint32_t events = static_cast<uint32_t>(context->events);
+    if (context->readPaused) {
+        events &= ~static_cast<uint32_t>(IOEventType::READ);
+    }
+    
+    struct epoll_event ev;
+    ev.events = toEpollEvents(static_cast<IOEventType>(events), context->listening);
+    ev.data.ptr = context;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_MOD, context->socket, &ev) == -1) {
+        LOG_ERROR("Failed to modify socket in epoll: {}", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+void LinuxEpoll::checkWatermarks(SocketContext* context) {
+    if (highWatermark_ == 0) {
+        return;
+    }
+    
+    // 高低水位之间保持当前状态，避免在单一阈值附近反复暂停和恢复
+    bool paused = context->readPaused;
+    if (!paused && context->queuedBytes >= highWatermark_) {
+        paused = true;
+    } else if (paused && context->queuedBytes <= lowWatermark_) {
+        paused = false;
+    }
+    if (paused == context->readPaused) {
+        return;
+    }
+    
+    context->readPaused = paused;
+    applyEvents(context);
+    if (!context->watermarkChanged) {
+        context->watermarkChanged = true;
+        watermarkContexts_.push_back(context);
+    }
+}
+
+void LinuxEpoll::deliverWatermarkEvents() {
+    // 同一轮内先暂停又恢复的socket不通知
+    for (size_t i = 0; i < watermarkContexts_.size(); ++i) {
+        SocketContext* context = watermarkContexts_[i];
+        context->watermarkChanged = false;
+        if (context->closed || context->readPaused == context->pauseReported) {
+            continue;
+        }
+        context->pauseReported = context->readPaused;
+        IOEventType type = context->readPaused ? IOEventType::HIGH_WATERMARK : IOEventType::LOW_WATERMARK;
+        IOEvent event{context->socket, type, "", context->callback};
+        if (context->callback) {
+            context->callback(event);
         }
     }
+    watermarkContexts_.clear();
+}
+
+void LinuxEpoll::handleAcceptEvent(SocketContext* context) {
+    // 监听套接字可读，交给上层回调执行accept
+    IOEvent acceptEvent{context->socket, IOEventType::ACCEPT, "", context->callback};
+    if (context->callback) {
+        context->callback(acceptEvent);
+    }
 }
 
 #endif // __linux__
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "SocketTypes.h"
 #include "AsyncIO.h"
+#include "ConnectionTable.h"
+#include "MpscQueue.h"
 
 #ifdef __linux__
 
@@ -14,11 +16,16 @@
 #include <netdb.h>
 #include <cstring>
 #include <cerrno>
+#include <cstdint>
+#include <deque>
+#include <chrono>
 
 // Linux epoll实现
+// 线程模型：连接状态只由事件循环线程读写，不加锁；其他线程的调用封装为命令投递到MPSC队列，
+// 由eventfd唤醒事件循环执行。事件循环未运行时调用线程直接执行
 class LinuxEpoll : public AsyncIO {
 public:
-    LinuxEpoll();
+    explicit LinuxEpoll(const AsyncIOOptions& options = AsyncIOOptions());
     ~LinuxEpoll() override;
     
     // AsyncIO 接口实现
@@ -30,41 +37,142 @@ public:
     bool modifySocket(socket_t socket, IOEventType events) override;
     
     bool asyncRead(socket_t socket, const std::string& buffer, EventCallback callback) override;
-    bool asyncWrite(socket_t socket, const std::string& data, EventCallback callback) override;
+    bool asyncWrite(socket_t socket, const BufferSlice& data, EventCallback callback) override;
+    size_t asyncWriteBatch(const std::vector<socket_t>& sockets, const BufferSlice& data, EventCallback callback) override;
     bool asyncAccept(socket_t serverSocket, EventCallback callback) override;
     
     bool startEventLoop() override;
     void stopEventLoop() override;
     bool isEventLoopRunning() const override;
+    bool setTickCallback(int intervalMs, TickCallback callback) override;
     
     int getActiveConnections() const override;
     bool isSocketRegistered(socket_t socket) const override;
+    PollStats getPollStats() const override;
+    bool runInLoop(std::function<void()> task) override;
+    bool releaseSocket(socket_t socket, std::string& unsent) override;
+    bool canReleaseSockets() const override { return true; }
     
 private:
+    // 待发送的数据，每次asyncWrite对应一项，发送完成后回调其callback
+    // 保存切片而不是副本，广播时各连接的发送队列共享同一份数据
+    struct PendingWrite {
+        BufferSlice data;
+        EventCallback callback;
+    };
+    
     struct SocketContext {
         socket_t socket;
+        uint32_t slot;                          // 在contexts_中的槽位，延迟释放时使用
+        uint64_t registration = 0;              // addSocket调用时分配的序号，区分复用同一fd的前后两次注册
         IOEventType events;
         EventCallback callback;
         std::string readBuffer;
-        std::string writeBuffer;
-        size_t readOffset;
-        size_t writeOffset;
+        std::deque<PendingWrite> writeQueue;   // 发送队列，非空时才关注EPOLLOUT
+        size_t writeOffset = 0;                 // 队首数据已发送的字节数（部分写后从此处继续）
+        size_t queuedBytes = 0;                 // 发送队列中尚未发送的字节数
+        bool readPaused = false;                // 超过高水位，已停止关注EPOLLIN
+        bool pauseReported = false;             // 已向上层投递的水位状态
+        bool watermarkChanged = false;          // 已加入watermarkContexts_等待投递
+        bool listening = false;     // 监听套接字：可读即表示有新连接
+        bool closed = false;        // 已从epoll移除，等待本轮事件处理结束后释放
+        uint32_t pendingEvents = 0; // 边缘触发下因预算耗尽而未处理完的EPOLLIN/EPOLLOUT
     };
     
+    using Command = std::function<void()>;
+    
+    // epoll_wait循环，运行在loopThread_中
+    void eventLoop();
+    void wakeup();
+    // epoll_wait的超时：有未处理完的socket时为0，设置了周期回调时为距下次回调的时间，否则无限等待
+    int computeTimeout() const;
+    void runTick();
+    // 等待就绪事件：开启自旋时先以零超时epoll_wait轮询，自旋期间没有事件再按timeout阻塞
+    int waitForEvents(struct epoll_event* events, int timeout);
+    // 按本次从开始等待到收到事件的空闲时长调整自旋上限
+    void adaptSpinBudget(uint64_t idleUs);
+    
+    // 当前线程能否直接访问连接状态：在事件循环线程中，或事件循环未运行
+    bool inLoopThread() const;
+    // 投递命令到事件循环线程执行
+    void postCommand(Command command);
+    // 执行其他线程投递的命令，仅由事件循环线程调用
+    void runCommands();
+    // epoll_wait出错后不再处理I/O，只执行投递的命令直到stopEventLoop
+    void serveCommandsUntilStopped();
+    
+    // 以下函数只在事件循环线程（或事件循环未运行时）调用
+    bool registerSocket(socket_t socket, IOEventType events, uint64_t registration);
+    // 只移除序号小于registeredBefore的注册：其他线程移除后关闭fd，命令执行前fd可能已被新连接复用
+    void detachSocket(socket_t socket, uint64_t registeredBefore = UINT64_MAX);
+    bool updateEvents(socket_t socket, IOEventType events);
+    bool setReadCallback(socket_t socket, EventCallback callback);
+    bool queueWrite(socket_t socket, const BufferSlice& data, EventCallback callback);
+    bool setAcceptCallback(socket_t serverSocket, EventCallback callback);
+    uint32_t toEpollEvents(IOEventType events, bool listening = false) const;
+    
     void processEvents(int epollFd, struct epoll_event* events, int numEvents);
+    void dispatchEvents(SocketContext* context, uint32_t events);
+    void markPending(SocketContext* context, uint32_t events);
+    void processPendingEvents(std::vector<SocketContext*>& pending);
     void handleReadEvent(SocketContext* context);
     void handleWriteEvent(SocketContext* context);
-    void handleAcceptEvent(socket_t serverSocket);
+    // 以sendmsg聚合写发送队列中的数据，返回本次发送的字节数，出错时返回-1并保留errno
+    ssize_t flushWriteQueue(SocketContext* context, size_t maxBytes, std::vector<PendingWrite>& completed);
+    // 按发送队列是否为空更新EPOLLOUT关注
+    bool updateWriteInterest(SocketContext* context);
+    // 按上下文中的事件和读暂停状态重新设置epoll关注
+    bool applyEvents(SocketContext* context);
+    // 发送队列长度变化后检查高低水位，状态改变时暂停或恢复读取
+    void checkWatermarks(SocketContext* context);
+    // 向上层投递本轮的水位变化
+    void deliverWatermarkEvents();
+    void handleAcceptEvent(SocketContext* context);
     
     static constexpr int MAX_EVENTS = 64;
     static constexpr int BUFFER_SIZE = 4096;
+    static constexpr int MAX_IOVECS = 64;       // 单次sendmsg最多聚合的缓冲区数量
     
     int epollFd_;
+    int wakeFd_;                    // eventfd，用于唤醒阻塞中的epoll_wait
+    bool edgeTriggered_;
+    size_t ioBudget_;
+    size_t highWatermark_;
+    size_t lowWatermark_;
+    uint32_t busyPollUs_;           // 配置的自旋上限，0为不自旋
+    int socketBusyPollUs_;          // 新socket的SO_BUSY_POLL，设置失败（缺少权限）后置0不再尝试
+    uint32_t spinBudgetUs_;         // 当前自旋上限，只由事件循环线程修改
+    std::function<void()> onThreadStart_;
     bool initialized_;
-    bool running_;
+    std::atomic<bool> running_;
+    std::atomic<bool> loopActive_;  // 事件循环线程存在期间为true，此时其他线程必须通过命令队列访问连接状态
+    std::thread loopThread_;
+    
+    // 周期回调，由epoll_wait超时驱动
+    TickCallback tickCallback_;
+    std::chrono::milliseconds tickInterval_{0};
+    std::chrono::steady_clock::time_point nextTick_;
+    
+    // 其他线程投递的命令
+    MpscQueue<Command> commands_;
+    std::atomic<bool> wakeupPending_;   // 已写eventfd但命令尚未被取走，合并多次唤醒
+    std::atomic<int> activeSockets_;
+    std::atomic<uint64_t> nextRegistration_{1};
+    
+    // 自旋/阻塞统计，其他线程读取
+    std::atomic<uint64_t> spinWakeups_{0};
+    std::atomic<uint64_t> blockWakeups_{0};
+    std::atomic<uint64_t> spinMicros_{0};
+    std::atomic<uint32_t> spinBudgetSnapshot_{0};
     
-    std::unordered_map<socket_t, std::unique_ptr<SocketContext>> socketContexts_;
-    mutable std::mutex contextsMutex_;
+    // 按fd索引的上下文表，上下文地址保存在epoll_event.data.ptr中，事件分发无需查表
+    ConnectionTable<SocketContext> contexts_;
+    // 已移除的上下文槽位延迟到本轮事件处理完成后释放，避免回调中移除socket导致悬空指针或槽位被新连接复用
+    std::vector<uint32_t> closedSlots_;
+    // 边缘触发下还有剩余数据的socket，下一轮以零超时epoll_wait后继续处理
+    std::vector<SocketContext*> pendingContexts_;
+    // 水位状态改变的socket，本轮事件处理结束时统一通知上层，避免在asyncWrite中重入上层回调
+    std::vector<SocketContext*> watermarkContexts_;
 };
 
 #endif // __linux__
\ No newline at end of file
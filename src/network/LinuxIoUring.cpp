@@ -0,0 +1,1029 @@
+#include "LinuxIoUring.h"
+
+#ifdef HAS_IO_URING
+
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <future>
+
+namespace {
+
+int ioUringSetup(unsigned entries, struct io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int ringFd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+int ioUringRegister(int ringFd, unsigned opcode, void* arg, unsigned nrArgs) {
+    return static_cast<int>(syscall(__NR_io_uring_register, ringFd, opcode, arg, nrArgs));
+}
+
+// 多发recv和按fd取消需要Linux 6.0+，旧内核由上层回退到epoll
+bool kernelSupportsIoUringBackend() {
+    struct utsname info;
+    int major = 0;
+    int minor = 0;
+    if (uname(&info) != 0 || sscanf(info.release, "%d.%d", &major, &minor) != 2) {
+        return false;
+    }
+    return major >= 6;
+}
+
+// 当前线程正在运行的事件循环
+thread_local const LinuxIoUring* currentRing = nullptr;
+
+} // namespace
+
+LinuxIoUring::LinuxIoUring(const AsyncIOOptions& options)
+    : highWatermark_(options.writeHighWatermark),
+      lowWatermark_(std::min(options.writeLowWatermark, options.writeHighWatermark)),
+      onThreadStart_(options.onThreadStart),
+      ringFd_(-1), wakeFd_(-1), wakeValue_(0), initialized_(false), running_(false), loopActive_(false),
+      tickInterval_{},
+      sqRing_(nullptr), sqRingSize_(0), sqHead_(nullptr), sqTail_(nullptr), sqArray_(nullptr),
+      sqMask_(0), sqEntries_(0), sqLocalTail_(0), sqes_(nullptr), sqesSize_(0),
+      cqRing_(nullptr), cqRingSize_(0), cqHead_(nullptr), cqTail_(nullptr), cqMask_(0), cqes_(nullptr),
+      bufRing_(nullptr), bufRingSize_(0), bufTail_(0),
+      wakeupPending_(false), activeSockets_(0), nextContextId_(1) {
+}
+
+LinuxIoUring::~LinuxIoUring() {
+    shutdown();
+}
+
+bool LinuxIoUring::initialize() {
+    if (initialized_) {
+        return true;
+    }
+
+    if (!kernelSupportsIoUringBackend()) {
+        LOG_WARN("io_uring backend requires Linux 6.0 or newer");
+        return false;
+    }
+
+    if (!setupRings() || !setupBufferRing()) {
+        releaseRings();
+        return false;
+    }
+
+    // 其他线程投递命令后写eventfd，事件循环中常驻的读请求随即完成；保持阻塞模式，内核对读请求改为等待可读
+    wakeFd_ = eventfd(0, EFD_CLOEXEC);
+    if (wakeFd_ == -1) {
+        LOG_ERROR("Failed to create eventfd: {}", strerror(errno));
+        releaseRings();
+        return false;
+    }
+
+    initialized_ = true;
+    LOG_INFO("Linux io_uring initialized successfully, fd: {}, sq entries: {}, buffers: {}x{}",
+             ringFd_, sqEntries_, BUFFER_COUNT, BUFFER_SIZE);
+    return true;
+}
+
+bool LinuxIoUring::setupRings() {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = CQ_ENTRIES;
+
+    ringFd_ = ioUringSetup(SQ_ENTRIES, &params);
+    if (ringFd_ < 0) {
+        LOG_ERROR("Failed to create io_uring instance: {}", strerror(errno));
+        ringFd_ = -1;
+        return false;
+    }
+
+    sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMmap) {
+        sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+    }
+
+    void* sqRing = mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ringFd_, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED) {
+        LOG_ERROR("Failed to map io_uring submission ring: {}", strerror(errno));
+        return false;
+    }
+    sqRing_ = sqRing;
+
+    if (singleMmap) {
+        cqRing_ = sqRing_;
+    } else {
+        void* cqRing = mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            ringFd_, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) {
+            LOG_ERROR("Failed to map io_uring completion ring: {}", strerror(errno));
+            return false;
+        }
+        cqRing_ = cqRing;
+    }
+
+    sqesSize_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqes = mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ringFd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        LOG_ERROR("Failed to map io_uring submission entries: {}", strerror(errno));
+        return false;
+    }
+    sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+
+    char* sq = static_cast<char*>(sqRing_);
+    sqHead_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    sqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sqEntries_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_entries);
+    sqLocalTail_ = *sqTail_;
+
+    char* cq = static_cast<char*>(cqRing_);
+    cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+    completions_.reserve(params.cq_entries);
+
+    return true;
+}
+
+bool LinuxIoUring::setupBufferRing() {
+    bufRingSize_ = BUFFER_COUNT * sizeof(struct io_uring_buf);
+    void* ring = mmap(nullptr, bufRingSize_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ring == MAP_FAILED) {
+        LOG_ERROR("Failed to allocate io_uring buffer ring: {}", strerror(errno));
+        return false;
+    }
+    bufRing_ = static_cast<struct io_uring_buf*>(ring);
+    bufferPool_.reset(new char[static_cast<size_t>(BUFFER_COUNT) * BUFFER_SIZE]);
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uint64_t>(bufRing_);
+    reg.ring_entries = BUFFER_COUNT;
+    reg.bgid = BUFFER_GROUP;
+    if (ioUringRegister(ringFd_, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        LOG_ERROR("Failed to register io_uring buffer ring: {}", strerror(errno));
+        return false;
+    }
+
+    bufTail_ = 0;
+    for (unsigned i = 0; i < BUFFER_COUNT; ++i) {
+        recycleBuffer(static_cast<uint16_t>(i));
+    }
+    return true;
+}
+
+void LinuxIoUring::releaseRings() {
+    // 关闭ring fd会取消所有在途操作
+    if (ringFd_ != -1) {
+        close(ringFd_);
+        ringFd_ = -1;
+    }
+    if (wakeFd_ != -1) {
+        close(wakeFd_);
+        wakeFd_ = -1;
+    }
+
+    if (bufRing_) {
+        munmap(bufRing_, bufRingSize_);
+        bufRing_ = nullptr;
+    }
+    bufferPool_.reset();
+
+    if (sqes_) {
+        munmap(sqes_, sqesSize_);
+        sqes_ = nullptr;
+    }
+
+    if (cqRing_ && cqRing_ != sqRing_) {
+        munmap(cqRing_, cqRingSize_);
+    }
+    cqRing_ = nullptr;
+
+    if (sqRing_) {
+        munmap(sqRing_, sqRingSize_);
+        sqRing_ = nullptr;
+    }
+}
+
+void LinuxIoUring::shutdown() {
+    if (!initialized_) {
+        return;
+    }
+
+    stopEventLoop();
+    releaseRings();
+
+    // 事件循环已退出，直接清理所有socket上下文
+    contexts_.clear();
+    socketIds_.clear();
+    activeSockets_ = 0;
+
+    initialized_ = false;
+    LOG_INFO("Linux io_uring shutdown completed");
+}
+
+struct io_uring_sqe* LinuxIoUring::getSqe(unsigned reserve) {
+    // 空间不足时先把已填写的SQE提交给内核
+    unsigned head = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+    if (sqLocalTail_ + reserve - head > sqEntries_) {
+        submitPending(true);
+        head = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+        if (sqLocalTail_ + reserve - head > sqEntries_) {
+            LOG_ERROR("io_uring submission queue is full");
+            return nullptr;
+        }
+    }
+
+    unsigned index = sqLocalTail_ & sqMask_;
+    struct io_uring_sqe* sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqArray_[index] = index;
+    ++sqLocalTail_;
+    return sqe;
+}
+
+void LinuxIoUring::submitPending(bool force) {
+    __atomic_store_n(sqTail_, sqLocalTail_, __ATOMIC_RELEASE);
+
+    // 事件循环线程在下一次io_uring_enter时统一提交，事件循环未运行时需要立即提交
+    if (!force && currentRing == this) {
+        return;
+    }
+
+    unsigned pending = sqLocalTail_ - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+    if (pending > 0 && ioUringEnter(ringFd_, pending, 0, 0) < 0 && errno != EBUSY && errno != EAGAIN) {
+        LOG_ERROR("Failed to submit io_uring requests: {}", strerror(errno));
+    }
+}
+
+void LinuxIoUring::armMultishot(SocketContext* context) {
+    struct io_uring_sqe* sqe = getSqe();
+    if (!sqe) {
+        return;
+    }
+
+    sqe->fd = context->socket;
+    if (context->listening) {
+        // 多发accept：一次提交持续产生新连接，新fd直接为非阻塞
+        sqe->opcode = IORING_OP_ACCEPT;
+        sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+        sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+        sqe->user_data = makeUserData(context->id, OP_ACCEPT);
+    } else {
+        // 多发recv：数据到达时由内核从buffer ring中挑选缓冲区
+        sqe->opcode = IORING_OP_RECV;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = BUFFER_GROUP;
+        sqe->user_data = makeUserData(context->id, OP_RECV);
+    }
+
+    context->multishotArmed = true;
+    submitPending();
+}
+
+void LinuxIoUring::submitSends(SocketContext* context) {
+    size_t count = std::min(context->sendQueue.size(), MAX_LINKED_SENDS);
+    struct io_uring_sqe* previous = nullptr;
+
+    for (size_t i = 0; i < count; ++i) {
+        struct io_uring_sqe* sqe = getSqe(i == 0 ? static_cast<unsigned>(count) : 1);
+        if (!sqe) {
+            break;
+        }
+
+        // MSG_WAITALL让内核对流式socket的短写自动重试，链上后续send只在前一个完整发送后执行
+        PendingSend& pending = context->sendQueue[i];
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = context->socket;
+        sqe->addr = reinterpret_cast<uint64_t>(pending.data.data() + pending.offset);
+        sqe->len = static_cast<uint32_t>(pending.data.size() - pending.offset);
+        sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+        sqe->user_data = makeUserData(context->id, OP_SEND);
+        if (previous) {
+            previous->flags |= IOSQE_IO_LINK;
+        }
+        previous = sqe;
+        context->sendsInFlight++;
+    }
+}
+
+void LinuxIoUring::cancelOperation(uint64_t userData) {
+    struct io_uring_sqe* sqe = getSqe();
+    if (!sqe) {
+        return;
+    }
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->addr = userData;
+    sqe->user_data = makeUserData(0, OP_CANCEL);
+    submitPending();
+}
+
+void LinuxIoUring::cancelContext(SocketContext* context) {
+    // 按user_data匹配：多发读只有一个请求，发送链上的所有send共用同一个user_data
+    uint64_t targets[] = {
+        makeUserData(context->id, context->listening ? OP_ACCEPT : OP_RECV),
+        makeUserData(context->id, OP_SEND)
+    };
+    for (uint64_t userData : targets) {
+        struct io_uring_sqe* sqe = getSqe();
+        if (!sqe) {
+            return;
+        }
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->addr = userData;
+        sqe->cancel_flags = IORING_ASYNC_CANCEL_ALL;
+        sqe->user_data = makeUserData(0, OP_CANCEL);
+    }
+    submitPending();
+}
+
+void LinuxIoUring::armTickTimer() {
+    struct io_uring_sqe* sqe = getSqe();
+    if (!sqe) {
+        return;
+    }
+
+    // 纯超时请求（不等待其他完成事件），内核在提交时读取timespec
+    sqe->opcode = IORING_OP_TIMEOUT;
+    sqe->fd = -1;
+    sqe->addr = reinterpret_cast<uint64_t>(&tickInterval_);
+    sqe->len = 1;
+    sqe->off = 0;
+    sqe->user_data = makeUserData(0, OP_TICK);
+    submitPending();
+}
+
+void LinuxIoUring::armWakeup() {
+    struct io_uring_sqe* sqe = getSqe();
+    if (!sqe) {
+        LOG_ERROR("Failed to arm io_uring wakeup read");
+        return;
+    }
+
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = wakeFd_;
+    sqe->addr = reinterpret_cast<uint64_t>(&wakeValue_);
+    sqe->len = sizeof(wakeValue_);
+    sqe->off = static_cast<uint64_t>(-1);   // eventfd不支持定位读，使用当前位置
+    sqe->user_data = makeUserData(0, OP_WAKEUP);
+    submitPending();
+}
+
+void LinuxIoUring::releaseIfDrained(SocketContext* context) {
+    if (context->closed && context->sendsInFlight == 0 && !context->multishotArmed) {
+        contexts_.erase(context->id);
+    }
+}
+
+LinuxIoUring::SocketContext* LinuxIoUring::findContext(uint64_t id) {
+    auto it = contexts_.find(id);
+    return it != contexts_.end() ? it->second.get() : nullptr;
+}
+
+LinuxIoUring::SocketContext* LinuxIoUring::findSocket(socket_t socket) {
+    auto it = socketIds_.find(socket);
+    return it != socketIds_.end() ? findContext(it->second) : nullptr;
+}
+
+bool LinuxIoUring::inLoopThread() const {
+    return currentRing == this || !loopActive_.load(std::memory_order_acquire);
+}
+
+void LinuxIoUring::postCommand(Command command) {
+    commands_.push(std::move(command));
+    // 事件循环取走命令前只需唤醒一次
+    if (!wakeupPending_.exchange(true, std::memory_order_acq_rel)) {
+        wakeup();
+    }
+}
+
+void LinuxIoUring::runCommands() {
+    wakeupPending_.exchange(false, std::memory_order_acq_rel);
+    Command command;
+    while (commands_.pop(command)) {
+        command();
+    }
+}
+
+void LinuxIoUring::wakeup() {
+    uint64_t one = 1;
+    if (write(wakeFd_, &one, sizeof(one)) != sizeof(one) && errno != EAGAIN) {
+        LOG_ERROR("Failed to wake up io_uring loop: {}", strerror(errno));
+    }
+}
+
+bool LinuxIoUring::addSocket(socket_t socket, IOEventType events) {
+    if (!initialized_) {
+        LOG_ERROR("io_uring not initialized");
+        return false;
+    }
+
+    // ID在调用线程分配，之后任何线程发起的removeSocket都能认出这次注册
+    uint64_t id = nextContextId_.fetch_add(1);
+    if (!inLoopThread()) {
+        postCommand([this, socket, events, id]() { registerSocket(socket, events, id); });
+        return true;
+    }
+    return registerSocket(socket, events, id);
+}
+
+bool LinuxIoUring::registerSocket(socket_t socket, IOEventType events, uint64_t id) {
+    if (socketIds_.find(socket) != socketIds_.end()) {
+        // fd已被关闭并复用，而其他线程投递的移除命令尚未执行，先执行已投递的命令
+        runCommands();
+        if (socketIds_.find(socket) != socketIds_.end()) {
+            LOG_ERROR("Socket {} already registered with io_uring", socket);
+            return false;
+        }
+    }
+
+    // 读操作在设置回调(asyncRead/asyncAccept)后才提交
+    auto context = std::make_unique<SocketContext>();
+    context->id = id;
+    context->socket = socket;
+    context->events = events;
+
+    socketIds_[socket] = context->id;
+    contexts_[context->id] = std::move(context);
+    activeSockets_++;
+
+    LOG_DEBUG("Socket {} added to io_uring with events: {}", socket, static_cast<int>(events));
+    return true;
+}
+
+bool LinuxIoUring::removeSocket(socket_t socket) {
+    if (!initialized_) {
+        return false;
+    }
+
+    // 取消按上下文ID进行，调用方可以在命令执行前关闭socket；
+    // 命令只移除此前已发起的注册，不会误删复用该fd的新连接
+    if (!inLoopThread()) {
+        uint64_t registeredBefore = nextContextId_.load();
+        postCommand([this, socket, registeredBefore]() { detachSocket(socket, registeredBefore); });
+    } else {
+        detachSocket(socket);
+    }
+
+    LOG_DEBUG("Socket {} removed from io_uring", socket);
+    return true;
+}
+
+void LinuxIoUring::detachSocket(socket_t socket, uint64_t registeredBefore) {
+    SocketContext* context = findSocket(socket);
+    if (!context || context->id >= registeredBefore) {
+        return;
+    }
+    socketIds_.erase(socket);
+    context->closed = true;
+    activeSockets_--;
+
+    // 取消该socket上所有在途操作，上下文在全部完成后释放（内核可能仍在读取待发送数据）
+    if (context->multishotArmed || context->sendsInFlight > 0) {
+        cancelContext(context);
+    }
+    releaseIfDrained(context);
+}
+
+bool LinuxIoUring::modifySocket(socket_t socket, IOEventType events) {
+    if (!initialized_) {
+        return false;
+    }
+
+    if (!inLoopThread()) {
+        postCommand([this, socket, events]() { updateEvents(socket, events); });
+        return true;
+    }
+    return updateEvents(socket, events);
+}
+
+bool LinuxIoUring::updateEvents(socket_t socket, IOEventType events) {
+    SocketContext* context = findSocket(socket);
+    if (!context) {
+        return false;
+    }
+    context->events = events;
+
+    // 写操作由asyncWrite直接提交，这里只需处理读的开启和关闭
+    bool wantRead = (events & IOEventType::READ) && !context->readPaused;
+    if (wantRead && !context->multishotArmed && context->callback) {
+        armMultishot(context);
+    } else if (!wantRead && context->multishotArmed) {
+        cancelOperation(makeUserData(context->id, context->listening ? OP_ACCEPT : OP_RECV));
+    }
+    return true;
+}
+
+bool LinuxIoUring::asyncRead(socket_t socket, const std::string& buffer, EventCallback callback) {
+    (void)buffer;
+    if (!inLoopThread()) {
+        postCommand([this, socket, callback]() { setReadCallback(socket, callback); });
+        return true;
+    }
+    return setReadCallback(socket, callback);
+}
+
+bool LinuxIoUring::setReadCallback(socket_t socket, EventCallback callback) {
+    SocketContext* context = findSocket(socket);
+    if (!context) {
+        return false;
+    }
+
+    context->callback = std::move(callback);
+    if ((context->events & IOEventType::READ) && !context->readPaused && !context->multishotArmed) {
+        armMultishot(context);
+    }
+    return true;
+}
+
+bool LinuxIoUring::asyncWrite(socket_t socket, const BufferSlice& data, EventCallback callback) {
+    // 其他线程的发送按投递顺序进入连接的发送队列
+    if (!inLoopThread()) {
+        postCommand([this, socket, data, callback]() {
+            queueWrite(socket, data, callback);
+        });
+        return true;
+    }
+    bool queued = queueWrite(socket, data, std::move(callback));
+    submitPending();
+    return queued;
+}
+
+size_t LinuxIoUring::asyncWriteBatch(const std::vector<socket_t>& sockets, const BufferSlice& data, EventCallback callback) {
+    // 其他线程的整批发送只投递一条命令、唤醒一次事件循环，所有SQE在下一次io_uring_enter中一起提交
+    if (!inLoopThread()) {
+        postCommand([this, sockets, data, callback]() {
+            for (socket_t socket : sockets) {
+                queueWrite(socket, data, callback);
+            }
+        });
+        return sockets.size();
+    }
+
+    size_t queued = 0;
+    for (socket_t socket : sockets) {
+        if (queueWrite(socket, data, callback)) {
+            ++queued;
+        }
+    }
+    submitPending();
+    return queued;
+}
+
+bool LinuxIoUring::queueWrite(socket_t socket, const BufferSlice& data, EventCallback callback) {
+    SocketContext* context = findSocket(socket);
+    if (!context) {
+        return false;
+    }
+    enqueueSend(context, data, std::move(callback));
+    return true;
+}
+
+void LinuxIoUring::enqueueSend(SocketContext* context, const BufferSlice& data, EventCallback callback) {
+    // 前一条链完成前新数据只入队，链完成后再一并提交，保证发送顺序
+    context->sendQueue.push_back(PendingSend{data, 0, std::move(callback)});
+    context->queuedBytes += data.size();
+    if (context->sendsInFlight == 0 && !context->sendFailed) {
+        submitSends(context);
+    }
+
+    // 经NOP完成事件在下一轮通知上层，避免在asyncWrite中重入上层回调
+    if (checkWatermarks(context)) {
+        struct io_uring_sqe* sqe = getSqe();
+        if (sqe) {
+            sqe->opcode = IORING_OP_NOP;
+            sqe->user_data = makeUserData(context->id, OP_WATERMARK);
+        }
+    }
+}
+
+bool LinuxIoUring::checkWatermarks(SocketContext* context) {
+    if (highWatermark_ == 0) {
+        return false;
+    }
+
+    // 高低水位之间保持当前状态，避免在单一阈值附近反复暂停和恢复
+    if (!context->readPaused && context->queuedBytes >= highWatermark_) {
+        context->readPaused = true;
+        if (context->multishotArmed) {
+            cancelOperation(makeUserData(context->id, OP_RECV));
+        }
+        return true;
+    }
+    if (context->readPaused && context->queuedBytes <= lowWatermark_) {
+        context->readPaused = false;
+        if ((context->events & IOEventType::READ) && !context->multishotArmed && context->callback) {
+            armMultishot(context);
+        }
+        return true;
+    }
+    return false;
+}
+
+bool LinuxIoUring::asyncAccept(socket_t serverSocket, EventCallback callback) {
+    if (!inLoopThread()) {
+        postCommand([this, serverSocket, callback]() { setAcceptCallback(serverSocket, callback); });
+        return true;
+    }
+    return setAcceptCallback(serverSocket, callback);
+}
+
+bool LinuxIoUring::setAcceptCallback(socket_t serverSocket, EventCallback callback) {
+    SocketContext* context = findSocket(serverSocket);
+    if (!context) {
+        return false;
+    }
+
+    context->callback = std::move(callback);
+    context->listening = true;
+    if (!context->multishotArmed) {
+        armMultishot(context);
+    }
+    return true;
+}
+
+bool LinuxIoUring::startEventLoop() {
+    if (!initialized_ || running_) {
+        return false;
+    }
+
+    running_ = true;
+    loopActive_ = true;
+    loopThread_ = std::thread(&LinuxIoUring::eventLoop, this);
+    LOG_INFO("Starting Linux io_uring event loop");
+    return true;
+}
+
+void LinuxIoUring::stopEventLoop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    // 写eventfd唤醒阻塞在io_uring_enter中的事件循环线程
+    wakeup();
+    if (loopThread_.joinable() && loopThread_.get_id() != std::this_thread::get_id()) {
+        loopThread_.join();
+        // 事件循环已退出，之后的调用在调用线程直接执行；补做退出前尚未执行的命令
+        loopActive_ = false;
+        runCommands();
+    }
+    LOG_INFO("Stopping Linux io_uring event loop");
+}
+
+bool LinuxIoUring::isEventLoopRunning() const {
+    return running_;
+}
+
+bool LinuxIoUring::setTickCallback(int intervalMs, TickCallback callback) {
+    if (running_ || intervalMs <= 0) {
+        return false;
+    }
+
+    tickCallback_ = std::move(callback);
+    tickInterval_.tv_sec = intervalMs / 1000;
+    tickInterval_.tv_nsec = static_cast<long long>(intervalMs % 1000) * 1000000;
+    return true;
+}
+
+int LinuxIoUring::getActiveConnections() const {
+    return activeSockets_.load();
+}
+
+bool LinuxIoUring::isSocketRegistered(socket_t socket) const {
+    if (inLoopThread()) {
+        return socketIds_.find(socket) != socketIds_.end();
+    }
+
+    // 其他线程的查询交给事件循环线程执行并等待结果
+    auto result = std::make_shared<std::promise<bool>>();
+    std::future<bool> future = result->get_future();
+    const_cast<LinuxIoUring*>(this)->postCommand([this, socket, result]() {
+        result->set_value(socketIds_.find(socket) != socketIds_.end());
+    });
+    return future.get();
+}
+
+bool LinuxIoUring::runInLoop(std::function<void()> task) {
+    if (!initialized_) {
+        return false;
+    }
+    if (inLoopThread()) {
+        task();
+    } else {
+        postCommand(std::move(task));
+    }
+    return true;
+}
+
+void LinuxIoUring::eventLoop() {
+    if (onThreadStart_) {
+        onThreadStart_();
+    }
+    LOG_INFO("Linux io_uring event loop thread started");
+    currentRing = this;
+
+    armWakeup();
+    if (tickCallback_) {
+        armTickTimer();
+    }
+
+    while (running_) {
+        // 先执行其他线程投递的命令，命令产生的请求与上一轮回调中产生的请求一起提交
+        runCommands();
+        __atomic_store_n(sqTail_, sqLocalTail_, __ATOMIC_RELEASE);
+        unsigned toSubmit = sqLocalTail_ - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+
+        // 一次系统调用提交请求，并阻塞等待至少一个完成事件
+        int ret = ioUringEnter(ringFd_, toSubmit, 1, IORING_ENTER_GETEVENTS);
+        if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            LOG_ERROR("io_uring_enter failed: {}, event loop stops handling I/O", strerror(errno));
+            serveCommandsUntilStopped();
+            break;
+        }
+
+        processCompletions();
+    }
+
+    currentRing = nullptr;
+    LOG_INFO("Linux io_uring event loop thread ended");
+}
+
+void LinuxIoUring::serveCommandsUntilStopped() {
+    // 与LinuxEpoll相同：留在本线程执行命令，避免跨线程调用一直排队；
+    // eventfd改为非阻塞后直接读取清零，环上挂着的读请求已无人收取
+    fcntl(wakeFd_, F_SETFL, fcntl(wakeFd_, F_GETFL) | O_NONBLOCK);
+    struct pollfd wakeFd;
+    wakeFd.fd = wakeFd_;
+    wakeFd.events = POLLIN;
+    while (running_) {
+        runCommands();
+        wakeFd.revents = 0;
+        if (poll(&wakeFd, 1, -1) > 0 && (wakeFd.revents & POLLIN)) {
+            uint64_t value;
+            while (read(wakeFd_, &value, sizeof(value)) == sizeof(value)) {
+            }
+        }
+    }
+}
+
+void LinuxIoUring::processCompletions() {
+    unsigned head = *cqHead_;
+    unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+    if (head == tail) {
+        return;
+    }
+
+    completions_.clear();
+    while (head != tail) {
+        completions_.push_back(cqes_[head & cqMask_]);
+        ++head;
+    }
+    // 复制后立即归还CQ空间，回调执行期间内核可以继续投递完成事件
+    __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+
+    for (const struct io_uring_cqe& cqe : completions_) {
+        switch (static_cast<OpType>(cqe.user_data & 0xff)) {
+            case OP_WAKEUP:
+                handleWakeupCompletion();
+                break;
+            case OP_ACCEPT:
+                handleAcceptCompletion(cqe);
+                break;
+            case OP_RECV:
+                handleRecvCompletion(cqe);
+                break;
+            case OP_SEND:
+                handleSendCompletion(cqe);
+                break;
+            case OP_TICK:
+                handleTickCompletion();
+                break;
+            case OP_WATERMARK:
+                handleWatermarkCompletion(cqe);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void LinuxIoUring::handleWakeupCompletion() {
+    // 命令在下一轮循环开始时执行，这里只需重新提交读请求
+    if (running_) {
+        armWakeup();
+    }
+}
+
+void LinuxIoUring::handleAcceptCompletion(const struct io_uring_cqe& cqe) {
+    SocketContext* context = findContext(cqe.user_data >> 8);
+    if (!context) {
+        if (cqe.res >= 0) {
+            close(cqe.res);
+        }
+        return;
+    }
+
+    if (!(cqe.flags & IORING_CQE_F_MORE)) {
+        context->multishotArmed = false;
+    }
+
+    if (context->closed) {
+        if (cqe.res >= 0) {
+            close(cqe.res);
+        }
+        releaseIfDrained(context);
+        return;
+    }
+
+    // 多发accept被内核终止时重新提交，参数错误时不再重试
+    if (!context->multishotArmed && (context->events & IOEventType::READ) &&
+        cqe.res != -EINVAL && cqe.res != -EBADF) {
+        armMultishot(context);
+    }
+
+    // 回调中可能移除该socket，先取出需要的字段
+    EventCallback callback = context->callback;
+    socket_t listenSocket = context->socket;
+
+    if (cqe.res < 0) {
+        if (cqe.res != -ECANCELED) {
+            LOG_ERROR("Accept failed on socket {}: {}", listenSocket, strerror(-cqe.res));
+        }
+        return;
+    }
+
+    if (!callback) {
+        close(cqe.res);
+        return;
+    }
+
+    // 连接已由内核接受，上层直接使用acceptedSocket而无需再调用accept
+    IOEvent acceptEvent{listenSocket, IOEventType::ACCEPT, "", callback};
+    acceptEvent.acceptedSocket = cqe.res;
+    callback(acceptEvent);
+}
+
+void LinuxIoUring::handleRecvCompletion(const struct io_uring_cqe& cqe) {
+    bool hasBuffer = (cqe.flags & IORING_CQE_F_BUFFER) != 0;
+    uint16_t bufferId = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+
+    SocketContext* context = findContext(cqe.user_data >> 8);
+    if (!context || context->closed) {
+        if (hasBuffer) {
+            recycleBuffer(bufferId);
+        }
+        if (context) {
+            if (!(cqe.flags & IORING_CQE_F_MORE)) {
+                context->multishotArmed = false;
+            }
+            releaseIfDrained(context);
+        }
+        return;
+    }
+
+    if (!(cqe.flags & IORING_CQE_F_MORE)) {
+        context->multishotArmed = false;
+    }
+
+    IOEvent event;
+    bool deliver = false;
+    bool failed = false;
+    if (cqe.res > 0 && hasBuffer) {
+        // provided buffer需尽快归还给内核，复制一次到独立的切片后立即归还，分帧由上层负责
+        const char* data = bufferPool_.get() + static_cast<size_t>(bufferId) * BUFFER_SIZE;
+        event = IOEvent{context->socket, IOEventType::READ, BufferSlice::copyFrom(data, cqe.res), context->callback};
+        deliver = true;
+    } else if (cqe.res == 0) {
+        // 连接关闭
+        event = IOEvent{context->socket, IOEventType::IOERROR, "Connection closed", context->callback};
+        deliver = true;
+        failed = true;
+    } else if (cqe.res < 0 && cqe.res != -ECANCELED && cqe.res != -ENOBUFS) {
+        LOG_ERROR("Read error on socket {}: {}", context->socket, strerror(-cqe.res));
+        event = IOEvent{context->socket, IOEventType::IOERROR, strerror(-cqe.res), context->callback};
+        deliver = true;
+        failed = true;
+    }
+
+    if (hasBuffer) {
+        recycleBuffer(bufferId);
+    }
+
+    // 多发recv被内核终止（缓冲区暂时耗尽、被取消后又重新开启读）时重新提交
+    if (!failed && !context->multishotArmed && !context->readPaused && (context->events & IOEventType::READ)) {
+        armMultishot(context);
+    }
+
+    // 回调中可能移除该socket，回调之后不再访问context
+    if (deliver && event.callback) {
+        event.callback(event);
+    }
+}
+
+void LinuxIoUring::handleSendCompletion(const struct io_uring_cqe& cqe) {
+    SocketContext* context = findContext(cqe.user_data >> 8);
+    if (!context) {
+        return;
+    }
+
+    if (context->sendsInFlight > 0) {
+        context->sendsInFlight--;
+    }
+
+    if (context->closed) {
+        releaseIfDrained(context);
+        return;
+    }
+
+    IOEvent event;
+    bool deliver = false;
+    IOEvent resumeEvent;
+    if (cqe.res > 0 && !context->sendQueue.empty()) {
+        PendingSend& front = context->sendQueue.front();
+        front.offset += static_cast<size_t>(cqe.res);
+        context->queuedBytes -= std::min(context->queuedBytes, static_cast<size_t>(cqe.res));
+        // 已在事件循环线程中，恢复读取后直接通知
+        if (checkWatermarks(context) && context->pauseReported) {
+            context->pauseReported = false;
+            resumeEvent = IOEvent{context->socket, IOEventType::LOW_WATERMARK, "", context->callback};
+        }
+        if (front.offset >= front.data.size()) {
+            event = IOEvent{context->socket, IOEventType::WRITE, std::move(front.data), front.callback};
+            deliver = true;
+            context->sendQueue.pop_front();
+        }
+        // 被信号打断的短写会使链上后续send以-ECANCELED结束，整条链完成后从剩余位置重新提交
+    } else if (cqe.res < 0 && cqe.res != -ECANCELED && cqe.res != -EINTR && cqe.res != -EAGAIN &&
+               !context->sendFailed) {
+        LOG_ERROR("Write error on socket {}: {}", context->socket, strerror(-cqe.res));
+        context->sendFailed = true;
+        event = IOEvent{context->socket, IOEventType::IOERROR, strerror(-cqe.res), context->callback};
+        deliver = true;
+    }
+
+    if (context->sendsInFlight == 0) {
+        if (context->sendFailed) {
+            context->sendQueue.clear();
+        } else if (!context->sendQueue.empty()) {
+            submitSends(context);
+        }
+    }
+
+    if (deliver && event.callback) {
+        event.callback(event);
+    }
+    if (resumeEvent.callback) {
+        resumeEvent.callback(resumeEvent);
+    }
+}
+
+void LinuxIoUring::handleWatermarkCompletion(const struct io_uring_cqe& cqe) {
+    SocketContext* context = findContext(cqe.user_data >> 8);
+    // 通知前状态可能已经恢复，只投递与上次通知不同的当前状态
+    if (!context || context->closed || context->readPaused == context->pauseReported) {
+        return;
+    }
+    context->pauseReported = context->readPaused;
+    IOEventType type = context->readPaused ? IOEventType::HIGH_WATERMARK : IOEventType::LOW_WATERMARK;
+    IOEvent event{context->socket, type, "", context->callback};
+
+    if (event.callback) {
+        event.callback(event);
+    }
+}
+
+void LinuxIoUring::handleTickCompletion() {
+    if (!running_) {
+        return;
+    }
+
+    // 先重新提交再回调，回调耗时不影响下次触发的间隔
+    armTickTimer();
+    tickCallback_();
+}
+
+void LinuxIoUring::recycleBuffer(uint16_t bufferId) {
+    struct io_uring_buf* buf = &bufRing_[bufTail_ & (BUFFER_COUNT - 1)];
+    buf->addr = reinterpret_cast<uint64_t>(bufferPool_.get() + static_cast<size_t>(bufferId) * BUFFER_SIZE);
+    buf->len = BUFFER_SIZE;
+    buf->bid = bufferId;
+    ++bufTail_;
+    __atomic_store_n(&bufRing_[0].resv, bufTail_, __ATOMIC_RELEASE);
+}
+
+#endif // HAS_IO_URING
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "SocketTypes.h"
+#include "AsyncIO.h"
+#include "MpscQueue.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define HAS_IO_URING 1
+#endif
+#endif
+
+#ifdef HAS_IO_URING
+
+#include <linux/io_uring.h>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+
+// Linux io_uring实现（需要Linux 6.0+）
+// 监听套接字使用多发accept，客户端使用基于provided buffer ring的多发recv，
+// 同一socket的多个发送以IOSQE_IO_LINK链接保证顺序
+// 线程模型与LinuxEpoll相同：提交队列和socket上下文只由事件循环线程访问，不加锁；其他线程的调用
+// 封装为命令投递到MPSC队列，写eventfd唤醒事件循环（ring中常驻一个对eventfd的读请求）。
+// 事件循环未运行时调用线程直接执行
+class LinuxIoUring : public AsyncIO {
+public:
+    explicit LinuxIoUring(const AsyncIOOptions& options = AsyncIOOptions());
+    ~LinuxIoUring() override;
+
+    // AsyncIO 接口实现
+    bool initialize() override;
+    void shutdown() override;
+
+    bool addSocket(socket_t socket, IOEventType events) override;
+    bool removeSocket(socket_t socket) override;
+    bool modifySocket(socket_t socket, IOEventType events) override;
+
+    bool asyncRead(socket_t socket, const std::string& buffer, EventCallback callback) override;
+    bool asyncWrite(socket_t socket, const BufferSlice& data, EventCallback callback) override;
+    size_t asyncWriteBatch(const std::vector<socket_t>& sockets, const BufferSlice& data, EventCallback callback) override;
+    bool asyncAccept(socket_t serverSocket, EventCallback callback) override;
+
+    bool startEventLoop() override;
+    void stopEventLoop() override;
+    bool isEventLoopRunning() const override;
+    bool setTickCallback(int intervalMs, TickCallback callback) override;
+
+    int getActiveConnections() const override;
+    bool isSocketRegistered(socket_t socket) const override;
+    bool runInLoop(std::function<void()> task) override;
+
+private:
+    // user_data低8位为操作类型，高位为socket上下文ID（fd会被复用，ID不会）
+    enum OpType : uint64_t {
+        OP_WAKEUP = 1,          // eventfd可读：其他线程投递了命令
+        OP_ACCEPT = 2,
+        OP_RECV = 3,
+        OP_SEND = 4,
+        OP_CANCEL = 5,
+        OP_TICK = 6,
+        OP_WATERMARK = 7        // NOP，asyncWrite中发生的水位变化在下一轮完成事件中通知，避免重入上层回调
+    };
+
+    // 保存切片而不是副本，广播时各连接的发送队列共享同一份数据
+    struct PendingSend {
+        BufferSlice data;
+        size_t offset = 0;
+        EventCallback callback;
+    };
+
+    struct SocketContext {
+        uint64_t id;
+        socket_t socket;
+        IOEventType events;
+        EventCallback callback;
+        std::deque<PendingSend> sendQueue;  // 内核正在发送的数据必须保持有效直到完成
+        size_t sendsInFlight = 0;           // 当前链中已提交但未完成的send数量
+        bool sendFailed = false;            // 发送出错后不再提交，等待上层移除
+        size_t queuedBytes = 0;             // 发送队列中尚未发送的字节数
+        bool readPaused = false;            // 超过高水位，已停止多发recv
+        bool pauseReported = false;         // 已向上层投递的水位状态
+        bool listening = false;
+        bool multishotArmed = false;        // 多发accept/recv是否仍在内核中
+        bool closed = false;                // 已移除，等待在途操作完成后释放
+    };
+
+    using Command = std::function<void()>;
+
+    bool setupRings();
+    bool setupBufferRing();
+    void releaseRings();
+
+    // 当前线程能否直接访问提交队列和连接状态：在事件循环线程中，或事件循环未运行
+    bool inLoopThread() const;
+    // 投递命令到事件循环线程执行
+    void postCommand(Command command);
+    // 执行其他线程投递的命令，仅由事件循环线程调用
+    void runCommands();
+    // io_uring_enter出错后不再处理I/O，只执行投递的命令直到stopEventLoop
+    void serveCommandsUntilStopped();
+    void wakeup();
+    // 提交对eventfd的读请求，完成后由事件循环重新提交
+    void armWakeup();
+
+    // 以下函数只在事件循环线程（或事件循环未运行时）调用
+    bool registerSocket(socket_t socket, IOEventType events, uint64_t id);
+    // 只移除ID小于registeredBefore的上下文：其他线程移除后关闭fd，命令执行前fd可能已被新连接复用
+    void detachSocket(socket_t socket, uint64_t registeredBefore = UINT64_MAX);
+    bool updateEvents(socket_t socket, IOEventType events);
+    bool setReadCallback(socket_t socket, EventCallback callback);
+    bool queueWrite(socket_t socket, const BufferSlice& data, EventCallback callback);
+    bool setAcceptCallback(socket_t serverSocket, EventCallback callback);
+    struct io_uring_sqe* getSqe(unsigned reserve = 1);
+    void submitPending(bool force = false);
+    void armMultishot(SocketContext* context);
+    // 填写SQE但不提交，调用方随后调用submitPending
+    void submitSends(SocketContext* context);
+    void enqueueSend(SocketContext* context, const BufferSlice& data, EventCallback callback);
+    void cancelOperation(uint64_t userData);
+    // 按上下文ID取消在途的读和发送，不依赖fd（命令执行时fd可能已被关闭并复用）
+    void cancelContext(SocketContext* context);
+    void releaseIfDrained(SocketContext* context);
+    void armTickTimer();
+    // 发送队列长度变化后检查高低水位，状态改变时返回true
+    bool checkWatermarks(SocketContext* context);
+    SocketContext* findContext(uint64_t id);
+    SocketContext* findSocket(socket_t socket);
+
+    void eventLoop();
+    void processCompletions();
+    void handleAcceptCompletion(const struct io_uring_cqe& cqe);
+    void handleRecvCompletion(const struct io_uring_cqe& cqe);
+    void handleSendCompletion(const struct io_uring_cqe& cqe);
+    void handleTickCompletion();
+    void handleWakeupCompletion();
+    void handleWatermarkCompletion(const struct io_uring_cqe& cqe);
+    void recycleBuffer(uint16_t bufferId);
+
+    static uint64_t makeUserData(uint64_t id, OpType op) { return (id << 8) | op; }
+
+    static constexpr unsigned SQ_ENTRIES = 256;
+    static constexpr unsigned CQ_ENTRIES = 4096;
+    static constexpr unsigned BUFFER_COUNT = 1024;  // 必须为2的幂
+    static constexpr unsigned BUFFER_SIZE = 4096;
+    static constexpr uint16_t BUFFER_GROUP = 0;
+    static constexpr size_t MAX_LINKED_SENDS = 16;
+
+    size_t highWatermark_;
+    size_t lowWatermark_;
+    std::function<void()> onThreadStart_;
+
+    int ringFd_;
+    int wakeFd_;                    // eventfd，其他线程写入以唤醒阻塞在io_uring_enter中的事件循环
+    uint64_t wakeValue_;            // eventfd读请求的目标缓冲区，只由内核和事件循环线程访问
+    bool initialized_;
+    std::atomic<bool> running_;
+    std::atomic<bool> loopActive_;  // 事件循环线程存在期间为true，此时其他线程必须通过命令队列访问
+    std::thread loopThread_;
+
+    // 周期回调，由IORING_OP_TIMEOUT驱动，每次完成后重新提交
+    TickCallback tickCallback_;
+    struct __kernel_timespec tickInterval_;
+
+    // 提交队列 (SQ)
+    void* sqRing_;
+    size_t sqRingSize_;
+    unsigned* sqHead_;
+    unsigned* sqTail_;
+    unsigned* sqArray_;
+    unsigned sqMask_;
+    unsigned sqEntries_;
+    unsigned sqLocalTail_;              // 已填写但尚未发布给内核的尾指针
+    struct io_uring_sqe* sqes_;
+    size_t sqesSize_;
+
+    // 完成队列 (CQ)
+    void* cqRing_;
+    size_t cqRingSize_;
+    unsigned* cqHead_;
+    unsigned* cqTail_;
+    unsigned cqMask_;
+    struct io_uring_cqe* cqes_;
+    std::vector<struct io_uring_cqe> completions_;
+
+    // provided buffer ring：内核在数据到达时才从中挑选接收缓冲区
+    // 按io_uring_buf数组访问：部分内核头文件的bufs柔性数组在C++下偏移不正确，尾指针覆盖在bufs[0].resv上
+    struct io_uring_buf* bufRing_;
+    size_t bufRingSize_;
+    std::unique_ptr<char[]> bufferPool_;
+    uint16_t bufTail_;
+
+    // 其他线程投递的命令
+    MpscQueue<Command> commands_;
+    std::atomic<bool> wakeupPending_;   // 已写eventfd但命令尚未被取走，合并多次唤醒
+    std::atomic<int> activeSockets_;
+
+    std::atomic<uint64_t> nextContextId_;    // addSocket调用时分配，按分配顺序递增
+    std::unordered_map<uint64_t, std::unique_ptr<SocketContext>> contexts_;
+    std::unordered_map<socket_t, uint64_t> socketIds_;
+};
+
+#endif // HAS_IO_URING
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+// 无锁多生产者单消费者队列（Vyukov MPSC）
+// push可由任意线程调用，只需一次原子交换；pop只能由唯一的消费者线程调用
+// 生产者完成交换但尚未链接节点的瞬间，消费者可能暂时看不到该元素，调用方需在push之后唤醒消费者
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() : head_(new Node()), tail_(head_.load(std::memory_order_relaxed)) {}
+
+    ~MpscQueue() {
+        T value;
+        while (pop(value)) {
+        }
+        delete tail_;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // 生产者调用
+    void push(T value) {
+        Node* node = new Node();
+        node->value.emplace(std::move(value));
+        Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    // 消费者调用，队列为空时返回false
+    bool pop(T& value) {
+        Node* tail = tail_;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return false;
+        }
+        value = std::move(*next->value);
+        next->value.reset();
+        tail_ = next;
+        delete tail;
+        return true;
+    }
+
+    // 消费者调用
+    bool empty() const {
+        return tail_->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        std::optional<T> value;
+    };
+
+    alignas(64) std::atomic<Node*> head_;   // 生产者端
+    alignas(64) Node* tail_;                // 消费者端（哨兵节点）
+};
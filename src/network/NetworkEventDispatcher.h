@@ -69,7 +69,7 @@ public:
     }
     
     // 分发数据接收事件
-    void notifyDataReceived(socket_t clientSocket, const std::vector<uint8_t>& data) {
+    void notifyDataReceived(socket_t clientSocket, const BufferSlice& data) {
         std::lock_guard<std::mutex> lock(listenersMutex_);
         for (auto& weak : listeners_) {
             if (auto listener = weak.lock()) {
@@ -5,24 +5,149 @@
 #include "logging/Log.h"
 #include "../messaging/message_header.h"
 #include "main/MainLoop.h"
+#include "main/ThreadPlacement.h"
 #include <cstdlib>
 #include <chrono>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <future>
 
 // 平台特定网络头文件
 #ifdef _WIN32
     #include <ws2tcpip.h>
 #else
     #include <arpa/inet.h>
+    #include <netinet/tcp.h>
+    #include <sys/un.h>
+    #include <poll.h>
     #include <cstring>
 #endif
 
 NetworkServer::NetworkServer(ConfigManager* configManager, DatabaseManager* dbManager)
-    : serverSocket(INVALID_SOCKET_VALUE), asyncIoManager(std::make_unique<AsyncIOManager>()), 
-      isRunning(false), config(configManager), database(dbManager), accountDb(nullptr)
+    : isRunning(false), config(configManager), database(dbManager), accountDb(nullptr)
 {
     // 从配置管理器获取服务器设置
     port = config->getServerPort();
     maxConnections = config->getMaxConnections();
+    reactorCount = std::max(1, config->getReactorThreads());
+    ioOptions.backend = config->getIOBackend() == "io_uring" ? AsyncIOBackend::IO_URING : AsyncIOBackend::EPOLL;
+    ioOptions.edgeTriggered = config->isEdgeTriggeredEnabled();
+    ioOptions.ioBudget = static_cast<size_t>(std::max(1, config->getIOBudgetBytes()));
+    acceptBatchSize = std::max(1, config->getAcceptBatchSize());
+    loginTimeoutMs = static_cast<uint64_t>(std::max(0, config->getConnectionTimeout())) * 1000;
+    idleTimeoutMs = static_cast<uint64_t>(std::max(0, config->getKeepAliveTimeout())) * 1000;
+    slowClientTimeoutMs = static_cast<uint64_t>(std::max(0, config->getSlowClientTimeout())) * 1000;
+    ioOptions.writeHighWatermark = static_cast<size_t>(std::max(0, config->getWriteHighWatermark()));
+    ioOptions.writeLowWatermark = static_cast<size_t>(std::max(0, config->getWriteLowWatermark()));
+    if (ioOptions.writeLowWatermark >= ioOptions.writeHighWatermark)
+    {
+        // 低水位须低于高水位，否则恢复读取后立即再次暂停
+        ioOptions.writeLowWatermark = ioOptions.writeHighWatermark / 2;
+    }
+    
+    ioOptions.busyPollUs = static_cast<uint32_t>(std::max(0, config->getBusyPollMicros()));
+    ioOptions.socketBusyPollUs = std::max(0, config->getSocketBusyPollMicros());
+    
+    udpPort = std::max(0, config->getUdpPort());
+    udpOptions.mtu = static_cast<uint32_t>(std::max(ReliableUdpSession::HEADER_SIZE + 1, static_cast<size_t>(std::max(0, config->getUdpMtu()))));
+    udpOptions.intervalMs = static_cast<uint32_t>(std::max(1, config->getUdpInterval()));
+    udpOptions.sendWindow = static_cast<uint32_t>(std::max(1, config->getUdpSendWindow()));
+    udpOptions.receiveWindow = static_cast<uint32_t>(std::max(1, config->getUdpReceiveWindow()));
+    udpOptions.fastResend = static_cast<uint32_t>(std::max(0, config->getUdpFastResend()));
+    udpOptions.minRtoMs = static_cast<uint32_t>(std::max(1, config->getUdpMinRto()));
+    udpOptions.deadLinkResends = static_cast<uint32_t>(std::max(1, config->getUdpDeadLinkResends()));
+    udpOptions.simulatedLossPercent = static_cast<uint32_t>(std::min(100, std::max(0, config->getUdpSimulatedLoss())));
+    udpOptions.idleTimeoutMs = static_cast<uint32_t>(idleTimeoutMs);
+    udpOptions.maxSessions = static_cast<uint32_t>(std::max(1, maxConnections));
+    unixSocketPath = config->getUnixSocketPath();
+    sharedMemorySocketPath = config->getSharedMemorySocketPath();
+    sharedMemoryRingBytes = static_cast<size_t>(std::max(4096, config->getSharedMemoryRingBytes()));
+    gatewayToken = config->getGatewayToken();
+    handoverSocketPath = config->getHandoverSocketPath();
+    if (!gatewayToken.empty())
+    {
+        gatewayMux = std::make_unique<GatewayMux>(static_cast<size_t>(std::max(1, config->getMaxGatewaySessions())));
+    }
+    
+    // 入站限速：连接级令牌桶，RateLimitMessages中的消息ID另有各自的令牌桶，窗口相同
+    std::string policy = config->getRateLimitPolicy();
+    rateLimitPolicy = policy == "delay" ? RateLimitPolicy::DELAY :
+                      policy == "disconnect" ? RateLimitPolicy::DISCONNECT : RateLimitPolicy::DROP;
+    maxInboundBytes = static_cast<size_t>(std::max(static_cast<int>(sizeof(MessageHeader)), config->getMaxInboundBufferBytes()));
+    if (config->isRateLimitEnabled())
+    {
+        uint64_t windowMs = static_cast<uint64_t>(std::max(1, config->getRateLimitWindow())) * 1000;
+        rateLimits.connection.requests = static_cast<uint32_t>(std::max(0, config->getRateLimitRequests()));
+        rateLimits.connection.windowMs = windowMs;
+        
+        std::istringstream messageLimits(config->getRateLimitMessages());
+        std::string entry;
+        while (std::getline(messageLimits, entry, ','))
+        {
+            size_t colon = entry.find(':');
+            if (colon == std::string::npos)
+            {
+                continue;
+            }
+            RateLimit limit;
+            limit.requests = static_cast<uint32_t>(std::strtoul(entry.c_str() + colon + 1, nullptr, 10));
+            limit.windowMs = windowMs;
+            if (limit.enabled())
+            {
+                rateLimits.addMessageLimit(static_cast<uint32_t>(std::strtoul(entry.c_str(), nullptr, 10)), limit);
+            }
+        }
+    }
+    
+    // 出站压缩：CompressionThresholds中的消息ID使用各自的阈值，其余使用默认阈值
+    if (config->isCompressionEnabled())
+    {
+        frameCompressor.setDefaultThreshold(static_cast<size_t>(std::max(0, config->getCompressionThreshold())));
+        std::istringstream thresholds(config->getCompressionThresholds());
+        std::string entry;
+        while (std::getline(thresholds, entry, ','))
+        {
+            size_t colon = entry.find(':');
+            if (colon == std::string::npos)
+            {
+                continue;
+            }
+            frameCompressor.setThreshold(static_cast<uint32_t>(std::strtoul(entry.c_str(), nullptr, 10)),
+                                         static_cast<size_t>(std::strtoul(entry.c_str() + colon + 1, nullptr, 10)));
+        }
+        // 网关控制帧由网关自己解析，心跳不值得压缩
+        for (uint32_t messageId : {MessageIds::GATEWAY_HELLO, MessageIds::GATEWAY_FORWARD, MessageIds::GATEWAY_CLOSE, MessageIds::HEARTBEAT})
+        {
+            frameCompressor.setThreshold(messageId, 0);
+        }
+    }
+    // 字典在未启用出站压缩时也加载，客户端发来的使用字典的压缩帧仍可解压
+    std::string dictionaryPath = config->getCompressionDictionary();
+    if (!dictionaryPath.empty())
+    {
+        std::ifstream dictionaryFile(dictionaryPath, std::ios::binary);
+        if (dictionaryFile)
+        {
+            std::ostringstream content;
+            content << dictionaryFile.rdbuf();
+            frameCompressor.setDictionary(content.str());
+            LOG_INFO("Loaded compression dictionary {} (id {:08x})", dictionaryPath, frameCompressor.dictionaryId());
+        }
+        else
+        {
+            LOG_ERROR("Failed to open compression dictionary {}, compressing without it", dictionaryPath);
+        }
+    }
+    
+#ifndef SO_REUSEPORT
+    // 没有SO_REUSEPORT时无法让内核在多个监听套接字间分发连接
+    if (reactorCount > 1)
+    {
+        LOG_WARN("SO_REUSEPORT not supported on this platform, using a single reactor");
+        reactorCount = 1;
+    }
+#endif
 }
 
 NetworkServer::~NetworkServer()
@@ -32,37 +157,75 @@ NetworkServer::~NetworkServer()
 
 bool NetworkServer::initialize()
 {
-    LOG_INFO("Initializing network server...");
+    LOG_INFO("Initializing network server with {} reactor(s)...", reactorCount);
     
-    // 初始化异步I/O管理器
-    if (!initializeAsyncIO())
+    // 热重启：旧进程在交接套接字上监听时接管其监听套接字和连接，而不是重新绑定端口
+    std::vector<socket_t> inheritedListeners;
+    socket_t inheritedUnixListener = INVALID_SOCKET_VALUE;
+    std::vector<HandoverConnection> inheritedConnections;
+    if (!handoverSocketPath.empty())
     {
-        return false;
+        takeOver(inheritedListeners, inheritedUnixListener, inheritedConnections);
     }
     
-    // 创建服务器套接字
-    if (!createSocket())
+    for (int i = 0; i < reactorCount; ++i)
     {
-        return false;
+        auto reactor = std::make_unique<Reactor>();
+        reactor->index = i;
+        reactor->ioManager = std::make_unique<AsyncIOManager>();
+        
+        // 初始化异步I/O管理器
+        if (!initializeAsyncIO(*reactor))
+        {
+            return false;
+        }
+        
+        // 每个reactor拥有独立的监听套接字，由内核通过SO_REUSEPORT分发新连接
+        if (static_cast<size_t>(i) < inheritedListeners.size())
+        {
+            reactor->listenSocket = inheritedListeners[i];
+        }
+        else if (!createSocket(reactor->listenSocket) ||
+                 !bindSocket(reactor->listenSocket) ||
+                 !listenForConnections(reactor->listenSocket))
+        {
+            return false;
+        }
+        
+        if (!registerListener(*reactor, reactor->listenSocket))
+        {
+            LOG_ERROR("Failed to register server socket with async I/O manager: {}", GET_LAST_ERROR());
+            return false;
+        }
+        
+        reactors_.push_back(std::move(reactor));
     }
     
-    // 绑定套接字
-    if (!bindSocket())
+    // 旧进程的reactor比本进程多时，多出的监听套接字中尚未accept的连接会被内核重置
+    for (size_t i = reactors_.size(); i < inheritedListeners.size(); ++i)
     {
-        return false;
+        LOG_WARN("Closing inherited listening socket {}: only {} reactor(s) configured", inheritedListeners[i], reactors_.size());
+        CLOSE_SOCKET(inheritedListeners[i]);
     }
     
-    // 开始监听
-    if (!listenForConnections())
+    // 同机网关走AF_UNIX，连接与TCP连接一样由reactor处理；AF_UNIX不支持SO_REUSEPORT，只在第一个reactor上监听
+    if (!unixSocketPath.empty() && !createUnixListener(*reactors_.front(), inheritedUnixListener))
     {
         return false;
     }
+    if (unixSocketPath.empty() && inheritedUnixListener != INVALID_SOCKET_VALUE)
+    {
+        CLOSE_SOCKET(inheritedUnixListener);
+    }
     
-    // 注册服务器套接字到异步I/O管理器
-    if (!asyncIoManager->addSocket(serverSocket, IOEventType::READ | IOEventType::IOERROR))
+    // 事件循环尚未启动，直接注册到各reactor；旧进程按reactor序号交来，本进程reactor数不同时取模分配
+    for (HandoverConnection& connection : inheritedConnections)
     {
-        LOG_ERROR("Failed to register server socket with async I/O manager: {}", GET_LAST_ERROR());
-        return false;
+        adoptConnection(*reactors_[static_cast<size_t>(connection.reactorIndex) % reactors_.size()], connection);
+    }
+    if (!inheritedConnections.empty())
+    {
+        LOG_INFO("Took over {} connection(s) from the previous server", inheritedConnections.size());
     }
     
     // 初始化数据库
@@ -73,52 +236,65 @@ bool NetworkServer::initialize()
     return true;
 }
 
-bool NetworkServer::initializeAsyncIO()
+bool NetworkServer::initializeAsyncIO(Reactor& reactor)
 {
-    if (!asyncIoManager) {
+    if (!reactor.ioManager) {
         return false;
     }
     
-    if (!asyncIoManager->initialize()) {
-        LOG_ERROR("Failed to initialize AsyncIOManager");
+    // 事件循环线程启动时按reactor序号设置线程名并绑定CPU
+    AsyncIOOptions options = ioOptions;
+    int index = reactor.index;
+    options.onThreadStart = [index]() {
+        if (!ThreadPlacement::apply(ThreadRole::REACTOR, "reactor-" + std::to_string(index), index)) {
+            LOG_WARN("Failed to pin reactor {} to its configured CPUs", index);
+        }
+    };
+    if (!reactor.ioManager->initialize(options)) {
+        LOG_ERROR("Failed to initialize AsyncIOManager for reactor {}", reactor.index);
         return false;
     }
     
     // 设置异步I/O回调
-    setupAsyncIOCallbacks();
+    setupAsyncIOCallbacks(reactor);
+    
+    // 由事件循环的等待超时驱动本reactor的时间轮
+    Reactor* reactorPtr = &reactor;
+    bool delayFrames = rateLimits.enabled() && rateLimitPolicy == RateLimitPolicy::DELAY;
+    if ((loginTimeoutMs > 0 || idleTimeoutMs > 0 || delayFrames) &&
+        !reactor.ioManager->setTickCallback(TIMER_TICK_MS, [this, reactorPtr]() { onTimerTick(*reactorPtr); }))
+    {
+        LOG_WARN("Async I/O backend of reactor {} has no timer support, idle connections will not time out "
+                 "and rate-limited frames will not be delayed", reactor.index);
+    }
     
-    LOG_INFO("AsyncIOManager initialized successfully");
+    LOG_INFO("AsyncIOManager initialized successfully for reactor {}", reactor.index);
     return true;
 }
 
-void NetworkServer::setupAsyncIOCallbacks()
+void NetworkServer::setupAsyncIOCallbacks(Reactor& reactor)
 {
-    if (!asyncIoManager) {
+    if (!reactor.ioManager) {
         return;
     }
     
-    // 设置统一的网络事件回调
-    asyncIoManager->setAcceptCallback([this](const IOEvent& event) {
-        handleAsyncIOEvent(event);
-    });
-    
-    asyncIoManager->setReadCallback([this](const IOEvent& event) {
-        handleAsyncIOEvent(event);
-    });
-    
-    asyncIoManager->setWriteCallback([this](const IOEvent& event) {
-        handleAsyncIOEvent(event);
-    });
+    // 设置统一的网络事件回调，回调运行在该reactor的事件循环线程中
+    Reactor* reactorPtr = &reactor;
+    auto callback = [this, reactorPtr](const IOEvent& event) {
+        handleAsyncIOEvent(*reactorPtr, event);
+    };
     
-    asyncIoManager->setErrorCallback([this](const IOEvent& event) {
-        handleAsyncIOEvent(event);
-    });
+    reactor.ioManager->setAcceptCallback(callback);
+    reactor.ioManager->setReadCallback(callback);
+    reactor.ioManager->setWriteCallback(callback);
+    reactor.ioManager->setErrorCallback(callback);
+    reactor.ioManager->setBackpressureCallback(callback);
 }
 
-bool NetworkServer::createSocket()
+bool NetworkServer::createSocket(socket_t& listenSocket)
 {
-    serverSocket = socket(AF_INET, SOCK_STREAM, 0);
-    if (serverSocket == INVALID_SOCKET_VALUE)
+    listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenSocket == INVALID_SOCKET_VALUE)
     {
         LOG_ERROR("Failed to create socket: {}", GET_LAST_ERROR());
         return false;
@@ -126,22 +302,33 @@ bool NetworkServer::createSocket()
     
     // 设置套接字选项
     int opt = 1;
-    if (setsockopt(serverSocket, SOL_SOCKET, SO_REUSEADDR, (char*)&opt, sizeof(opt)) == SOCKET_ERROR_VAL)
+    if (setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, (char*)&opt, sizeof(opt)) == SOCKET_ERROR_VAL)
     {
         LOG_ERROR("Failed to set socket options: {}", GET_LAST_ERROR());
-        CLOSE_SOCKET(serverSocket);
-        serverSocket = INVALID_SOCKET_VALUE;
+        CLOSE_SOCKET(listenSocket);
+        listenSocket = INVALID_SOCKET_VALUE;
+        return false;
+    }
+    
+#ifdef SO_REUSEPORT
+    // 允许多个reactor绑定同一端口，由内核在各监听套接字间均衡分发连接
+    if (setsockopt(listenSocket, SOL_SOCKET, SO_REUSEPORT, (char*)&opt, sizeof(opt)) == SOCKET_ERROR_VAL)
+    {
+        LOG_ERROR("Failed to set SO_REUSEPORT: {}", GET_LAST_ERROR());
+        CLOSE_SOCKET(listenSocket);
+        listenSocket = INVALID_SOCKET_VALUE;
         return false;
     }
+#endif
     
 #ifndef _WIN32
     // 设置为非阻塞模式 (仅在Unix系统)
-    int flags = fcntl(serverSocket, F_GETFL, 0);
-    if (flags < 0 || fcntl(serverSocket, F_SETFL, flags | O_NONBLOCK) < 0)
+    int flags = fcntl(listenSocket, F_GETFL, 0);
+    if (flags < 0 || fcntl(listenSocket, F_SETFL, flags | O_NONBLOCK) < 0)
     {
         LOG_ERROR("Failed to set non-blocking mode: {}", strerror(errno));
-        CLOSE_SOCKET(serverSocket);
-        serverSocket = INVALID_SOCKET_VALUE;
+        CLOSE_SOCKET(listenSocket);
+        listenSocket = INVALID_SOCKET_VALUE;
         return false;
     }
 #endif
@@ -149,241 +336,1185 @@ bool NetworkServer::createSocket()
     return true;
 }
 
-bool NetworkServer::bindSocket()
+bool NetworkServer::bindSocket(socket_t& listenSocket)
 {
     struct sockaddr_in serverAddr;
     serverAddr.sin_family = AF_INET;
     serverAddr.sin_addr.s_addr = INADDR_ANY;
     serverAddr.sin_port = htons(port);
     
-    if (bind(serverSocket, (struct sockaddr*)&serverAddr, sizeof(serverAddr)) == SOCKET_ERROR_VAL)
+    if (bind(listenSocket, (struct sockaddr*)&serverAddr, sizeof(serverAddr)) == SOCKET_ERROR_VAL)
     {
         LOG_ERROR("Bind failed: {}", GET_LAST_ERROR());
-        CLOSE_SOCKET(serverSocket);
-        serverSocket = INVALID_SOCKET_VALUE;
+        CLOSE_SOCKET(listenSocket);
+        listenSocket = INVALID_SOCKET_VALUE;
         return false;
     }
     
     return true;
 }
 
-bool NetworkServer::listenForConnections()
+bool NetworkServer::listenForConnections(socket_t& listenSocket)
 {
-    if (listen(serverSocket, maxConnections) == SOCKET_ERROR_VAL)
+    if (listen(listenSocket, maxConnections) == SOCKET_ERROR_VAL)
     {
         LOG_ERROR("Listen failed: {}", GET_LAST_ERROR());
-        CLOSE_SOCKET(serverSocket);
-        serverSocket = INVALID_SOCKET_VALUE;
+        CLOSE_SOCKET(listenSocket);
+        listenSocket = INVALID_SOCKET_VALUE;
         return false;
     }
     
-    return true;
+    return true;
+}
+
+bool NetworkServer::registerListener(Reactor& reactor, socket_t listenSocket)
+{
+    Reactor* reactorPtr = &reactor;
+    return reactor.ioManager->addSocket(listenSocket, IOEventType::READ | IOEventType::IOERROR) &&
+           reactor.ioManager->asyncAccept(listenSocket, [this, reactorPtr](const IOEvent& event) {
+               handleAsyncIOEvent(*reactorPtr, event);
+           });
+}
+
+bool NetworkServer::createUnixListener(Reactor& reactor, socket_t inheritedSocket)
+{
+#ifndef _WIN32
+    if (inheritedSocket != INVALID_SOCKET_VALUE)
+    {
+        // 旧进程交来的监听套接字仍绑定在原路径上，不能删除套接字文件
+        reactor.unixListenSocket = inheritedSocket;
+        if (!registerListener(reactor, inheritedSocket))
+        {
+            LOG_ERROR("Failed to register inherited unix socket {}", unixSocketPath);
+            return false;
+        }
+        LOG_INFO("Listening on inherited unix socket {}", unixSocketPath);
+        return true;
+    }
+    
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (unixSocketPath.size() >= sizeof(address.sun_path))
+    {
+        LOG_ERROR("Unix socket path too long: {}", unixSocketPath);
+        return false;
+    }
+    memcpy(address.sun_path, unixSocketPath.c_str(), unixSocketPath.size());
+    
+    reactor.unixListenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (reactor.unixListenSocket == INVALID_SOCKET_VALUE)
+    {
+        LOG_ERROR("Failed to create unix socket: {}", GET_LAST_ERROR());
+        return false;
+    }
+    
+    // 上次运行残留的套接字文件会导致bind失败
+    unlink(unixSocketPath.c_str());
+    int flags = fcntl(reactor.unixListenSocket, F_GETFL, 0);
+    if (flags < 0 || fcntl(reactor.unixListenSocket, F_SETFL, flags | O_NONBLOCK) < 0 ||
+        bind(reactor.unixListenSocket, (struct sockaddr*)&address, sizeof(address)) == SOCKET_ERROR_VAL)
+    {
+        LOG_ERROR("Failed to bind unix socket {}: {}", unixSocketPath, GET_LAST_ERROR());
+        CLOSE_SOCKET(reactor.unixListenSocket);
+        reactor.unixListenSocket = INVALID_SOCKET_VALUE;
+        return false;
+    }
+    
+    if (!listenForConnections(reactor.unixListenSocket) ||
+        !registerListener(reactor, reactor.unixListenSocket))
+    {
+        LOG_ERROR("Failed to listen on unix socket {}", unixSocketPath);
+        return false;
+    }
+    
+    LOG_INFO("Listening on unix socket {}", unixSocketPath);
+    return true;
+#else
+    (void)reactor;
+    (void)inheritedSocket;
+    LOG_ERROR("Unix socket listener is not supported on this platform");
+    return false;
+#endif
+}
+
+bool NetworkServer::start()
+{
+    LOG_INFO("Starting server...");
+    isRunning = true;
+    
+    // 启动每个reactor的异步I/O事件循环
+    for (auto& reactor : reactors_)
+    {
+        if (!reactor->ioManager->startEventLoop())
+        {
+            LOG_ERROR("Failed to start async I/O event loop for reactor {}: {}", reactor->index, GET_LAST_ERROR());
+            isRunning = false;
+            return false;
+        }
+    }
+    
+    // 可靠UDP与TCP共用消息解析和主循环，只是会话由UDP传输线程维护
+    if (udpPort > 0)
+    {
+        udpTransport = std::make_unique<UdpTransport>(udpOptions);
+        udpTransport->setMessageCallback([this](uint32_t conv, uint32_t generation, const BufferSlice& message, UdpChannel channel) {
+            onUdpMessage(ConnectionId::datagram(conv, generation), message, channel);
+        });
+        udpTransport->setSessionClosedCallback([this](uint32_t conv, uint32_t generation) {
+            closeGatewayLink(ConnectionId::datagram(conv, generation));
+        });
+        if (!udpTransport->start("0.0.0.0", static_cast<uint16_t>(udpPort)))
+        {
+            LOG_ERROR("Failed to start reliable UDP transport on port {}", udpPort);
+            isRunning = false;
+            return false;
+        }
+        if (udpOptions.simulatedLossPercent > 0)
+        {
+            LOG_WARN("Reliable UDP is dropping {}% of outgoing datagrams (UdpSimulatedLoss)", udpOptions.simulatedLossPercent);
+        }
+    }
+    
+    // 共享内存通道收到的帧同样经过dispatchFrame进入主循环
+    if (!sharedMemorySocketPath.empty())
+    {
+        sharedMemoryTransport = std::make_unique<SharedMemoryTransport>(sharedMemoryRingBytes);
+        sharedMemoryTransport->setMessageCallback([this](uint32_t channelId, const BufferSlice& frame) {
+            onSharedMemoryMessage(channelId, frame);
+        });
+        sharedMemoryTransport->setChannelClosedCallback([this](uint32_t channelId) {
+            closeGatewayLink(ConnectionId::sharedMemory(channelId));
+        });
+        if (!sharedMemoryTransport->start(sharedMemorySocketPath))
+        {
+            LOG_ERROR("Failed to start shared memory transport on {}", sharedMemorySocketPath);
+            isRunning = false;
+            return false;
+        }
+    }
+    
+    // 热重启：在交接套接字上等待下一次部署的新进程
+    if (!handoverSocketPath.empty())
+    {
+        handoverListenSocket = HotRestart::listen(handoverSocketPath);
+        if (handoverListenSocket != INVALID_SOCKET_VALUE)
+        {
+            handoverThread = std::thread(&NetworkServer::runHandoverListener, this);
+        }
+        else
+        {
+            LOG_WARN("Hot restart is unavailable, the next deployment will have to drop connections");
+        }
+    }
+    
+    LOG_INFO("Server started successfully");
+    return true;
+}
+
+// 统一的网络事件处理器
+void NetworkServer::handleAsyncIOEvent(Reactor& reactor, const IOEvent& event) {
+    switch (event.eventType) {
+        case IOEventType::ACCEPT:
+            onAcceptEvent(reactor, event);
+            break;
+        case IOEventType::READ:
+            onReadEvent(reactor, event);
+            break;
+        case IOEventType::WRITE:
+            onWriteEvent(event);
+            break;
+        case IOEventType::HIGH_WATERMARK:
+        case IOEventType::LOW_WATERMARK:
+            onBackpressureEvent(reactor, event);
+            break;
+        case IOEventType::IOERROR:
+        default:
+            onErrorEvent(reactor, event);
+            break;
+    }
+}
+
+void NetworkServer::onAcceptEvent(Reactor& reactor, const IOEvent& event)
+{
+    socket_t listenSocket = event.socket;
+    if (listenSocket != reactor.listenSocket && listenSocket != reactor.unixListenSocket) {
+        LOG_WARN("Received accept event for non-server socket");
+        return;
+    }
+    
+    // 后端已完成accept（io_uring多发accept）时直接使用新连接
+    if (event.acceptedSocket != INVALID_SOCKET_VALUE)
+    {
+        reactor.acceptedCount++;
+        acceptClient(reactor, event.acceptedSocket, nullptr);
+        return;
+    }
+    
+    // 循环accept直到EAGAIN或达到单次唤醒上限；监听套接字为水平触发，剩余连接在下一次唤醒中继续处理
+    int accepted = 0;
+    while (accepted < acceptBatchSize)
+    {
+        struct sockaddr_storage clientAddr;
+        socklen_t clientAddrSize = sizeof(clientAddr);
+        
+    #ifdef __linux__
+        // 新连接直接为非阻塞且带CLOEXEC，无需额外的fcntl
+        socket_t clientSocket = accept4(listenSocket, (struct sockaddr*)&clientAddr, &clientAddrSize,
+                                        SOCK_NONBLOCK | SOCK_CLOEXEC);
+    #else
+        socket_t clientSocket = accept(listenSocket, (struct sockaddr*)&clientAddr, &clientAddrSize);
+    #endif
+        
+        if (clientSocket == INVALID_SOCKET_VALUE)
+        {
+        #ifdef _WIN32
+            int errorCode = WSAGetLastError();
+            if (errorCode != WSAEWOULDBLOCK && isRunning.load())
+            {
+                LOG_ERROR("Accept failed: {}", errorCode);
+            }
+        #else
+            int errorCode = errno;
+            if (errorCode == EINTR || errorCode == ECONNABORTED)
+            {
+                // 被信号打断或对端在accept前已断开，继续取下一个连接
+                continue;
+            }
+            if (errorCode != EAGAIN && errorCode != EWOULDBLOCK && isRunning.load())
+            {
+                LOG_ERROR("Accept failed: {}", strerror(errorCode));
+            }
+        #endif
+            break;
+        }
+        
+    #if !defined(_WIN32) && !defined(__linux__)
+        // 设置客户端套接字为非阻塞模式 (没有accept4的Unix系统)
+        int flags = fcntl(clientSocket, F_GETFL, 0);
+        if (flags >= 0) {
+            fcntl(clientSocket, F_SETFL, flags | O_NONBLOCK);
+        }
+    #endif
+        
+        ++accepted;
+        // AF_UNIX连接没有IP地址
+        acceptClient(reactor, clientSocket,
+                     clientAddr.ss_family == AF_INET ? reinterpret_cast<const struct sockaddr_in*>(&clientAddr) : nullptr);
+    }
+    
+    reactor.acceptedCount += accepted;
+    if (accepted >= acceptBatchSize && listenSocket == reactor.listenSocket)
+    {
+        // 一次唤醒没有取完积压的连接，检查监听队列是否已满
+        reactor.acceptCapHits++;
+        checkAcceptBacklog(reactor);
+    }
+}
+
+void NetworkServer::acceptClient(Reactor& reactor, socket_t clientSocket, const struct sockaddr_in* clientAddr)
+{
+    if (clientAddr)
+    {
+        char clientIP[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &(clientAddr->sin_addr), clientIP, sizeof(clientIP));
+        LOG_DEBUG("New client {} connected from {}:{}", clientSocket, clientIP, ntohs(clientAddr->sin_port));
+    }
+    else
+    {
+        LOG_DEBUG("New client {} connected", clientSocket);
+    }
+    
+    // 添加客户端到列表，连接在其生命周期内由接受它的reactor处理
+    ConnectionId connectionId = addClient(clientSocket, &reactor);
+    if (!connectionId.isValid())
+    {
+        // 连接表已满，不记录也不注册，直接关闭
+        LOG_ERROR("Failed to add client {}: connection table is full", clientSocket);
+        CLOSE_SOCKET(clientSocket);
+        return;
+    }
+    // fd可能被复用，重新创建连接记录
+    reactor.connections.erase(clientSocket);
+    Connection* connection = reactor.connections.insert(clientSocket);
+    connection->id = connectionId;
+    
+    // 注册客户端套接字到本reactor的异步I/O管理器
+    if (!reactor.ioManager->addClient(clientSocket))
+    {
+        LOG_ERROR("Failed to register client socket with async I/O manager: {}", GET_LAST_ERROR());
+        reactor.connections.erase(clientSocket);
+        removeClient(clientSocket);
+        CLOSE_SOCKET(clientSocket);
+        return;
+    }
+    
+    // 先给出登录期限，登录后改为心跳超时；定时器随连接记录销毁而取消
+    Reactor* reactorPtr = &reactor;
+    connection->lastActiveMs = reactor.timers.now();
+    connection->timer.callback = [this, reactorPtr, clientSocket]() {
+        onConnectionTimeout(*reactorPtr, clientSocket);
+    };
+    if (loginTimeoutMs > 0) {
+        connection->loginPending = true;
+        reactor.timers.schedule(connection->timer, loginTimeoutMs);
+    } else if (idleTimeoutMs > 0) {
+        reactor.timers.schedule(connection->timer, idleTimeoutMs);
+    }
+    
+    // 发送欢迎消息，已知所属reactor，直接放入发送队列
+    queueSend(reactor, clientSocket, "Welcome to Account Server! Please login.\n");
+    
+    // 分发客户端连接事件
+    eventDispatcher.notifyClientConnected(clientSocket);
+}
+
+void NetworkServer::checkAcceptBacklog(Reactor& reactor)
+{
+#ifdef __linux__
+    // 监听套接字的TCP_INFO中，tcpi_unacked为全连接队列当前长度，tcpi_sacked为backlog上限
+    struct tcp_info info;
+    socklen_t length = sizeof(info);
+    if (getsockopt(reactor.listenSocket, IPPROTO_TCP, TCP_INFO, &info, &length) == 0 &&
+        info.tcpi_unacked >= info.tcpi_sacked)
+    {
+        reactor.backlogFullHits++;
+    }
+#else
+    (void)reactor;
+#endif
+}
+
+PollStats NetworkServer::getPollStats() const
+{
+    PollStats stats;
+    for (const auto& reactor : reactors_)
+    {
+        PollStats reactorStats = reactor->ioManager->getPollStats();
+        stats.spinWakeups += reactorStats.spinWakeups;
+        stats.blockWakeups += reactorStats.blockWakeups;
+        stats.spinMicros += reactorStats.spinMicros;
+        stats.spinBudgetUs = std::max(stats.spinBudgetUs, reactorStats.spinBudgetUs);
+    }
+    return stats;
+}
+
+NetworkServer::AcceptStats NetworkServer::getAcceptStats() const
+{
+    AcceptStats stats;
+    for (const auto& reactor : reactors_)
+    {
+        stats.accepted += reactor->acceptedCount.load();
+        stats.cappedWakeups += reactor->acceptCapHits.load();
+        stats.backlogFull += reactor->backlogFullHits.load();
+    }
+    
+#ifdef __linux__
+    // 内核的全连接队列溢出计数（全系统）：/proc/net/netstat中TcpExt的ListenOverflows
+    std::ifstream netstat("/proc/net/netstat");
+    std::string names;
+    std::string values;
+    while (std::getline(netstat, names) && std::getline(netstat, values))
+    {
+        if (names.compare(0, 7, "TcpExt:") != 0)
+        {
+            continue;
+        }
+        std::istringstream nameStream(names);
+        std::istringstream valueStream(values);
+        std::string name;
+        std::string value;
+        while (nameStream >> name && valueStream >> value)
+        {
+            if (name == "ListenOverflows")
+            {
+                stats.listenOverflows = std::strtoull(value.c_str(), nullptr, 10);
+                break;
+            }
+        }
+        break;
+    }
+#endif
+    
+    return stats;
+}
+
+void NetworkServer::onReadEvent(Reactor& reactor, const IOEvent& event)
+{
+    if (event.data.empty()) {
+        LOG_DEBUG("Received empty read event for socket {}", event.socket);
+        return;
+    }
+    
+    LOG_DEBUG("Processing read event for socket {} with {} bytes", event.socket, event.data.size());
+    
+    // 分发给监听器，切片与接收缓冲区共享存储
+    eventDispatcher.notifyDataReceived(event.socket, event.data);
+    
+    // 将数据处理逻辑也在这里处理，以保持一致性
+    // 注意：这里的消息处理逻辑与processNetworkMessage相同，保持一致性
+    try {
+        // 获取或创建客户端的入站缓冲区
+        Connection* connection = reactor.connections.find(event.socket);
+        if (!connection) {
+            connection = reactor.connections.insert(event.socket);
+        }
+        if (!connection->id.isValid()) {
+            connection->id = getConnectionId(event.socket);
+        }
+        // 任何入站数据都视为连接存活，定时器到期时再按此时间决定是否延后，收包路径不操作时间轮
+        connection->lastActiveMs = reactor.timers.now();
+        InboundBuffer& buffer = connection->inbound;
+        BufferSlice input = event.data;
+        uint64_t nowMs = rateLimits.enabled() ? steadyNowMs() : 0;
+        
+        // 热重启交接期间只追加数据，连接交给新进程后由新进程解析
+        if (reactor.handingOver) {
+            buffer.append(input.data(), input.size());
+            return;
+        }
+        
+        // 有帧被限速延后时只追加数据，由限速定时器按令牌补充的节奏投递
+        if (connection->throttled) {
+            buffer.append(input.data(), input.size());
+            closeIfInboundOverflow(reactor, event.socket, *connection);
+            return;
+        }
+        
+        // 入站缓冲区中有上次剩下的半帧时，先从本次数据中只取出补齐该帧所需的部分
+        if (!buffer.empty()) {
+            size_t take = 0;
+            if (buffer.size() < sizeof(MessageHeader)) {
+                take = std::min(sizeof(MessageHeader) - buffer.size(), input.size());
+                buffer.append(input.data(), take);
+                input = input.slice(take);
+            }
+            
+            MessageHeader header;
+            if (header.deserialize(buffer.data(), buffer.size())) {
+                size_t frameSize = sizeof(MessageHeader) + header.dataLength;
+                take = std::min(frameSize - buffer.size(), input.size());
+                buffer.append(input.data(), take);
+                input = input.slice(take);
+                
+                if (buffer.size() == frameSize) {
+                    Admission admission = admitFrame(*connection, buffer.data(), frameSize, nowMs);
+                    if (admission == Admission::DEFER) {
+                        buffer.append(input.data(), input.size());
+                        if (!closeIfInboundOverflow(reactor, event.socket, *connection)) {
+                            scheduleThrottle(reactor, event.socket, *connection, nowMs);
+                        }
+                        return;
+                    }
+                    if (admission == Admission::DISCONNECT) {
+                        closeConnection(reactor, event.socket);
+                        return;
+                    }
+                    // 跨越两次读取的帧拷贝一次到独立的切片中
+                    BufferSlice frame = admission == Admission::ACCEPT ? BufferSlice::copyFrom(buffer.data(), frameSize) : BufferSlice();
+                    buffer.consume(frameSize);
+                    if (!frame.empty() && !dispatchFrame(connection->id, frame)) {
+                        buffer.clear();
+                        return;
+                    }
+                }
+            }
+        }
+        
+        // 半帧已补齐后，其余完整帧直接在本次接收的切片上原地解析，消息体引用该切片而不复制
+        if (buffer.empty()) {
+            size_t messageSize;
+            while ((messageSize = MessageParser::getCompleteMessageSize(input.data(), input.size())) > 0) {
+                Admission admission = admitFrame(*connection, input.data(), messageSize, nowMs);
+                if (admission == Admission::DEFER) {
+                    // 被延后的帧及其后的数据全部进入入站缓冲区
+                    buffer.append(input.data(), input.size());
+                    if (!closeIfInboundOverflow(reactor, event.socket, *connection)) {
+                        scheduleThrottle(reactor, event.socket, *connection, nowMs);
+                    }
+                    return;
+                }
+                if (admission == Admission::DISCONNECT) {
+                    closeConnection(reactor, event.socket);
+                    return;
+                }
+                if (admission == Admission::ACCEPT && !dispatchFrame(connection->id, input.slice(0, messageSize))) {
+                    return;
+                }
+                input = input.slice(messageSize);
+            }
+        }
+        
+        // 剩余的不完整帧留在入站缓冲区等待更多数据
+        buffer.append(input.data(), input.size());
+        closeIfInboundOverflow(reactor, event.socket, *connection);
+        
+    } catch (const std::exception& e) {
+        LOG_ERROR("Exception processing network message from client {}: {}", event.socket, e.what());
+        // 发送错误响应
+        NetworkMessage errorResponse = MessageUtils::createErrorResponse(0, "Internal server error");
+        sendNetworkMessage(event.socket, errorResponse);
+    }
+}
+
+NetworkServer::Admission NetworkServer::admitFrame(Connection& connection, const uint8_t* frame, size_t size, uint64_t nowMs)
+{
+    if (!rateLimits.enabled() || connection.rateLimitExempt) {
+        return Admission::ACCEPT;
+    }
+    
+    MessageHeader header;
+    header.deserialize(frame, size);
+    // 压缩帧按原消息ID限速
+    uint32_t messageId = header.baseId();
+    if (messageId == MessageIds::GATEWAY_FORWARD || messageId == MessageIds::GATEWAY_CLOSE) {
+        // 网关链路承载许多玩家，认证后不再按单个连接限速；未认证的链路发来的网关帧会在dispatchFrame中被拒绝
+        if (gatewayMux && gatewayMux->isLink(connection.id)) {
+            connection.rateLimitExempt = true;
+            return Admission::ACCEPT;
+        }
+    }
+    
+    if (connection.limiter.allow(rateLimits, messageId, nowMs)) {
+        return Admission::ACCEPT;
+    }
+    
+    switch (rateLimitPolicy) {
+        case RateLimitPolicy::DELAY:
+            return Admission::DEFER;
+        case RateLimitPolicy::DISCONNECT:
+            LOG_WARN("Client {} exceeded the rate limit with message {}, closing connection", connection.id.value(), messageId);
+            return Admission::DISCONNECT;
+        case RateLimitPolicy::DROP:
+        default:
+            LOG_DEBUG("Client {} exceeded the rate limit, dropping message {}", connection.id.value(), messageId);
+            return Admission::DROP;
+    }
+}
+
+bool NetworkServer::closeIfInboundOverflow(Reactor& reactor, socket_t clientSocket, const Connection& connection)
+{
+    if (connection.inbound.size() <= maxInboundBytes) {
+        return false;
+    }
+    // 清空缓冲区会破坏帧边界，被限速的连接则是在持续超发，两种情况都按DISCONNECT处理
+    if (connection.throttled) {
+        LOG_WARN("Client {} kept sending while rate limited ({} bytes held), closing connection",
+                 clientSocket, connection.inbound.size());
+    } else {
+        LOG_WARN("Client {} inbound buffer exceeds {} bytes, closing connection", clientSocket, maxInboundBytes);
+    }
+    closeConnection(reactor, clientSocket);
+    return true;
+}
+
+void NetworkServer::scheduleThrottle(Reactor& reactor, socket_t clientSocket, Connection& connection, uint64_t nowMs)
+{
+    MessageHeader header;
+    header.deserialize(connection.inbound.data(), connection.inbound.size());
+    uint64_t waitMs = connection.limiter.waitMs(rateLimits, header.baseId(), nowMs);
+    
+    connection.throttled = true;
+    Reactor* reactorPtr = &reactor;
+    connection.throttleTimer.callback = [this, reactorPtr, clientSocket]() {
+        onThrottleTimer(*reactorPtr, clientSocket);
+    };
+    reactor.timers.schedule(connection.throttleTimer, std::max<uint64_t>(1, waitMs));
+}
+
+void NetworkServer::onThrottleTimer(Reactor& reactor, socket_t clientSocket)
+{
+    Connection* connection = reactor.connections.find(clientSocket);
+    if (!connection || reactor.handingOver) {
+        return;
+    }
+    
+    uint64_t nowMs = steadyNowMs();
+    InboundBuffer& buffer = connection->inbound;
+    size_t messageSize;
+    while ((messageSize = MessageParser::getCompleteMessageSize(buffer.data(), buffer.size())) > 0) {
+        Admission admission = admitFrame(*connection, buffer.data(), messageSize, nowMs);
+        if (admission == Admission::DEFER) {
+            scheduleThrottle(reactor, clientSocket, *connection, nowMs);
+            return;
+        }
+        if (admission == Admission::DISCONNECT) {
+            // 定时器回调中不能销毁连接记录，推进结束后关闭
+            reactor.expiredSockets.push_back(clientSocket);
+            return;
+        }
+        BufferSlice frame = admission == Admission::ACCEPT ? BufferSlice::copyFrom(buffer.data(), messageSize) : BufferSlice();
+        buffer.consume(messageSize);
+        if (!frame.empty() && !dispatchFrame(connection->id, frame)) {
+            buffer.clear();
+            break;
+        }
+    }
+    
+    // 剩余的半帧按正常路径继续接收
+    connection->throttled = false;
+}
+
+bool NetworkServer::dispatchFrame(ConnectionId connectionId, const BufferSlice& frame)
+{
+    // 解析消息
+    auto message = MessageParser::parseMessage(frame);
+    if (!message) {
+        LOG_WARN("Failed to parse message from client {}", connectionId.value());
+        return false;
+    }
+    
+    const MessageHeader& header = message->getHeader();
+    uint32_t messageId = header.baseId();
+    LOG_DEBUG("Processing message ID {} from client {}", messageId, connectionId.value());
+    
+    if (messageId == MessageIds::GATEWAY_HELLO || messageId == MessageIds::GATEWAY_FORWARD ||
+        messageId == MessageIds::GATEWAY_CLOSE) {
+        // 未启用复用时不接受网关帧，逻辑会话内也不允许再嵌套
+        // 网关控制帧不压缩（其中转发的内层帧可以压缩）
+        if (!gatewayMux || connectionId.isMultiplexed() || header.isCompressed()) {
+            LOG_WARN("Unexpected gateway message {} from client {}", messageId, connectionId.value());
+            return false;
+        }
+        return handleGatewayFrame(connectionId, *message);
+    }
+    
+    // 心跳只用于刷新连接的活跃时间（收到数据时已刷新），不投递到主循环
+    if (messageId == MessageIds::HEARTBEAT) {
+        return true;
+    }
+    
+    // 压缩帧不在reactor线程解压，整帧交给主循环展开后再转换
+    if (header.isCompressed()) {
+        if (mainLoop_ &&
+            !mainLoop_->addMessage(std::make_unique<Message>(MessageType::COMPRESSED_FRAME, frame, connectionId))) {
+            rejectBusy(connectionId, messageId);
+        }
+        return true;
+    }
+    
+    // 使用主循环处理消息 - 如果主循环存在，将消息转换为Message后添加到队列
+    if (mainLoop_) {
+        auto messagePtr = convertNetworkMessageToMessage(*message, connectionId);
+        if (messagePtr && !mainLoop_->addMessage(std::move(messagePtr))) {
+            rejectBusy(connectionId, messageId);
+        }
+    }
+    
+    return true;
+}
+
+void NetworkServer::rejectBusy(ConnectionId connectionId, uint32_t messageId)
+{
+    // 主循环队列已满时请求被丢弃，直接答复错误，客户端（如LOGIN/REGISTER）不会一直等待响应
+    sendNetworkMessage(connectionId, MessageUtils::createErrorResponse(messageId, "Server busy, please retry"));
+}
+
+void NetworkServer::onUdpMessage(ConnectionId connectionId, const BufferSlice& message, UdpChannel channel)
+{
+    (void)channel;
+    // 数据报不会把帧拆开或合并，长度与帧头不符的消息直接丢弃
+    if (MessageParser::getCompleteMessageSize(message.data(), message.size()) != message.size()) {
+        LOG_WARN("Dropping malformed UDP message of {} bytes from session {}", message.size(), connectionId.slot());
+        return;
+    }
+    dispatchFrame(connectionId, message);
+}
+
+void NetworkServer::onSharedMemoryMessage(uint32_t channelId, const BufferSlice& frame)
+{
+    if (MessageParser::getCompleteMessageSize(frame.data(), frame.size()) != frame.size()) {
+        LOG_WARN("Dropping malformed frame of {} bytes from shared memory channel {}", frame.size(), channelId);
+        return;
+    }
+    dispatchFrame(ConnectionId::sharedMemory(channelId), frame);
+}
+
+bool NetworkServer::handleGatewayFrame(ConnectionId link, const NetworkMessage& message)
+{
+    const BufferSlice& body = message.getBody().getSlice();
+    uint32_t messageId = message.getHeader().messageId;
+    
+    if (messageId == MessageIds::GATEWAY_HELLO) {
+        if (body.view() != gatewayToken) {
+            LOG_WARN("Gateway link {} presented an invalid token", link.value());
+            return false;
+        }
+        if (gatewayMux->addLink(link)) {
+            // 链路本身不走登录流程，认证后只受心跳超时约束
+            setClientAuthenticated(link);
+            LOG_INFO("Gateway link {} established", link.value());
+        }
+        return sendNetworkMessage(link, NetworkMessage(MessageIds::GATEWAY_HELLO, MessageBody()));
+    }
+    
+    if (!gatewayMux->isLink(link)) {
+        LOG_WARN("Gateway message {} from client {} before GATEWAY_HELLO", messageId, link.value());
+        return false;
+    }
+    
+    uint32_t sessionId = 0;
+    BufferSlice inner;
+    if (!GatewayMux::decodeSessionId(body, sessionId, inner)) {
+        LOG_WARN("Malformed gateway message {} from link {}", messageId, link.value());
+        return false;
+    }
+    
+    if (messageId == MessageIds::GATEWAY_CLOSE) {
+        ConnectionId closed = gatewayMux->closeSession(link, sessionId);
+        if (closed.isValid()) {
+            LOG_DEBUG("Gateway session {} on link {} closed by gateway", closed.value(), link.value());
+        }
+        return true;
+    }
+    
+    // 单个会话的坏帧只丢弃该帧，不断开承载其他会话的链路
+    if (MessageParser::getCompleteMessageSize(inner.data(), inner.size()) != inner.size()) {
+        LOG_WARN("Dropping malformed frame of {} bytes from gateway session {} on link {}", inner.size(), sessionId, link.value());
+        return true;
+    }
+    
+    ConnectionId sessionConnection = gatewayMux->openSession(link, sessionId);
+    if (!sessionConnection.isValid()) {
+        // 会话数已达上限，让网关断开该玩家
+        LOG_WARN("Gateway session limit reached, rejecting session {} on link {}", sessionId, link.value());
+        sendFrameToClient(link, GatewayMux::encodeClose(sessionId));
+        return true;
+    }
+    
+    dispatchFrame(sessionConnection, inner);
+    return true;
+}
+
+void NetworkServer::closeGatewayLink(ConnectionId link)
+{
+    if (!gatewayMux || !gatewayMux->isLink(link)) {
+        return;
+    }
+    std::vector<ConnectionId> sessions = gatewayMux->removeLink(link);
+    LOG_INFO("Gateway link {} closed, dropped {} session(s)", link.value(), sessions.size());
+}
+
+bool NetworkServer::closeGatewaySession(ConnectionId connectionId)
+{
+    ConnectionId link;
+    uint32_t sessionId = 0;
+    if (!gatewayMux || !gatewayMux->closeSession(connectionId, link, sessionId)) {
+        return false;
+    }
+    return sendFrameToClient(link, GatewayMux::encodeClose(sessionId));
+}
+
+size_t NetworkServer::getGatewaySessionCount() const
+{
+    return gatewayMux ? gatewayMux->sessionCount() : 0;
+}
+
+bool NetworkServer::takeOver(std::vector<socket_t>& listeners, socket_t& unixListener, std::vector<HandoverConnection>& connections)
+{
+    std::unique_ptr<HotRestart> channel = HotRestart::connect(handoverSocketPath);
+    if (!channel) {
+        return false;
+    }
+    
+    LOG_INFO("Taking over from the running server via {}", handoverSocketPath);
+    if (!channel->receiveListeners(listeners, unixListener)) {
+        LOG_ERROR("Failed to receive listening sockets from the running server, binding new ones");
+        return false;
+    }
+    
+    // 旧进程先等主循环处理完已收到的请求再发送连接，这段时间新连接在监听队列中等待
+    HandoverConnection connection;
+    bool finished = false;
+    while (channel->receiveConnection(connection, finished)) {
+        connections.push_back(std::move(connection));
+        connection = HandoverConnection();
+    }
+    if (!finished) {
+        LOG_WARN("Handover ended early after {} connection(s)", connections.size());
+    }
+    return true;
+}
+
+void NetworkServer::adoptConnection(Reactor& reactor, HandoverConnection& handover)
+{
+    socket_t clientSocket = handover.socket;
+    ConnectionId connectionId = addClient(clientSocket, &reactor);
+    if (!connectionId.isValid())
+    {
+        LOG_ERROR("Failed to add inherited client socket {}: connection table is full", clientSocket);
+        CLOSE_SOCKET(clientSocket);
+        return;
+    }
+    reactor.connections.erase(clientSocket);
+    Connection* connection = reactor.connections.insert(clientSocket);
+    connection->id = connectionId;
+    
+    if (!reactor.ioManager->addClient(clientSocket))
+    {
+        LOG_ERROR("Failed to register inherited client socket {}: {}", clientSocket, GET_LAST_ERROR());
+        reactor.connections.erase(clientSocket);
+        removeClient(clientSocket);
+        CLOSE_SOCKET(clientSocket);
+        return;
+    }
+    
+    // 已登录的连接和网关链路不需要重新登录或认证，会话在收到网关的下一帧时重新建立
+    if (handover.authenticated) {
+        setClientAuthenticated(connectionId);
+    }
+    if (handover.gatewayLink && gatewayMux) {
+        gatewayMux->addLink(connectionId);
+        connection->rateLimitExempt = true;
+    }
+    
+    Reactor* reactorPtr = &reactor;
+    connection->lastActiveMs = reactor.timers.now();
+    connection->timer.callback = [this, reactorPtr, clientSocket]() {
+        onConnectionTimeout(*reactorPtr, clientSocket);
+    };
+    if (!handover.authenticated && loginTimeoutMs > 0) {
+        connection->loginPending = true;
+        reactor.timers.schedule(connection->timer, loginTimeoutMs);
+    } else if (idleTimeoutMs > 0) {
+        reactor.timers.schedule(connection->timer, idleTimeoutMs);
+    }
+    
+    // 旧进程没发出的数据排在本进程的响应之前
+    if (!handover.outbound.empty()) {
+        queueSend(reactor, clientSocket, BufferSlice(std::move(handover.outbound)));
+    }
+    
+    // 入站数据中可能有完整的帧（交接期间收到的或被限速延后的），走限速定时器的路径在事件循环中投递
+    if (!handover.inbound.empty()) {
+        connection->inbound.append(handover.inbound.data(), handover.inbound.size());
+        connection->throttled = true;
+        connection->throttleTimer.callback = [this, reactorPtr, clientSocket]() {
+            onThrottleTimer(*reactorPtr, clientSocket);
+        };
+        reactor.timers.schedule(connection->throttleTimer, 1);
+    }
+    
+    eventDispatcher.notifyClientConnected(clientSocket);
+}
+
+void NetworkServer::runHandoverListener()
+{
+#ifndef _WIN32
+    while (isRunning) {
+        struct pollfd request;
+        request.fd = handoverListenSocket;
+        request.events = POLLIN;
+        request.revents = 0;
+        // 定期检查isRunning，关闭时不需要额外的唤醒fd
+        if (poll(&request, 1, 500) <= 0) {
+            continue;
+        }
+        
+        std::unique_ptr<HotRestart> channel = HotRestart::accept(handoverListenSocket);
+        if (!channel) {
+            continue;
+        }
+        // 只交接一次；不删除套接字文件，新进程启动完成后在同一路径上重新监听
+        CLOSE_SOCKET(handoverListenSocket);
+        handoverListenSocket = INVALID_SOCKET_VALUE;
+        handOver(*channel);
+        return;
+    }
+#endif
+}
+
+void NetworkServer::handOver(HotRestart& channel)
+{
+    LOG_INFO("New server process requested a handover");
+    
+    // 1. 停止accept，把监听套接字交给新进程，新进程收到后即可继续accept，监听队列中的连接不会丢失
+    std::vector<socket_t> listeners;
+    socket_t unixListener = INVALID_SOCKET_VALUE;
+    for (auto& reactor : reactors_) {
+        Reactor* reactorPtr = reactor.get();
+        auto stopAccepting = [reactorPtr]() {
+            reactorPtr->ioManager->removeSocket(reactorPtr->listenSocket);
+            if (reactorPtr->unixListenSocket != INVALID_SOCKET_VALUE) {
+                reactorPtr->ioManager->removeSocket(reactorPtr->unixListenSocket);
+            }
+        };
+        if (!runInReactor(*reactor, stopAccepting)) {
+            stopAccepting();
+        }
+        listeners.push_back(reactor->listenSocket);
+        if (reactor->unixListenSocket != INVALID_SOCKET_VALUE) {
+            unixListener = reactor->unixListenSocket;
+        }
+    }
+    
+    if (!channel.sendListeners(listeners, unixListener)) {
+        LOG_ERROR("Handover failed, resuming accepting connections");
+        for (auto& reactor : reactors_) {
+            registerListener(*reactor, reactor->listenSocket);
+            if (reactor->unixListenSocket != INVALID_SOCKET_VALUE) {
+                registerListener(*reactor, reactor->unixListenSocket);
+            }
+        }
+        return;
+    }
+    
+    // 新进程已持有副本，关闭本进程的监听套接字；AF_UNIX套接字文件归新进程，关闭时不删除
+    for (auto& reactor : reactors_) {
+        Reactor* reactorPtr = reactor.get();
+        auto forgetListeners = [reactorPtr]() {
+            reactorPtr->listenSocket = INVALID_SOCKET_VALUE;
+            reactorPtr->unixListenSocket = INVALID_SOCKET_VALUE;
+        };
+        if (!runInReactor(*reactor, forgetListeners)) {
+            forgetListeners();
+        }
+    }
+    for (socket_t listenSocket : listeners) {
+        CLOSE_SOCKET(listenSocket);
+    }
+    if (unixListener != INVALID_SOCKET_VALUE) {
+        CLOSE_SOCKET(unixListener);
+    }
+    
+    // 2. UDP会话和共享内存通道不交接（客户端重连到新进程），停止后新进程可以绑定同一端口和路径
+    if (udpTransport) {
+        udpTransport->stop();
+    }
+    if (sharedMemoryTransport) {
+        sharedMemoryTransport->stop();
+    }
+    
+    // 3. 冻结连接：此后收到的数据只留在入站缓冲区，等主循环处理完已投递的请求，响应进入发送队列
+    std::vector<Reactor*> migrating;
+    for (auto& reactor : reactors_) {
+        Reactor* reactorPtr = reactor.get();
+        if (reactor->ioManager->canReleaseSockets() &&
+            runInReactor(*reactor, [reactorPtr]() { reactorPtr->handingOver = true; })) {
+            migrating.push_back(reactorPtr);
+        } else {
+            LOG_WARN("Reactor {} backend cannot hand over connections, they stay here until they drain", reactor->index);
+        }
+    }
+    auto drainDeadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (mainLoop_ && !mainLoop_->isIdle() && std::chrono::steady_clock::now() < drainDeadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    
+    // 4. 在各reactor线程中摘下连接，取出入站缓冲区和发送队列中剩余的数据；不分发断开事件，连接在新进程中继续
+    std::vector<HandoverConnection> released;
+    for (Reactor* reactor : migrating) {
+        runInReactor(*reactor, [this, reactor, &released]() {
+            std::vector<socket_t> sockets;
+            reactor->connections.forEach([&sockets](socket_t clientSocket, const Connection& connection) {
+                (void)connection;
+                sockets.push_back(clientSocket);
+            });
+            for (socket_t clientSocket : sockets) {
+                Connection* connection = reactor->connections.find(clientSocket);
+                HandoverConnection handover;
+                if (!reactor->ioManager->releaseSocket(clientSocket, handover.outbound)) {
+                    continue;
+                }
+                ConnectionId connectionId = connection->id;
+                handover.socket = clientSocket;
+                handover.reactorIndex = reactor->index;
+                handover.authenticated = isClientAuthenticated(clientSocket);
+                handover.gatewayLink = gatewayMux && gatewayMux->isLink(connectionId);
+                handover.inbound.assign(reinterpret_cast<const char*>(connection->inbound.data()), connection->inbound.size());
+                reactor->connections.erase(clientSocket);
+                removeClient(clientSocket);
+                closeGatewayLink(connectionId);
+                released.push_back(std::move(handover));
+            }
+        });
+    }
+    
+    // 5. 逐个发送，发送后关闭本进程的fd；发送失败的连接随之断开，客户端重连即可
+    size_t transferred = 0;
+    for (const HandoverConnection& handover : released) {
+        if (channel.sendConnection(handover)) {
+            ++transferred;
+        }
+        CLOSE_SOCKET(handover.socket);
+    }
+    channel.sendFinished();
+    handedOver = true;
+    LOG_INFO("Handed over {} of {} connection(s) to the new server process", transferred, released.size());
+}
+
+bool NetworkServer::runInReactor(Reactor& reactor, std::function<void()> task)
+{
+    auto done = std::make_shared<std::promise<void>>();
+    std::future<void> finished = done->get_future();
+    if (!reactor.ioManager->runInLoop([task, done]() {
+            task();
+            done->set_value();
+        })) {
+        return false;
+    }
+    finished.wait();
+    return true;
+}
+
+void NetworkServer::onWriteEvent(const IOEvent& event)
+{
+    LOG_DEBUG("Processing write event for socket {}", event.socket);
+    
+    // 分发数据发送事件
+    eventDispatcher.notifyDataSent(event.socket, event.data.size());
+}
+
+void NetworkServer::onErrorEvent(Reactor& reactor, const IOEvent& event)
+{
+    LOG_DEBUG("Processing error event for socket {}", event.socket);
+    
+    closeConnection(reactor, event.socket);
 }
 
-bool NetworkServer::start()
+void NetworkServer::closeConnection(Reactor& reactor, socket_t clientSocket)
 {
-    LOG_INFO("Starting server...");
-    isRunning = true;
+    Connection* connection = reactor.connections.find(clientSocket);
+    ConnectionId connectionId = connection ? connection->id : ConnectionId();
     
-    // 启动异步I/O事件循环
-    if (!asyncIoManager->startEventLoop())
-    {
-        LOG_ERROR("Failed to start async I/O event loop: {}", GET_LAST_ERROR());
-        isRunning = false;
-        return false;
-    }
+    // 从事件循环注销后再移除客户端套接字并关闭连接
+    reactor.ioManager->removeClient(clientSocket);
+    reactor.connections.erase(clientSocket);
+    removeClient(clientSocket);
+    CLOSE_SOCKET(clientSocket);
+    closeGatewayLink(connectionId);
     
-    LOG_INFO("Server started successfully");
-    return true;
+    // 分发客户端断开连接事件
+    eventDispatcher.notifyClientDisconnected(clientSocket);
 }
 
-// 统一的网络事件处理器
-void NetworkServer::handleAsyncIOEvent(const IOEvent& event) {
-    switch (event.eventType) {
-        case IOEventType::ACCEPT:
-            onAcceptEvent(event);
-            break;
-        case IOEventType::READ:
-            onReadEvent(event);
-            break;
-        case IOEventType::WRITE:
-            onWriteEvent(event);
-            break;
-        case IOEventType::IOERROR:
-        default:
-            onErrorEvent(event);
-            break;
+uint64_t NetworkServer::steadyNowMs()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void NetworkServer::onTimerTick(Reactor& reactor)
+{
+    reactor.timers.advance(steadyNowMs());
+    
+    // 定时器回调中不能销毁定时器所在的连接记录，推进结束后再关闭超时的连接
+    for (socket_t clientSocket : reactor.expiredSockets) {
+        // 同一连接可能有多个定时器同时到期
+        if (reactor.connections.find(clientSocket)) {
+            closeConnection(reactor, clientSocket);
+        }
     }
+    reactor.expiredSockets.clear();
 }
 
-void NetworkServer::onAcceptEvent(const IOEvent& event)
+void NetworkServer::onConnectionTimeout(Reactor& reactor, socket_t clientSocket)
 {
-    if (event.socket != serverSocket) {
-        LOG_WARN("Received accept event for non-server socket");
+    Connection* connection = reactor.connections.find(clientSocket);
+    if (!connection) {
         return;
     }
     
-    LOG_DEBUG("Processing accept event for server socket");
-    
-    struct sockaddr_in clientAddr;
-    int clientAddrSize = sizeof(clientAddr);
-    
-    socket_t clientSocket = accept(serverSocket, (struct sockaddr*)&clientAddr, &clientAddrSize);
-    if (clientSocket == INVALID_SOCKET_VALUE)
-    {
-        if (isRunning.load())
-        {
-        #ifdef _WIN32
-            int errorCode = WSAGetLastError();
-            if (errorCode != WSAEWOULDBLOCK)
-            {
-                LOG_ERROR("Accept failed: {}", errorCode);
-            }
-        #else
-            int errorCode = errno;
-            if (errorCode != EAGAIN && errorCode != EWOULDBLOCK)
-            {
-                LOG_ERROR("Accept failed: {}", strerror(errorCode));
-            }
-        #endif
+    if (connection->loginPending) {
+        connection->loginPending = false;
+        if (!isClientAuthenticated(clientSocket)) {
+            LOG_INFO("Client {} did not log in within {} s, closing connection", clientSocket, loginTimeoutMs / 1000);
+            reactor.expiredSockets.push_back(clientSocket);
+            return;
         }
-        return;
     }
     
-#ifndef _WIN32
-    // 设置客户端套接字为非阻塞模式 (仅在Unix系统)
-    int flags = fcntl(clientSocket, F_GETFL, 0);
-    if (flags >= 0) {
-        fcntl(clientSocket, F_SETFL, flags | O_NONBLOCK);
+    if (idleTimeoutMs == 0) {
+        return;
     }
-#endif
-    
-    // 获取客户端IP地址
-    #ifdef _WIN32
-        char clientIP[46]; // Windows下，IPv6地址的最大长度是46字符
-        inet_ntop(AF_INET, &(clientAddr.sin_addr), clientIP, sizeof(clientIP));
-    #else
-        char clientIP[INET_ADDRSTRLEN];
-        inet_ntop(AF_INET, &(clientAddr.sin_addr), clientIP, sizeof(clientIP));
-    #endif
-    LOG_INFO("New client connected from {}:{}", clientIP, ntohs(clientAddr.sin_port));
     
-    // 添加客户端到列表
-    addClient(clientSocket);
+    // 期间收到过数据则按最近一次收到数据的时间重新计时
+    uint64_t idleMs = reactor.timers.now() - connection->lastActiveMs;
+    if (idleMs >= idleTimeoutMs) {
+        LOG_INFO("Client {} missed heartbeats for {} ms, closing connection", clientSocket, idleMs);
+        reactor.expiredSockets.push_back(clientSocket);
+        return;
+    }
+    reactor.timers.schedule(connection->timer, idleTimeoutMs - idleMs);
+}
+
+void NetworkServer::onBackpressureEvent(Reactor& reactor, const IOEvent& event)
+{
+    Connection* connection = reactor.connections.find(event.socket);
+    if (!connection) {
+        return;
+    }
     
-    // 注册客户端套接字到异步I/O管理器
-    if (!asyncIoManager->addClient(clientSocket))
-    {
-        LOG_ERROR("Failed to register client socket with async I/O manager: {}", GET_LAST_ERROR());
-        removeClient(clientSocket);
-        CLOSE_SOCKET(clientSocket);
+    if (event.eventType == IOEventType::LOW_WATERMARK) {
+        LOG_DEBUG("Client {} outbound queue drained, reading resumed", event.socket);
+        connection->stallTimer.cancel();
         return;
     }
     
-    // 发送欢迎消息
-    sendToClient(clientSocket, "Welcome to Account Server! Please login.");
+    LOG_DEBUG("Client {} outbound queue above high watermark, reading paused", event.socket);
+    if (slowClientTimeoutMs == 0) {
+        return;
+    }
     
-    // 分发客户端连接事件
-    eventDispatcher.notifyClientConnected(clientSocket);
+    Reactor* reactorPtr = &reactor;
+    socket_t clientSocket = event.socket;
+    connection->stallTimer.callback = [this, reactorPtr, clientSocket]() {
+        LOG_WARN("Client {} stayed above the outbound high watermark for {} s, closing connection",
+                 clientSocket, slowClientTimeoutMs / 1000);
+        reactorPtr->expiredSockets.push_back(clientSocket);
+    };
+    reactor.timers.schedule(connection->stallTimer, slowClientTimeoutMs);
 }
 
-void NetworkServer::onReadEvent(const IOEvent& event)
+bool NetworkServer::isClientAuthenticated(socket_t clientSocket)
 {
-    if (event.data.empty()) {
-        LOG_DEBUG("Received empty read event for socket {}", event.socket);
+    std::lock_guard<std::mutex> lock(clientsMutex);
+    ClientEntry* entry = clients.find(clientSocket);
+    return entry && entry->authenticated;
+}
+
+void NetworkServer::setClientAuthenticated(ConnectionId connectionId)
+{
+    // UDP会话、共享内存通道和网关逻辑会话没有登录期限，不需要标记
+    if (connectionId.isDatagram() || connectionId.isSharedMemory() || connectionId.isMultiplexed()) {
         return;
     }
     
-    LOG_DEBUG("Processing read event for socket {} with {} bytes", event.socket, event.data.size());
-    
-    // 将数据转换为字节向量并分发给监听器
-    std::vector<uint8_t> data(event.data.begin(), event.data.end());
-    eventDispatcher.notifyDataReceived(event.socket, data);
-    
-    // 将数据处理逻辑也在这里处理，以保持一致性
-    // 注意：这里的消息处理逻辑与processNetworkMessage相同，保持一致性
-    try {
-        // 获取或创建客户端的消息缓冲区
-        auto& buffer = messageBuffers_[event.socket];
-        buffer.insert(buffer.end(), data.begin(), data.end());
-        
-        // 尝试解析完整消息
-        while (buffer.size() >= sizeof(MessageHeader)) {
-            // 检查是否包含完整消息
-            if (!MessageParser::isCompleteMessage(buffer)) {
-                break; // 数据不完整，等待更多数据
-            }
-            
-            // 解析消息
-            auto message = MessageParser::parseMessage(buffer);
-            if (!message) {
-                LOG_WARN("Failed to parse message from client {}", event.socket);
-                // 清除缓冲区以避免无限循环
-                buffer.clear();
-                break;
-            }
-            
-            LOG_DEBUG("Processing message ID {} from client {}", 
-                     message->getHeader().messageId, event.socket);
-            
-            // 使用主循环处理消息 - 如果主循环存在，将消息转换为Message后添加到队列
-            if (mainLoop_) {
-                auto messagePtr = convertNetworkMessageToMessage(*message, event.socket);
-                if (messagePtr) {
-                    mainLoop_->addMessage(std::move(messagePtr));
-                }
-            }
-            
-            // 从缓冲区中移除已处理的消息
-            size_t messageSize = message->getTotalSize();
-            if (messageSize <= buffer.size()) {
-                buffer.erase(buffer.begin(), buffer.begin() + messageSize);
-            } else {
-                buffer.clear(); // 防止数据不一致
-                break;
-            }
-        }
-        
-        // 如果缓冲区太大，清理它（防止内存攻击）
-        if (buffer.size() > 64 * 1024) { // 64KB
-            LOG_WARN("Message buffer too large for client {}, clearing", event.socket);
-            buffer.clear();
-        }
-        
-    } catch (const std::exception& e) {
-        LOG_ERROR("Exception processing network message from client {}: {}", event.socket, e.what());
-        // 发送错误响应
-        NetworkMessage errorResponse = MessageUtils::createErrorResponse(0, "Internal server error");
-        sendNetworkMessage(event.socket, errorResponse);
+    std::lock_guard<std::mutex> lock(clientsMutex);
+    ClientEntry* entry = findClient(connectionId);
+    if (entry) {
+        entry->authenticated = true;
+    } else {
+        LOG_DEBUG("Client {} closed before login completed", connectionId.value());
     }
 }
 
-void NetworkServer::onWriteEvent(const IOEvent& event)
+ConnectionId NetworkServer::getConnectionId(socket_t clientSocket)
 {
-    LOG_DEBUG("Processing write event for socket {}", event.socket);
-    
-    // 分发数据发送事件
-    eventDispatcher.notifyDataSent(event.socket, 0); // 这里可以传递实际发送的字节数
+    std::lock_guard<std::mutex> lock(clientsMutex);
+    ClientEntry* entry = clients.find(clientSocket);
+    return entry ? ConnectionId(clients.slotOf(clientSocket), entry->generation) : ConnectionId();
 }
 
-void NetworkServer::onErrorEvent(const IOEvent& event)
+NetworkServer::ClientEntry* NetworkServer::findClient(ConnectionId connectionId)
 {
-    LOG_DEBUG("Processing error event for socket {}", event.socket);
-    
-    // 移除客户端套接字并关闭连接
-    removeClient(event.socket);
-    CLOSE_SOCKET(event.socket);
-    
-    // 分发客户端断开连接事件
-    eventDispatcher.notifyClientDisconnected(event.socket);
+    if (!connectionId.isValid()) {
+        return nullptr;
+    }
+    // 槽位在连接关闭后可能已分配给新连接，代数不同即视为已关闭
+    ClientEntry* entry = clients.at(connectionId.slot());
+    return entry && entry->generation == connectionId.generation() ? entry : nullptr;
 }
 
 void NetworkServer::handleClient(socket_t clientSocket)
 {
     LOG_INFO("Client {} thread started", clientSocket);
     
+    // 回复按句柄发送，线程结束后fd被复用时不会发给新连接
+    ConnectionId connectionId = getConnectionId(clientSocket);
+    
     // 发送欢迎消息
-    sendToClient(clientSocket, "Welcome to Account Server! Please login.");
+    sendToClient(connectionId, "Welcome to Account Server! Please login.");
     
     char buffer[1024];
     while (isServerRunning())
@@ -429,9 +1560,8 @@ void NetworkServer::handleClient(socket_t clientSocket)
                 password.erase(std::remove(password.begin(), password.end(), '\r'), password.end());
                 password.erase(std::remove(password.begin(), password.end(), '\n'), password.end());
                 
-                // 创建登录消息，包含客户端ID
-                std::string clientId = std::to_string(clientSocket);
-                message = std::make_unique<LoginMessage>(username, password, clientId);
+                // 创建登录消息，包含连接句柄
+                message = std::make_unique<LoginMessage>(username, password, connectionId);
             }
         }
         // 注册消息格式: REGISTER:username:password:email
@@ -455,9 +1585,8 @@ void NetworkServer::handleClient(socket_t clientSocket)
                 email.erase(std::remove(email.begin(), email.end(), '\r'), email.end());
                 email.erase(std::remove(email.begin(), email.end(), '\n'), email.end());
                 
-                // 创建注册消息，包含客户端ID
-                std::string clientId = std::to_string(clientSocket);
-                message = std::make_unique<RegisterMessage>(username, password, email, clientId);
+                // 创建注册消息，包含连接句柄
+                message = std::make_unique<RegisterMessage>(username, password, email, connectionId);
             }
         }
         
@@ -467,7 +1596,11 @@ void NetworkServer::handleClient(socket_t clientSocket)
             try {
                 // 如果主循环存在，直接将消息添加到主循环的消息队列
                 if (mainLoop_) {
-                    mainLoop_->addMessage(std::move(message));
+                    if (!mainLoop_->addMessage(std::move(message))) {
+                        // 文本协议的请求没有消息ID，按文本响应答复
+                        sendResponseToClient(connectionId, ResponseType::SERVICE_ERROR, "Server busy, please retry", "");
+                        continue;
+                    }
                 }
                 else {
                     // 如果没有主循环，则使用网络服务器自己的消息队列（向后兼容）
@@ -475,17 +1608,17 @@ void NetworkServer::handleClient(socket_t clientSocket)
                 }
                 
                 // 发送确认消息给客户端
-                sendToClient(clientSocket, "Message received and queued for processing.");
+                sendToClient(connectionId, "Message received and queued for processing.");
             }
             catch (const std::exception& e) {
                 LOG_ERROR("Failed to queue message: {}", e.what());
-                sendToClient(clientSocket, "ERROR: Failed to queue message.");
+                sendToClient(connectionId, "ERROR: Failed to queue message.");
             }
         }
         else
         {
             // 无法识别的消息格式
-            sendToClient(clientSocket, "ERROR: Unrecognized message format.");
+            sendToClient(connectionId, "ERROR: Unrecognized message format.");
         }
         
         // 如果是登录请求，并且解析成功，我们仍然需要等待主线程处理
@@ -557,33 +1690,74 @@ std::string NetworkServer::processLoginRequest(const std::string& request, Netwo
     return "ERROR:Invalid login format. Use LOGIN:username:password";
 }
 
-bool NetworkServer::sendToClient(socket_t clientSocket, const std::string& message)
+bool NetworkServer::sendToClient(ConnectionId connectionId, const std::string& message)
+{
+    // UDP、共享内存和网关转发的消息自带边界，不追加换行
+    if (connectionId.isDatagram() || connectionId.isSharedMemory() || connectionId.isMultiplexed()) {
+        return sendFrameToClient(connectionId, BufferSlice(message));
+    }
+    return sendFrameToClient(connectionId, BufferSlice(message + "\n"));
+}
+
+bool NetworkServer::sendFrameToClient(ConnectionId connectionId, const BufferSlice& frame)
 {
-    std::string fullMessage = message + "\n";
-    int bytesSent = send(static_cast<SOCKET>(clientSocket), fullMessage.c_str(), static_cast<int>(fullMessage.length()), 0);
+    if (connectionId.isMultiplexed()) {
+        // 包装为GATEWAY_FORWARD后经会话所在的链路发出，链路可以是任意传输
+        ConnectionId link;
+        uint32_t sessionId = 0;
+        if (!gatewayMux || !gatewayMux->resolve(connectionId, link, sessionId)) {
+            LOG_DEBUG("Gateway session {} already closed, dropping message", connectionId.value());
+            return false;
+        }
+        return sendFrameToClient(link, GatewayMux::encodeForward(sessionId, frame));
+    }
+    if (connectionId.isDatagram()) {
+        return udpTransport && udpTransport->send(connectionId.slot(), connectionId.transportGeneration(), frame);
+    }
+    if (connectionId.isSharedMemory()) {
+        return sharedMemoryTransport && sharedMemoryTransport->send(connectionId.slot(), frame);
+    }
     
-    if (bytesSent == SOCKET_ERROR_VAL)
+    socket_t clientSocket = INVALID_SOCKET_VALUE;
+    Reactor* reactor = nullptr;
     {
-        LOG_ERROR("Send to client {} failed: {}", static_cast<int>(clientSocket), GET_LAST_ERROR());
-        return false;
+        std::lock_guard<std::mutex> lock(clientsMutex);
+        ClientEntry* entry = findClient(connectionId);
+        if (entry) {
+            clientSocket = entry->socket;
+            reactor = entry->reactor;
+        }
     }
     
-    return true;
+    if (clientSocket == INVALID_SOCKET_VALUE || !reactor) {
+        LOG_DEBUG("Client {} already closed, dropping message", connectionId.value());
+        return false;
+    }
+    // 释放clientsMutex后连接仍可能关闭，由reactor线程再核对一次句柄
+    return queueSend(*reactor, clientSocket, connectionId, frame);
 }
 
-bool NetworkServer::sendResponseToClient(const std::string& clientId, ResponseType responseType, const std::string& message, const std::string& data)
+bool NetworkServer::sendNetworkMessage(ConnectionId connectionId, const NetworkMessage& message)
 {
-    try {
-        int clientSocket = std::stoi(clientId);
-        std::string response = "RESPONSE:" + std::to_string(static_cast<int>(responseType)) + ":" + message;
-        if (!data.empty()) {
-            response += ":" + data;
-        }
-        return sendToClient(clientSocket, response);
-    } catch (const std::exception& e) {
-        LOG_ERROR("Failed to send response to client {}: {}", clientId, e.what());
+    return sendFrameToClient(connectionId, encodeFrame(message));
+}
+
+bool NetworkServer::sendResponseToClient(ConnectionId connectionId, ResponseType responseType, const std::string& message, const std::string& data)
+{
+    std::string response = "RESPONSE:" + std::to_string(static_cast<int>(responseType)) + ":" + message;
+    if (!data.empty()) {
+        response += ":" + data;
+    }
+    return sendToClient(connectionId, response);
+}
+
+bool NetworkServer::sendUdpMessage(ConnectionId connectionId, const NetworkMessage& message, UdpChannel channel)
+{
+    if (!connectionId.isDatagram() || !udpTransport) {
+        LOG_ERROR("Client {} has no reliable UDP session", connectionId.value());
         return false;
     }
+    return udpTransport->send(connectionId.slot(), connectionId.transportGeneration(), encodeFrame(message), channel);
 }
 
 std::string NetworkServer::receiveFromClient(socket_t clientSocket)
@@ -600,43 +1774,161 @@ std::string NetworkServer::receiveFromClient(socket_t clientSocket)
     return std::string(buffer, bytesReceived);
 }
 
-void NetworkServer::addClient(socket_t clientSocket)
+ConnectionId NetworkServer::addClient(socket_t clientSocket, Reactor* reactor)
 {
     std::lock_guard<std::mutex> lock(clientsMutex);
-    clientSockets.push_back(clientSocket);
-    clientInfo[clientSocket] = "Connected";
+    ClientEntry* entry = clients.find(clientSocket);
+    if (!entry)
+    {
+        entry = clients.insert(clientSocket);
+        if (!entry) {
+            return ConnectionId();
+        }
+    }
+    entry->info = "Connected";
+    entry->reactor = reactor;
+    entry->authenticated = false;
+    entry->socket = clientSocket;
+    // 每个连接使用新的代数，旧连接的句柄不会匹配复用同一槽位的新连接；0保留为无效值，最高两位保留给其他传输
+    entry->generation = nextGeneration++;
+    if ((nextGeneration & ConnectionId::TRANSPORT_MASK) != 0) {
+        nextGeneration = 1;
+    }
+    return ConnectionId(clients.slotOf(clientSocket), entry->generation);
 }
 
 void NetworkServer::removeClient(socket_t clientSocket)
 {
     std::lock_guard<std::mutex> lock(clientsMutex);
     
-    auto it = std::find(clientSockets.begin(), clientSockets.end(), clientSocket);
-    if (it != clientSockets.end())
+    // 连接的入站缓冲区由所属reactor在其线程中清理
+    clients.erase(clientSocket);
+    groups.leaveAll(clientSocket);
+}
+
+NetworkServer::Reactor* NetworkServer::findReactor(socket_t clientSocket)
+{
+    std::lock_guard<std::mutex> lock(clientsMutex);
+    ClientEntry* entry = clients.find(clientSocket);
+    return entry ? entry->reactor : nullptr;
+}
+
+void NetworkServer::broadcastMessage(const std::string& message)
+{
+    // 只编码一次，所有连接共享
+    broadcastFrame(BufferSlice(message + "\n"));
+}
+
+void NetworkServer::broadcastNetworkMessage(const NetworkMessage& message)
+{
+    // 只压缩一次，所有连接共享压缩后的帧
+    broadcastFrame(encodeFrame(message));
+}
+
+void NetworkServer::broadcastFrame(const BufferSlice& frame)
+{
+    if (frame.empty()) {
+        return;
+    }
+    
+    // 持锁期间只按所属reactor收集目标连接及其句柄
+    std::vector<std::vector<SendTarget>> targets(reactors_.size());
     {
-        clientSockets.erase(it);
+        std::lock_guard<std::mutex> lock(clientsMutex);
+        clients.forEach([this, &targets](socket_t clientSocket, const ClientEntry& entry) {
+            if (entry.reactor) {
+                targets[entry.reactor->index].emplace_back(clientSocket, ConnectionId(clients.slotOf(clientSocket), entry.generation));
+            }
+        });
     }
     
-    clientInfo.erase(clientSocket);
+    // 每个reactor投递一次，由其事件循环线程核对句柄后把切片的引用加入各连接的发送队列
+    for (auto& reactor : reactors_) {
+        if (!targets[reactor->index].empty()) {
+            queueSendBatch(*reactor, std::make_shared<const std::vector<SendTarget>>(std::move(targets[reactor->index])), frame);
+        }
+    }
+}
+
+bool NetworkServer::createGroup(GroupManager::GroupId groupId)
+{
+    if (!groups.createGroup(groupId)) {
+        LOG_WARN("Group {} already exists", groupId);
+        return false;
+    }
+    return true;
+}
+
+bool NetworkServer::destroyGroup(GroupManager::GroupId groupId)
+{
+    return groups.destroyGroup(groupId);
+}
+
+bool NetworkServer::joinGroup(GroupManager::GroupId groupId, ConnectionId connectionId)
+{
+    // 持有clientsMutex完成校验和加入，连接不会在两者之间关闭（removeClient在同一把锁下退出所有分组）
+    std::lock_guard<std::mutex> lock(clientsMutex);
+    ClientEntry* entry = findClient(connectionId);
+    if (!entry || !entry->reactor) {
+        LOG_ERROR("Client {} is not connected", connectionId.value());
+        return false;
+    }
     
-    // 清理消息缓冲区
-    messageBuffers_.erase(clientSocket);
+    // 成员按所属reactor分组存放，发布时每个reactor整批投递
+    if (!groups.join(groupId, entry->socket, connectionId, static_cast<size_t>(entry->reactor->index))) {
+        LOG_WARN("Client {} failed to join group {} (no such group or already a member)", connectionId.value(), groupId);
+        return false;
+    }
+    return true;
 }
 
-void NetworkServer::broadcastMessage(const std::string& message)
+bool NetworkServer::leaveGroup(GroupManager::GroupId groupId, ConnectionId connectionId)
 {
     std::lock_guard<std::mutex> lock(clientsMutex);
+    ClientEntry* entry = findClient(connectionId);
+    return entry && groups.leave(groupId, entry->socket);
+}
+
+size_t NetworkServer::getGroupMemberCount(GroupManager::GroupId groupId) const
+{
+    return groups.memberCount(groupId);
+}
+
+bool NetworkServer::sendToGroup(GroupManager::GroupId groupId, const std::string& message)
+{
+    return sendFrameToGroup(groupId, BufferSlice(message + "\n"));
+}
+
+bool NetworkServer::sendNetworkMessageToGroup(GroupManager::GroupId groupId, const NetworkMessage& message)
+{
+    return sendFrameToGroup(groupId, encodeFrame(message));
+}
+
+bool NetworkServer::sendFrameToGroup(GroupManager::GroupId groupId, const BufferSlice& frame)
+{
+    // 锁内只取得各reactor成员数组的快照，释放分组锁后再整批交给对应reactor，不复制数组、不按成员查表
+    // 快照数组按发布线程复用，容量达到reactor数量后不再分配
+    thread_local std::vector<GroupManager::MemberList> members;
+    members.reserve(reactors_.size());
+    if (!groups.snapshotMembers(groupId, members)) {
+        LOG_WARN("Send to unknown group {}", groupId);
+        return false;
+    }
     
-    for (socket_t clientSocket : clientSockets)
-    {
-        sendToClient(clientSocket, message);
+    for (size_t reactorIndex = 0; reactorIndex < members.size() && reactorIndex < reactors_.size(); ++reactorIndex) {
+        if (members[reactorIndex] && !members[reactorIndex]->empty()) {
+            queueSendBatch(*reactors_[reactorIndex], std::move(members[reactorIndex]), frame);
+        }
     }
+    // 不在复用的数组中保留快照的引用，否则成员变化时会复制仍被引用的数组
+    members.clear();
+    return true;
 }
 
 int NetworkServer::getActiveConnections() const
 {
     std::lock_guard<std::mutex> lock(const_cast<std::mutex&>(clientsMutex));
-    return static_cast<int>(clientSockets.size());
+    return static_cast<int>(clients.size());
 }
 
 MessagePtr NetworkServer::getNextMessage()
@@ -660,41 +1952,123 @@ bool NetworkServer::sendAsync(socket_t clientSocket, const std::string& message)
 {
     LOG_DEBUG("Starting async send to socket {}", clientSocket);
     
-    if (!asyncIoManager) {
-        LOG_ERROR("AsyncIOManager is not initialized");
+    // 按当前占用该fd的连接的句柄发送，投递后连接关闭则由reactor线程丢弃
+    return sendFrameToClient(getConnectionId(clientSocket), BufferSlice(message));
+}
+
+bool NetworkServer::queueSend(Reactor& reactor, socket_t clientSocket, const BufferSlice& message)
+{
+    // 追加到连接的发送队列，多次发送按调用顺序写出
+    bool success = reactor.ioManager->asyncWrite(clientSocket, message, makeWriteCallback());
+    
+    if (!success) {
+        LOG_ERROR("Failed to start async write for socket {}: {}", clientSocket, GET_LAST_ERROR());
         return false;
     }
     
-    // 发送消息并等待回调
-    bool success = asyncIoManager->asyncWrite(clientSocket, message, [this, clientSocket](const IOEvent& event) {
-        if (event.eventType == IOEventType::IOERROR) {
-            LOG_ERROR("Async write failed for socket {}", clientSocket);
-            removeClient(clientSocket);
-            CLOSE_SOCKET(clientSocket);
-        } else {
-            LOG_DEBUG("Async write completed for socket {}", clientSocket);
+    return true;
+}
+
+bool NetworkServer::queueSend(Reactor& reactor, socket_t clientSocket, ConnectionId connectionId, const BufferSlice& message)
+{
+    // 句柄只能在reactor线程中与连接记录比较：调用线程释放clientsMutex后，fd可能被关闭并由accept4分配给新连接
+    Reactor* reactorPtr = &reactor;
+    bool posted = reactor.ioManager->runInLoop([this, reactorPtr, clientSocket, connectionId, message]() {
+        Connection* connection = reactorPtr->connections.find(clientSocket);
+        if (!connection || connection->id != connectionId) {
+            LOG_DEBUG("Client {} closed before the write ran, dropping message", connectionId.value());
+            return;
         }
+        queueSend(*reactorPtr, clientSocket, message);
     });
+    if (!posted) {
+        // 后端不支持runInLoop时无法在其线程中核对，直接写入
+        return queueSend(reactor, clientSocket, message);
+    }
+    return true;
+}
+
+void NetworkServer::queueSendBatch(Reactor& reactor, std::shared_ptr<const std::vector<SendTarget>> targets, const BufferSlice& frame)
+{
+    // 目标数组由批次持有引用，不复制；批次对象取自池，命令只捕获一个指针，std::function不分配内存
+    SendBatch* batch = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(reactor.sendBatchMutex);
+        if (reactor.freeSendBatches.empty()) {
+            reactor.sendBatches.push_back(std::make_unique<SendBatch>());
+            batch = reactor.sendBatches.back().get();
+            batch->server = this;
+            batch->reactor = &reactor;
+        } else {
+            batch = reactor.freeSendBatches.back();
+            reactor.freeSendBatches.pop_back();
+        }
+    }
+    batch->targets = std::move(targets);
+    batch->frame = frame;
     
-    if (!success) {
-        LOG_ERROR("Failed to start async write for socket {}: {}", clientSocket, GET_LAST_ERROR());
-        return false;
+    if (!reactor.ioManager->runInLoop([batch]() { batch->server->runSendBatch(*batch); })) {
+        // 后端不支持runInLoop时无法在其线程中核对，按fd整批写入
+        std::vector<socket_t> sockets;
+        sockets.reserve(batch->targets->size());
+        for (const SendTarget& target : *batch->targets) {
+            sockets.push_back(target.first);
+        }
+        reactor.ioManager->asyncWriteBatch(sockets, batch->frame, makeWriteCallback());
+        batch->targets.reset();
+        batch->frame = BufferSlice();
+        std::lock_guard<std::mutex> lock(reactor.sendBatchMutex);
+        reactor.freeSendBatches.push_back(batch);
+    }
+}
+
+void NetworkServer::runSendBatch(SendBatch& batch)
+{
+    Reactor& reactor = *batch.reactor;
+    AsyncIOManager::EventCallback callback = makeWriteCallback();
+    size_t skipped = 0;
+    for (const SendTarget& target : *batch.targets) {
+        // 收集目标后连接已关闭，fd可能已分配给新连接
+        Connection* connection = reactor.connections.find(target.first);
+        if (!connection || connection->id != target.second) {
+            ++skipped;
+            continue;
+        }
+        reactor.ioManager->asyncWrite(target.first, batch.frame, callback);
+    }
+    if (skipped > 0) {
+        LOG_DEBUG("Batch send skipped {} of {} closed clients on reactor {}", skipped, batch.targets->size(), reactor.index);
     }
     
-    return true;
+    // 先释放快照的引用，分组成员变化时不必为仍被引用的数组复制一份
+    batch.targets.reset();
+    batch.frame = BufferSlice();
+    std::lock_guard<std::mutex> lock(reactor.sendBatchMutex);
+    reactor.freeSendBatches.push_back(&batch);
+}
+
+AsyncIOManager::EventCallback NetworkServer::makeWriteCallback()
+{
+    // 写错误由后端通过连接的错误事件上报，在onErrorEvent中统一清理，这里只处理发送完成
+    return [this](const IOEvent& event) {
+        if (event.eventType == IOEventType::WRITE) {
+            onWriteEvent(event);
+        }
+    };
 }
 
 bool NetworkServer::startAsyncReceive(socket_t clientSocket)
 {
     LOG_DEBUG("Starting async receive for socket {}", clientSocket);
     
-    if (!asyncIoManager) {
-        LOG_ERROR("AsyncIOManager is not initialized");
+    Reactor* reactor = findReactor(clientSocket);
+    if (!reactor) {
+        LOG_ERROR("No reactor owns socket {}", clientSocket);
         return false;
     }
     
     // 启动异步接收
-    bool success = asyncIoManager->asyncRead(clientSocket, "", [this, clientSocket](const IOEvent& event) {
+    bool success = reactor->ioManager->asyncRead(clientSocket, "", [this, reactor, clientSocket](const IOEvent& event) {
         if (event.eventType == IOEventType::IOERROR) {
             LOG_ERROR("Async read failed for socket {}", clientSocket);
             removeClient(clientSocket);
@@ -709,7 +2083,7 @@ bool NetworkServer::startAsyncReceive(socket_t clientSocket)
             readEvent.data = event.data;
             
             // 处理读取的数据
-            onReadEvent(readEvent);
+            onReadEvent(*reactor, readEvent);
             
             // 继续接收下一次数据
             startAsyncReceive(clientSocket);
@@ -728,25 +2102,56 @@ void NetworkServer::shutdown()
 {
     stop();
     
-    // 关闭异步I/O管理器
-    if (asyncIoManager) {
-        asyncIoManager->shutdown();
+    // 交接线程在isRunning清除后退出；没有交接过时由本进程删除交接套接字文件
+    if (handoverThread.joinable()) {
+        handoverThread.join();
+    }
+    if (handoverListenSocket != INVALID_SOCKET_VALUE) {
+        CLOSE_SOCKET(handoverListenSocket);
+        handoverListenSocket = INVALID_SOCKET_VALUE;
+    #ifndef _WIN32
+        unlink(handoverSocketPath.c_str());
+    #endif
+    }
+    
+    if (udpTransport) {
+        udpTransport->stop();
+    }
+    if (sharedMemoryTransport) {
+        sharedMemoryTransport->stop();
+    }
+    
+    // 关闭所有reactor的异步I/O管理器（等待事件循环线程退出）
+    for (auto& reactor : reactors_) {
+        if (reactor->ioManager) {
+            reactor->ioManager->shutdown();
+        }
     }
     
     // 关闭所有客户端连接
     std::lock_guard<std::mutex> lock(clientsMutex);
-    for (socket_t clientSocket : clientSockets)
-    {
+    clients.forEach([](socket_t clientSocket, const ClientEntry& entry) {
+        (void)entry;
         CLOSE_SOCKET(clientSocket);
-    }
-    clientSockets.clear();
-    clientInfo.clear();
+    });
+    clients.clear();
     
-    // 关闭服务器套接字
-    if (serverSocket != INVALID_SOCKET_VALUE)
+    // 关闭各reactor的监听套接字
+    for (auto& reactor : reactors_)
     {
-        CLOSE_SOCKET(serverSocket);
-        serverSocket = INVALID_SOCKET_VALUE;
+        if (reactor->listenSocket != INVALID_SOCKET_VALUE)
+        {
+            CLOSE_SOCKET(reactor->listenSocket);
+            reactor->listenSocket = INVALID_SOCKET_VALUE;
+        }
+        if (reactor->unixListenSocket != INVALID_SOCKET_VALUE)
+        {
+            CLOSE_SOCKET(reactor->unixListenSocket);
+            reactor->unixListenSocket = INVALID_SOCKET_VALUE;
+        #ifndef _WIN32
+            unlink(unixSocketPath.c_str());
+        #endif
+        }
     }
     
     LOG_INFO("Server shutdown complete");
@@ -755,11 +2160,8 @@ void NetworkServer::shutdown()
 // 发送网络消息
 void NetworkServer::sendNetworkMessage(socket_t clientSocket, const NetworkMessage& message) {
     try {
-        auto data = message.serialize();
-        
         // 使用现有的sendAsync方法发送数据
-        std::string dataStr(data.begin(), data.end());
-        sendAsync(clientSocket, dataStr);
+        sendAsync(clientSocket, encodeFrame(message).toString());
         
         LOG_DEBUG("Sent message ID {} to client {}", message.getHeader().messageId, clientSocket);
     } catch (const std::exception& e) {
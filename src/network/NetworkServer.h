@@ -14,7 +14,6 @@
 #include <map>
 #include <cstring>
 #include <queue>
-#include <map>
 
 #include "ConfigManager.h"
 #include "DatabaseManager.h"
@@ -22,9 +21,19 @@
 #include "logging/Log.h"
 #include "../messaging/message.h"
 #include "../messaging/message_header.h"
+#include "../messaging/frame_compressor.h"
 #include "../handler/message_handler.h"
 #include "network/INetworkEventListener.h"
 #include "network/NetworkEventDispatcher.h"
+#include "network/InboundBuffer.h"
+#include "network/ConnectionTable.h"
+#include "network/TimingWheel.h"
+#include "network/GroupManager.h"
+#include "network/UdpTransport.h"
+#include "network/SharedMemoryTransport.h"
+#include "network/GatewayMux.h"
+#include "network/RateLimiter.h"
+#include "network/HotRestart.h"
 
 // 前向声明
 class MainLoop;
@@ -33,9 +42,68 @@ class INetworkEventListener;
 class NetworkServer
 {
 private:
-    socket_t serverSocket;
-    std::unique_ptr<AsyncIOManager> asyncIoManager;
+    // 连接上下文（仅由所属reactor线程访问，无需加锁）
+    struct Connection {
+        InboundBuffer inbound;      // 入站缓冲区，用于处理分片数据
+        TimingWheel::Timer timer;   // 登录期限/心跳超时定时器
+        uint64_t lastActiveMs = 0;  // 最近一次收到数据的时间（时间轮时钟）
+        bool loginPending = false;  // 登录期限尚未检查
+        TimingWheel::Timer stallTimer;  // 发送队列超过高水位后的断开期限
+        ConnectionId id;            // 接受连接时分配的句柄，随消息投递到主循环
+        RateLimiter limiter;        // 入站帧限速
+        TimingWheel::Timer throttleTimer;   // DELAY策略下补充令牌后继续投递入站缓冲区中的帧
+        bool throttled = false;     // 入站缓冲区中有被延后的帧，新数据只追加不解析
+        bool rateLimitExempt = false;   // 已认证的网关链路不按连接限速
+    };
+    
+    struct Reactor;
+    
+    // 一次整批发送：同一帧及其目标连接。对象由所属reactor的池复用，投递的命令只捕获它的指针
+    struct SendBatch {
+        NetworkServer* server = nullptr;
+        Reactor* reactor = nullptr;
+        GroupManager::MemberList targets;
+        BufferSlice frame;
+    };
+    
+    // 单个reactor：独立的事件循环和SO_REUSEPORT监听套接字
+    // 连接在其生命周期内只属于接受它的reactor，因此其连接状态只在该reactor线程中访问
+    struct Reactor {
+        int index = 0;
+        socket_t listenSocket = INVALID_SOCKET_VALUE;
+        socket_t unixListenSocket = INVALID_SOCKET_VALUE;   // 同机网关的AF_UNIX监听套接字，只在第一个reactor上
+        std::unique_ptr<AsyncIOManager> ioManager;
+        
+        // 连接超时定时器，由事件循环的周期回调推进
+        TimingWheel timers{TIMER_TICK_MS, steadyNowMs()};
+        std::vector<socket_t> expiredSockets;   // 本次推进中超时的连接，推进结束后统一关闭
+        
+        ConnectionTable<Connection> connections;
+        bool handingOver = false;   // 热重启交接中：入站数据只追加到缓冲区，不再投递到主循环
+        
+        // accept统计
+        std::atomic<uint64_t> acceptedCount{0};
+        std::atomic<uint64_t> acceptCapHits{0};     // 单次唤醒达到AcceptBatchSize上限的次数
+        std::atomic<uint64_t> backlogFullHits{0};   // 达到上限时监听队列已满的次数
+        
+        // 整批发送的命令对象池：发布线程取出，reactor线程执行后放回，数量为同时在途批次数的峰值
+        std::mutex sendBatchMutex;
+        std::vector<std::unique_ptr<SendBatch>> sendBatches;
+        std::vector<SendBatch*> freeSendBatches;
+    };
+    
+    // 全局客户端记录，各reactor线程与业务线程共享，由clientsMutex保护
+    struct ClientEntry {
+        std::string info;
+        Reactor* reactor = nullptr;     // 连接所属的reactor
+        bool authenticated = false;     // 已登录成功
+        socket_t socket = INVALID_SOCKET_VALUE;
+        uint32_t generation = 0;        // 与槽位一起组成ConnectionId
+    };
+    
+    std::vector<std::unique_ptr<Reactor>> reactors_;
     std::mutex clientsMutex;
+    uint32_t nextGeneration = 1;    // 下一个连接的代数，由clientsMutex保护
     std::atomic<bool> isRunning;
     ConfigManager* config;
     DatabaseManager* database;
@@ -44,23 +112,127 @@ private:
     // 服务器配置
     int port;
     int maxConnections;
+    int reactorCount;
+    int acceptBatchSize;
+    AsyncIOOptions ioOptions;
+    uint64_t loginTimeoutMs;    // 新连接完成登录的期限，0为不限制
+    uint64_t idleTimeoutMs;     // 未收到任何数据（含心跳）的最长时间，0为不限制
+    uint64_t slowClientTimeoutMs;   // 发送队列持续超过高水位的最长时间，0为不断开
+    int udpPort;                    // 可靠UDP端口，0为不启用
+    ReliableUdpOptions udpOptions;
+    std::string unixSocketPath;             // AF_UNIX监听路径，空为不启用
+    std::string sharedMemorySocketPath;     // 共享内存传输的控制套接字路径，空为不启用
+    size_t sharedMemoryRingBytes;
+    std::string gatewayToken;               // 网关复用链路的认证口令，空为不启用
+    RateLimitRules rateLimits;              // 入站帧限速规则，未启用时enabled()为false
+    RateLimitPolicy rateLimitPolicy;
+    size_t maxInboundBytes;                 // 入站缓冲区上限（半帧和被限速延后的帧），超过时断开连接
+    std::string handoverSocketPath;         // 热重启交接套接字路径，空为不启用
+    FrameCompressor frameCompressor;        // 出站消息体压缩规则和共享字典，启动时配置，之后只读
+    
+    // 时间轮精度，超时配置以秒为单位，1秒足够
+    static constexpr uint32_t TIMER_TICK_MS = 1000;
+    static uint64_t steadyNowMs();
     
     // 事件分发器 - 解耦网络层和业务层
     NetworkEventDispatcher eventDispatcher;
     
-    // 消息缓冲区，用于处理分片数据
-    std::map<socket_t, std::vector<uint8_t>> messageBuffers_;
-    
     // 异步I/O事件处理
-    void onAcceptEvent(const IOEvent& event);
-    void onReadEvent(const IOEvent& event);
+    void onAcceptEvent(Reactor& reactor, const IOEvent& event);
+    void acceptClient(Reactor& reactor, socket_t clientSocket, const struct sockaddr_in* clientAddr);
+    void checkAcceptBacklog(Reactor& reactor);
+    void onReadEvent(Reactor& reactor, const IOEvent& event);
     void onWriteEvent(const IOEvent& event);
-    void onErrorEvent(const IOEvent& event);
+    void onErrorEvent(Reactor& reactor, const IOEvent& event);
+    
+    // 连接超时处理，运行在所属reactor线程中
+    void onTimerTick(Reactor& reactor);
+    void onConnectionTimeout(Reactor& reactor, socket_t clientSocket);
+    bool isClientAuthenticated(socket_t clientSocket);
+    
+    // 发送队列水位变化：超过高水位时后端已暂停读取，超时未回落则断开
+    void onBackpressureEvent(Reactor& reactor, const IOEvent& event);
+    
+    // 限速检查的结果
+    enum class Admission {
+        ACCEPT,         // 放行
+        DROP,           // 丢弃该帧，继续处理后续帧
+        DEFER,          // 该帧及其后的数据留在入站缓冲区，等待令牌补充
+        DISCONNECT      // 断开连接
+    };
+    
+    // 按限速规则检查一个完整帧，只读取帧头，在解析消息体和分配内存之前拒绝超限的帧
+    Admission admitFrame(Connection& connection, const uint8_t* frame, size_t size, uint64_t nowMs);
+    // 入站缓冲区开头的帧被延后时，按其令牌补充时间设置定时器
+    void scheduleThrottle(Reactor& reactor, socket_t clientSocket, Connection& connection, uint64_t nowMs);
+    // 入站缓冲区超过maxInboundBytes时关闭连接并返回true
+    bool closeIfInboundOverflow(Reactor& reactor, socket_t clientSocket, const Connection& connection);
+    // 限速定时器到期，继续投递入站缓冲区中被延后的帧
+    void onThrottleTimer(Reactor& reactor, socket_t clientSocket);
+    
+    // 注销并关闭连接，分发断开事件
+    void closeConnection(Reactor& reactor, socket_t clientSocket);
+    
+    // 解析一个完整帧并投递到主循环，解析失败返回false
+    bool dispatchFrame(ConnectionId connectionId, const BufferSlice& frame);
+    // 主循环队列已满、消息被丢弃时向客户端答复错误
+    void rejectBusy(ConnectionId connectionId, uint32_t messageId);
+    
+    // 可靠UDP收到的消息，在UDP传输线程中调用；每条消息是一个完整帧，与TCP走同一条解析和投递路径
+    void onUdpMessage(ConnectionId connectionId, const BufferSlice& message, UdpChannel channel);
+    // 共享内存通道收到的帧，在共享内存传输线程中调用
+    void onSharedMemoryMessage(uint32_t channelId, const BufferSlice& frame);
+    
+    // 网关复用链路上的GATEWAY_*帧：认证链路、按会话ID拆出内层帧，内层帧以会话句柄再走dispatchFrame
+    bool handleGatewayFrame(ConnectionId link, const NetworkMessage& message);
+    // 链路断开（任意传输）时使其上的所有逻辑会话失效
+    void closeGatewayLink(ConnectionId link);
+    
+    // 热重启（新进程）：从旧进程接收监听套接字和连接，没有旧进程时返回false
+    bool takeOver(std::vector<socket_t>& listeners, socket_t& unixListener, std::vector<HandoverConnection>& connections);
+    // 把旧进程交来的连接注册到reactor，恢复登录状态和未处理/未发出的数据；须在事件循环启动前调用
+    void adoptConnection(Reactor& reactor, HandoverConnection& handover);
+    // 热重启（旧进程）：等待新进程的交接请求，只交接一次
+    void runHandoverListener();
+    void handOver(HotRestart& channel);
+    // 在reactor线程中执行task并等待完成，后端不支持时返回false（task未执行）
+    bool runInReactor(Reactor& reactor, std::function<void()> task);
     
     // 网络事件回调
-    void handleAsyncIOEvent(const IOEvent& event);
+    void handleAsyncIOEvent(Reactor& reactor, const IOEvent& event);
+    
+    // 查找连接所属的reactor
+    Reactor* findReactor(socket_t clientSocket);
+    
+    // 按句柄查找客户端记录：按槽位直接取记录并校验代数，连接已关闭时返回nullptr（调用方需持有clientsMutex）
+    ClientEntry* findClient(ConnectionId connectionId);
+    
+    // 追加到连接所属reactor的发送队列，只在该reactor线程中（或事件循环启动前）调用
+    bool queueSend(Reactor& reactor, socket_t clientSocket, const BufferSlice& message);
+    // 其他线程的发送：在reactor线程中核对fd当前的连接句柄后再追加，fd在投递后被关闭并复用时丢弃
+    bool queueSend(Reactor& reactor, socket_t clientSocket, ConnectionId connectionId, const BufferSlice& message);
+    // 整批发送的目标：fd及收集目标时占用它的连接句柄，与分组成员数组的元素相同
+    using SendTarget = GroupManager::Member;
+    // 同一帧整批投递到reactor线程（一条命令），逐个核对句柄后加入发送队列，句柄不符的目标跳过
+    void queueSendBatch(Reactor& reactor, std::shared_ptr<const std::vector<SendTarget>> targets, const BufferSlice& frame);
+    // 在reactor线程中写出一个批次，释放其对目标数组和帧的引用后放回池中
+    void runSendBatch(SendBatch& batch);
+    // 发送完成回调，分发数据发送事件
+    AsyncIOManager::EventCallback makeWriteCallback();
     
 public:
+    // accept统计，用于观察登录高峰时监听队列是否溢出
+    struct AcceptStats {
+        uint64_t accepted = 0;          // 累计接受的连接数
+        uint64_t cappedWakeups = 0;     // 单次唤醒未取完积压连接的次数
+        uint64_t backlogFull = 0;       // 其中监听队列已满的次数
+        uint64_t listenOverflows = 0;   // 内核统计的监听队列溢出次数（Linux，全系统）
+    };
+    
+    AcceptStats getAcceptStats() const;
+    // 各reactor事件循环的自旋/阻塞统计之和，spinBudgetUs取各reactor中的最大值
+    PollStats getPollStats() const;
+    
     // 设置主循环引用，用于传递消息
     void setMainLoop(MainLoop* mainLoop) { mainLoop_ = mainLoop; }
  
@@ -74,8 +246,8 @@ public:
     NetworkServer& operator=(NetworkServer&&) = delete;
     
     // 异步I/O初始化
-    bool initializeAsyncIO();
-    void setupAsyncIOCallbacks();
+    bool initializeAsyncIO(Reactor& reactor);
+    void setupAsyncIOCallbacks(Reactor& reactor);
     
     bool initialize();
     bool start();
@@ -83,17 +255,49 @@ public:
     void shutdown();
     
     // 客户端管理
-    void addClient(socket_t clientSocket);
+    ConnectionId addClient(socket_t clientSocket, Reactor* reactor = nullptr);
     void removeClient(socket_t clientSocket);
     void broadcastMessage(const std::string& message);
+    // 广播已编码好的帧：各连接的发送队列引用同一份数据，按reactor整批投递，调用线程不做I/O
+    void broadcastFrame(const BufferSlice& frame);
+    void broadcastNetworkMessage(const NetworkMessage& message);
+    
+    // 组播分组（房间/频道/公会），帧只编码一次并只发给分组成员
+    bool createGroup(GroupManager::GroupId groupId);
+    bool destroyGroup(GroupManager::GroupId groupId);
+    bool joinGroup(GroupManager::GroupId groupId, ConnectionId connectionId);
+    bool leaveGroup(GroupManager::GroupId groupId, ConnectionId connectionId);
+    size_t getGroupMemberCount(GroupManager::GroupId groupId) const;
+    bool sendToGroup(GroupManager::GroupId groupId, const std::string& message);
+    bool sendFrameToGroup(GroupManager::GroupId groupId, const BufferSlice& frame);
+    bool sendNetworkMessageToGroup(GroupManager::GroupId groupId, const NetworkMessage& message);
+    // 标记客户端已登录，之后只受心跳超时约束（可从任意线程调用）
+    void setClientAuthenticated(ConnectionId connectionId);
+    // 连接当前的句柄，连接不存在时返回无效句柄
+    ConnectionId getConnectionId(socket_t clientSocket);
     
     // 状态检查
     bool isServerRunning() const { return isRunning.load(); }
+    // 已把监听套接字和连接交给新进程，剩余的连接（不支持交接的后端）处理完即可退出
+    bool isHandedOver() const { return handedOver.load(); }
     int getActiveConnections() const;
     
     // 网络操作
-    bool sendToClient(socket_t clientSocket, const std::string& message);
-    bool sendResponseToClient(const std::string& clientId, ResponseType responseType, const std::string& message, const std::string& data);
+    // 按句柄发送，连接已关闭（包括fd已被新连接复用）时返回false
+    bool sendToClient(ConnectionId connectionId, const std::string& message);
+    bool sendResponseToClient(ConnectionId connectionId, ResponseType responseType, const std::string& message, const std::string& data);
+    // 通过可靠UDP发送，connectionId须为UDP会话的句柄；移动/战斗同步可选择无序或不可靠通道
+    bool sendUdpMessage(ConnectionId connectionId, const NetworkMessage& message, UdpChannel channel = UdpChannel::RELIABLE);
+    // 发送已编码的帧，按句柄的传输类型走TCP/AF_UNIX连接、可靠UDP、共享内存或网关复用链路
+    bool sendFrameToClient(ConnectionId connectionId, const BufferSlice& frame);
+    bool sendNetworkMessage(ConnectionId connectionId, const NetworkMessage& message);
+    // 把消息编码为帧，按消息ID的阈值压缩消息体；压缩在调用线程中进行，不占用reactor
+    BufferSlice encodeFrame(const NetworkMessage& message) const { return frameCompressor.encode(message); }
+    // 主循环用它展开收到的压缩帧
+    const FrameCompressor& getFrameCompressor() const { return frameCompressor; }
+    // 踢出网关复用链路上的逻辑会话并通知网关，会话已关闭时返回false
+    bool closeGatewaySession(ConnectionId connectionId);
+    size_t getGatewaySessionCount() const;
     
     // 消息队列操作
     MessagePtr getNextMessage();
@@ -117,23 +321,41 @@ public:
     std::string receiveFromClient(socket_t clientSocket);
     
 private:
-    bool createSocket();
-    bool bindSocket();
-    bool listenForConnections();
+    bool createSocket(socket_t& listenSocket);
+    bool bindSocket(socket_t& listenSocket);
+    bool listenForConnections(socket_t& listenSocket);
+    // inheritedSocket为旧进程交来的监听套接字时直接注册，不再创建和绑定
+    bool createUnixListener(Reactor& reactor, socket_t inheritedSocket = INVALID_SOCKET_VALUE);
+    // 注册监听套接字到reactor，可读时由事件循环投递ACCEPT事件
+    bool registerListener(Reactor& reactor, socket_t listenSocket);
     void acceptClients();
     
 private:
     // 主循环引用
     MainLoop* mainLoop_ = nullptr;
     
-    // 客户端套接字列表
-    std::vector<socket_t> clientSockets;
-    
     // 消息队列（向后兼容）
     std::queue<MessagePtr> messageQueue;
     
-    // 客户端信息映射
-    std::map<socket_t, std::string> clientInfo;
+    // 客户端记录表（按fd索引）
+    ConnectionTable<ClientEntry> clients;
+    
+    // 组播分组成员表
+    GroupManager groups;
+    
+    // 可靠UDP传输，UdpPort为0时不创建
+    std::unique_ptr<UdpTransport> udpTransport;
+    
+    // 共享内存传输，SharedMemorySocketPath为空时不创建
+    std::unique_ptr<SharedMemoryTransport> sharedMemoryTransport;
+    
+    // 网关复用链路的逻辑会话表，GatewayToken为空时不创建
+    std::unique_ptr<GatewayMux> gatewayMux;
+    
+    // 热重启交接：旧进程在交接套接字上等待新进程
+    socket_t handoverListenSocket = INVALID_SOCKET_VALUE;
+    std::thread handoverThread;
+    std::atomic<bool> handedOver{false};
     
     // 网络事件处理回调
     friend void handleClient(socket_t clientSocket, NetworkServer* server);
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// 超出限速后的处理方式
+enum class RateLimitPolicy {
+    DROP,           // 丢弃超出的帧
+    DELAY,          // 超出的帧及其后的数据留在入站缓冲区，补充令牌后再投递
+    DISCONNECT      // 断开连接
+};
+
+// 限速参数：每windowMs毫秒最多requests帧，允许一次突发requests帧
+struct RateLimit {
+    uint32_t requests = 0;
+    uint64_t windowMs = 0;
+
+    bool enabled() const { return requests > 0 && windowMs > 0; }
+};
+
+// 令牌桶 - 令牌按经过的时间惰性补充，检查和扣减均为O(1)，不需要定时器
+// 以1/windowMs个令牌为计数单位，每毫秒补充requests个单位，全部为整数运算
+// 默认构造的桶在第一次使用时补满
+class TokenBucket {
+public:
+    // 补充令牌后判断是否至少有一个令牌
+    bool available(const RateLimit& limit, uint64_t nowMs) {
+        refill(limit, nowMs);
+        return units_ >= limit.windowMs;
+    }
+
+    // 扣除一个令牌，须先通过available检查
+    void consume(const RateLimit& limit) { units_ -= limit.windowMs; }
+
+    // 距离下一个令牌可用的毫秒数
+    uint64_t waitMs(const RateLimit& limit, uint64_t nowMs) {
+        if (available(limit, nowMs)) {
+            return 0;
+        }
+        return (limit.windowMs - units_ + limit.requests - 1) / limit.requests;
+    }
+
+private:
+    void refill(const RateLimit& limit, uint64_t nowMs) {
+        if (nowMs <= lastMs_) {
+            return;
+        }
+        uint64_t elapsedMs = nowMs - lastMs_;
+        lastMs_ = nowMs;
+        uint64_t capacity = static_cast<uint64_t>(limit.requests) * limit.windowMs;
+        // 超过一个窗口必然已补满，同时避免乘法溢出
+        units_ = elapsedMs >= limit.windowMs ? capacity : std::min(capacity, units_ + elapsedMs * limit.requests);
+    }
+
+    uint64_t units_ = 0;
+    uint64_t lastMs_ = 0;
+};
+
+// 限速规则：连接级限速，加上按消息ID单独的限速（两者都须有令牌才放行）
+// 启动时确定，之后只读，由各reactor共享
+class RateLimitRules {
+public:
+    static constexpr size_t NO_RULE = static_cast<size_t>(-1);
+
+    RateLimit connection;
+
+    void addMessageLimit(uint32_t messageId, const RateLimit& limit) {
+        auto it = messageIndex_.find(messageId);
+        if (it != messageIndex_.end()) {
+            messageLimits_[it->second] = limit;
+            return;
+        }
+        messageIndex_.emplace(messageId, messageLimits_.size());
+        messageLimits_.push_back(limit);
+    }
+
+    bool enabled() const { return connection.enabled() || !messageLimits_.empty(); }
+
+    // 消息ID对应的规则下标，没有单独限速时返回NO_RULE
+    size_t find(uint32_t messageId) const {
+        if (messageLimits_.empty()) {
+            return NO_RULE;
+        }
+        auto it = messageIndex_.find(messageId);
+        return it != messageIndex_.end() ? it->second : NO_RULE;
+    }
+
+    const RateLimit& messageLimit(size_t index) const { return messageLimits_[index]; }
+    size_t messageLimitCount() const { return messageLimits_.size(); }
+
+private:
+    std::vector<RateLimit> messageLimits_;
+    std::unordered_map<uint32_t, size_t> messageIndex_;
+};
+
+// 单个连接的限速状态，只由所属reactor线程访问
+class RateLimiter {
+public:
+    // 两级令牌桶都有令牌时扣除并放行
+    bool allow(const RateLimitRules& rules, uint32_t messageId, uint64_t nowMs) {
+        size_t rule = rules.find(messageId);
+        TokenBucket* message = messageBucket(rules, rule);
+        if (rules.connection.enabled() && !connection_.available(rules.connection, nowMs)) {
+            return false;
+        }
+        if (message && !message->available(rules.messageLimit(rule), nowMs)) {
+            return false;
+        }
+        if (rules.connection.enabled()) {
+            connection_.consume(rules.connection);
+        }
+        if (message) {
+            message->consume(rules.messageLimit(rule));
+        }
+        return true;
+    }
+
+    // 该消息ID再次可以放行前需要等待的毫秒数
+    uint64_t waitMs(const RateLimitRules& rules, uint32_t messageId, uint64_t nowMs) {
+        uint64_t wait = rules.connection.enabled() ? connection_.waitMs(rules.connection, nowMs) : 0;
+        size_t rule = rules.find(messageId);
+        TokenBucket* message = messageBucket(rules, rule);
+        if (message) {
+            wait = std::max(wait, message->waitMs(rules.messageLimit(rule), nowMs));
+        }
+        return wait;
+    }
+
+private:
+    // 按消息ID限速的桶在连接第一次用到时一次性分配
+    TokenBucket* messageBucket(const RateLimitRules& rules, size_t rule) {
+        if (rule == RateLimitRules::NO_RULE) {
+            return nullptr;
+        }
+        if (messages_.empty()) {
+            messages_.resize(rules.messageLimitCount());
+        }
+        return &messages_[rule];
+    }
+
+    TokenBucket connection_;
+    std::vector<TokenBucket> messages_;
+};
@@ -0,0 +1,376 @@
+#include "ReliableUdp.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// 序号与时间戳都会回绕，按有符号差值比较先后
+inline int32_t timeDiff(uint32_t later, uint32_t earlier) {
+    return static_cast<int32_t>(later - earlier);
+}
+
+// 线路格式统一为小端序
+inline void put16(char* p, uint16_t v) {
+    p[0] = static_cast<char>(v & 0xff);
+    p[1] = static_cast<char>(v >> 8);
+}
+
+inline void put32(char* p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) {
+        p[i] = static_cast<char>((v >> (i * 8)) & 0xff);
+    }
+}
+
+inline uint16_t get16(const char* p) {
+    const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+    return static_cast<uint16_t>(u[0] | (u[1] << 8));
+}
+
+inline uint32_t get32(const char* p) {
+    const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+    return static_cast<uint32_t>(u[0]) | (static_cast<uint32_t>(u[1]) << 8) |
+           (static_cast<uint32_t>(u[2]) << 16) | (static_cast<uint32_t>(u[3]) << 24);
+}
+
+} // namespace
+
+ReliableUdpSession::ReliableUdpSession(uint32_t conv, const ReliableUdpOptions& options)
+    : conv_(conv),
+      mtu_(std::max<uint32_t>(options.mtu, HEADER_SIZE + 1)),
+      intervalMs_(std::max<uint32_t>(options.intervalMs, 1)),
+      minRto_(std::max<uint32_t>(options.minRtoMs, 1)),
+      maxRto_(std::max(options.maxRtoMs, std::max<uint32_t>(options.minRtoMs, 1))),
+      sendWindow_(std::max<uint32_t>(options.sendWindow, 1)),
+      receiveWindow_(std::max<uint32_t>(options.receiveWindow, 1)),
+      fastResend_(options.fastResend),
+      deadLink_(std::max<uint32_t>(options.deadLinkResends, 1)),
+      remoteWindow_(std::max<uint32_t>(options.receiveWindow, 1)),
+      receiveRing_(std::max<uint32_t>(options.receiveWindow, 1)) {
+    rxRto_ = std::min(std::max(rxRto_, minRto_), maxRto_);
+    datagram_.reserve(mtu_);
+}
+
+bool ReliableUdpSession::send(const BufferSlice& message, UdpChannel channel) {
+    if (message.empty()) {
+        return false;
+    }
+
+    if (channel == UdpChannel::UNRELIABLE || channel == UdpChannel::UNORDERED) {
+        // 单个分片内的消息才能独立交付
+        if (message.size() > mss()) {
+            return false;
+        }
+        if (channel == UdpChannel::UNRELIABLE) {
+            unreliableQueue_.push_back(message);
+            return true;
+        }
+        Segment segment;
+        segment.cmd = CMD_PUSH_UNORDERED;
+        segment.data = message;
+        sendQueue_.push_back(std::move(segment));
+        return true;
+    }
+
+    size_t count = (message.size() + mss() - 1) / mss();
+    if (count > MAX_FRAGMENTS) {
+        return false;
+    }
+    // 分片引用消息的存储，不复制
+    for (size_t i = 0; i < count; ++i) {
+        Segment segment;
+        segment.cmd = CMD_PUSH;
+        segment.frg = static_cast<uint8_t>(count - i - 1);
+        segment.data = message.slice(i * mss(), mss());
+        sendQueue_.push_back(std::move(segment));
+    }
+    return true;
+}
+
+bool ReliableUdpSession::peekConv(const char* data, size_t size, uint32_t& conv) {
+    if (size < HEADER_SIZE) {
+        return false;
+    }
+    conv = get32(data);
+    return true;
+}
+
+bool ReliableUdpSession::input(const char* data, size_t size, uint32_t nowMs) {
+    if (size < HEADER_SIZE || dead_) {
+        return false;
+    }
+
+    bool gotAck = false;
+    uint32_t maxAck = 0;
+    while (size >= HEADER_SIZE) {
+        uint32_t conv = get32(data);
+        uint8_t cmd = static_cast<uint8_t>(data[4]);
+        uint8_t frg = static_cast<uint8_t>(data[5]);
+        uint16_t wnd = get16(data + 6);
+        uint32_t ts = get32(data + 8);
+        uint32_t sn = get32(data + 12);
+        uint32_t una = get32(data + 16);
+        uint16_t len = get16(data + 20);
+        data += HEADER_SIZE;
+        size -= HEADER_SIZE;
+
+        if (conv != conv_ || len > size || cmd < CMD_PUSH || cmd > CMD_UNRELIABLE) {
+            return false;
+        }
+
+        remoteWindow_ = wnd;
+        parseUna(una);
+
+        switch (cmd) {
+            case CMD_ACK:
+                if (timeDiff(nowMs, ts) >= 0) {
+                    updateRtt(static_cast<uint32_t>(timeDiff(nowMs, ts)));
+                }
+                parseAck(sn);
+                if (!gotAck || timeDiff(sn, maxAck) > 0) {
+                    maxAck = sn;
+                    gotAck = true;
+                }
+                break;
+            case CMD_PUSH:
+            case CMD_PUSH_UNORDERED:
+                // 窗口外的分片不确认，发送方会在窗口推进后重传
+                if (timeDiff(sn, rcvNext_ + receiveWindow_) < 0) {
+                    ackList_.emplace_back(sn, ts);
+                    if (timeDiff(sn, rcvNext_) >= 0) {
+                        receiveSegment(cmd, frg, sn, data, len);
+                    }
+                }
+                break;
+            case CMD_UNRELIABLE:
+                if (len > 0 && onMessage_) {
+                    onMessage_(BufferSlice::copyFrom(data, len), UdpChannel::UNRELIABLE);
+                }
+                break;
+        }
+
+        data += len;
+        size -= len;
+    }
+
+    if (gotAck) {
+        parseFastAck(maxAck);
+    }
+    return true;
+}
+
+void ReliableUdpSession::receiveSegment(uint8_t cmd, uint8_t frg, uint32_t sn, const char* data, size_t size) {
+    if (dead_) {
+        return;
+    }
+    std::optional<ReceiveSlot>& slot = receiveRing_[sn % receiveWindow_];
+    if (slot) {
+        return;     // 重复分片
+    }
+
+    slot.emplace();
+    slot->frg = frg;
+    ++receivedCount_;
+    if (cmd == CMD_PUSH_UNORDERED) {
+        // 无序消息到达即交付，窗口中只保留占位
+        slot->delivered = true;
+        if (size > 0 && onMessage_) {
+            onMessage_(BufferSlice::copyFrom(data, size), UdpChannel::UNORDERED);
+        }
+    } else {
+        slot->data = BufferSlice::copyFrom(data, size);
+    }
+    deliverOrdered();
+}
+
+void ReliableUdpSession::deliverOrdered() {
+    std::optional<ReceiveSlot>* slot;
+    while (*(slot = &receiveRing_[rcvNext_ % receiveWindow_])) {
+        ReceiveSlot segment = std::move(**slot);
+        slot->reset();
+        --receivedCount_;
+        ++rcvNext_;
+        if (segment.delivered) {
+            continue;
+        }
+
+        if (segment.frg == 0 && assembling_.empty()) {
+            // 单分片消息直接交付，不经过拼接缓冲区
+            if (onMessage_) {
+                onMessage_(segment.data, UdpChannel::RELIABLE);
+            }
+            continue;
+        }
+
+        // 发送方不会把一条消息拆成超过MAX_FRAGMENTS个分片，frg一直不为0的对端会让拼接缓冲区无限增长
+        if (++assemblingFragments_ > MAX_FRAGMENTS || assembling_.size() + segment.data.size() > MAX_FRAGMENTS * mss()) {
+            assembling_.clear();
+            assembling_.shrink_to_fit();
+            assemblingFragments_ = 0;
+            dead_ = true;
+            return;
+        }
+        assembling_.append(reinterpret_cast<const char*>(segment.data.data()), segment.data.size());
+        if (segment.frg == 0) {
+            BufferSlice message(std::move(assembling_));
+            assembling_.clear();
+            assemblingFragments_ = 0;
+            if (onMessage_) {
+                onMessage_(message, UdpChannel::RELIABLE);
+            }
+        }
+    }
+}
+
+uint16_t ReliableUdpSession::freeReceiveWindow() const {
+    size_t free = receiveWindow_ > receivedCount_ ? receiveWindow_ - receivedCount_ : 0;
+    return static_cast<uint16_t>(std::min<size_t>(free, UINT16_MAX));
+}
+
+void ReliableUdpSession::parseUna(uint32_t una) {
+    while (!sendBuffer_.empty() && timeDiff(sendBuffer_.front().sn, una) < 0) {
+        sendBuffer_.pop_front();
+    }
+}
+
+void ReliableUdpSession::parseAck(uint32_t sn) {
+    if (sendBuffer_.empty() || timeDiff(sn, sendBuffer_.front().sn) < 0 || timeDiff(sn, sndNext_) >= 0) {
+        return;
+    }
+    // 在途分片按序号连续排列，可以直接定位
+    size_t index = static_cast<size_t>(sn - sendBuffer_.front().sn);
+    if (index < sendBuffer_.size() && sendBuffer_[index].sn == sn) {
+        sendBuffer_.erase(sendBuffer_.begin() + static_cast<std::ptrdiff_t>(index));
+        return;
+    }
+    for (auto it = sendBuffer_.begin(); it != sendBuffer_.end(); ++it) {
+        if (it->sn == sn) {
+            sendBuffer_.erase(it);
+            return;
+        }
+        if (timeDiff(it->sn, sn) > 0) {
+            return;
+        }
+    }
+}
+
+void ReliableUdpSession::parseFastAck(uint32_t sn) {
+    for (Segment& segment : sendBuffer_) {
+        if (timeDiff(segment.sn, sn) >= 0) {
+            break;
+        }
+        ++segment.fastAck;
+    }
+}
+
+void ReliableUdpSession::updateRtt(uint32_t rtt) {
+    if (rxSrtt_ == 0) {
+        rxSrtt_ = rtt > 0 ? rtt : 1;
+        rxRttVar_ = rtt / 2;
+    } else {
+        uint32_t delta = rtt > rxSrtt_ ? rtt - rxSrtt_ : rxSrtt_ - rtt;
+        rxRttVar_ = (3 * rxRttVar_ + delta) / 4;
+        rxSrtt_ = std::max<uint32_t>((7 * rxSrtt_ + rtt) / 8, 1);
+    }
+    uint32_t rto = rxSrtt_ + std::max(intervalMs_, 4 * rxRttVar_);
+    rxRto_ = std::min(std::max(rto, minRto_), maxRto_);
+}
+
+void ReliableUdpSession::update(uint32_t nowMs) {
+    if (!updated_) {
+        updated_ = true;
+        nextFlush_ = nowMs;
+    }
+    if (timeDiff(nowMs, nextFlush_) >= 0) {
+        flush(nowMs);
+        nextFlush_ = nowMs + intervalMs_;
+    }
+}
+
+void ReliableUdpSession::flush(uint32_t nowMs) {
+    uint32_t una = rcvNext_;
+
+    for (const auto& ack : ackList_) {
+        writeSegment(CMD_ACK, 0, ack.first, ack.second, una, BufferSlice());
+    }
+    ackList_.clear();
+
+    for (const BufferSlice& message : unreliableQueue_) {
+        writeSegment(CMD_UNRELIABLE, 0, 0, nowMs, una, message);
+    }
+    unreliableQueue_.clear();
+
+    // 按窗口把排队的分片移入在途队列；对端窗口为0时仍放行一个分片作为探测
+    uint32_t window = std::max<uint32_t>(std::min(sendWindow_, remoteWindow_), 1);
+    uint32_t sndUna = sendBuffer_.empty() ? sndNext_ : sendBuffer_.front().sn;
+    while (!sendQueue_.empty() && timeDiff(sndNext_, sndUna + window) < 0) {
+        Segment segment = std::move(sendQueue_.front());
+        sendQueue_.pop_front();
+        segment.sn = sndNext_++;
+        segment.xmit = 0;
+        segment.fastAck = 0;
+        sendBuffer_.push_back(std::move(segment));
+    }
+
+    for (Segment& segment : sendBuffer_) {
+        bool needSend = false;
+        if (segment.xmit == 0) {
+            needSend = true;
+            segment.rto = rxRto_;
+            segment.resendTs = nowMs + segment.rto;
+        } else if (timeDiff(nowMs, segment.resendTs) >= 0) {
+            // 超时重传，退避为原来的1.5倍
+            needSend = true;
+            segment.rto += std::max(segment.rto, rxRto_) / 2;
+            segment.rto = std::min(segment.rto, maxRto_);
+            segment.resendTs = nowMs + segment.rto;
+            ++retransmits_;
+        } else if (fastResend_ > 0 && segment.fastAck >= fastResend_) {
+            needSend = true;
+            segment.fastAck = 0;
+            segment.resendTs = nowMs + segment.rto;
+            ++retransmits_;
+        }
+
+        if (needSend) {
+            ++segment.xmit;
+            segment.ts = nowMs;
+            writeSegment(segment.cmd, segment.frg, segment.sn, segment.ts, una, segment.data);
+            if (segment.xmit > deadLink_) {
+                dead_ = true;
+            }
+        }
+    }
+
+    flushDatagram();
+}
+
+void ReliableUdpSession::writeSegment(uint8_t cmd, uint8_t frg, uint32_t sn, uint32_t ts, uint32_t una, const BufferSlice& data) {
+    if (datagram_.size() + HEADER_SIZE + data.size() > mtu_) {
+        flushDatagram();
+    }
+
+    char header[HEADER_SIZE];
+    put32(header, conv_);
+    header[4] = static_cast<char>(cmd);
+    header[5] = static_cast<char>(frg);
+    put16(header + 6, freeReceiveWindow());
+    put32(header + 8, ts);
+    put32(header + 12, sn);
+    put32(header + 16, una);
+    put16(header + 20, static_cast<uint16_t>(data.size()));
+    datagram_.append(header, HEADER_SIZE);
+    if (!data.empty()) {
+        datagram_.append(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+}
+
+void ReliableUdpSession::flushDatagram() {
+    if (datagram_.empty()) {
+        return;
+    }
+    if (output_) {
+        output_(datagram_.data(), datagram_.size());
+    }
+    datagram_.clear();
+}
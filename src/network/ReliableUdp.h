@@ -0,0 +1,160 @@
+#pragma once
+
+#include "../messaging/buffer_slice.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 可靠UDP会话的参数，含义与KCP对应参数相同
+struct ReliableUdpOptions {
+    uint32_t mtu = 1200;                // 单个数据报的最大字节数（含分片头），多个分片合并到一个数据报中发送
+    uint32_t intervalMs = 10;           // 刷新间隔：检查重传并发出积累的ACK
+    uint32_t minRtoMs = 30;             // 重传超时的下限
+    uint32_t maxRtoMs = 5000;           // 重传超时的上限
+    uint32_t sendWindow = 128;          // 发送窗口（分片数）
+    uint32_t receiveWindow = 128;       // 接收窗口（分片数），同时限制乱序缓存的大小
+    uint32_t fastResend = 2;            // 分片被后续ACK跳过这么多次后立即重传，0为只按超时重传
+    uint32_t deadLinkResends = 20;      // 单个分片重传超过此次数视为连接断开
+    uint32_t idleTimeoutMs = 60000;     // 未收到任何数据报的最长时间，0为不限制
+    uint32_t maxSessions = 10000;       // 服务端最多同时存在的会话数
+    uint32_t simulatedLossPercent = 0;  // 按此概率丢弃发出的数据报，只用于在回环地址上测试重传
+};
+
+// 通道：可靠有序（移动/战斗指令）、可靠无序（互不依赖的事件）、不可靠（可被后续状态覆盖的同步）
+enum class UdpChannel : uint8_t {
+    RELIABLE = 0,
+    UNORDERED = 1,
+    UNRELIABLE = 2
+};
+
+// KCP式的ARQ会话，只负责分片、确认、重传与排序，不涉及socket
+// 发出的数据报通过输出回调交给传输层，收到的数据报由传输层调用input；
+// 传输层按intervalMs调用update驱动重传，收到数据后可立即调用flush尽快发出ACK
+// 与KCP的差别：去掉了拥塞窗口（游戏流量小而频繁，按nodelay模式只受收发窗口限制），
+// 窗口为0时仍允许一个分片在途作为探测，不需要单独的窗口探测命令
+// 非线程安全：同一会话只能在一个线程中使用
+class ReliableUdpSession {
+public:
+    using OutputCallback = std::function<void(const char* data, size_t size)>;
+    // 回调中可以调用本会话的send，但不能销毁会话
+    using MessageCallback = std::function<void(const BufferSlice& message, UdpChannel channel)>;
+
+    // 分片头长度：conv(4) cmd(1) frg(1) wnd(2) ts(4) sn(4) una(4) len(2)
+    static constexpr size_t HEADER_SIZE = 22;
+    // 一条可靠有序消息最多拆成的分片数（frg字段为一个字节）
+    static constexpr size_t MAX_FRAGMENTS = 256;
+
+    ReliableUdpSession(uint32_t conv, const ReliableUdpOptions& options = ReliableUdpOptions());
+
+    ReliableUdpSession(const ReliableUdpSession&) = delete;
+    ReliableUdpSession& operator=(const ReliableUdpSession&) = delete;
+
+    void setOutputCallback(OutputCallback callback) { output_ = std::move(callback); }
+    void setMessageCallback(MessageCallback callback) { onMessage_ = std::move(callback); }
+
+    // 放入发送队列，在下一次flush时发出；消息过大（可靠有序超过MAX_FRAGMENTS个分片，其他通道超过一个分片）时返回false
+    bool send(const BufferSlice& message, UdpChannel channel = UdpChannel::RELIABLE);
+
+    // 处理收到的一个数据报，conv不符或格式错误时返回false
+    bool input(const char* data, size_t size, uint32_t nowMs);
+
+    // 到达刷新时间时调用flush
+    void update(uint32_t nowMs);
+    // 发出ACK、新分片和需要重传的分片
+    void flush(uint32_t nowMs);
+
+    // 读取数据报开头的conv，长度不足时返回false
+    static bool peekConv(const char* data, size_t size, uint32_t& conv);
+
+    uint32_t conv() const { return conv_; }
+    // 有分片超过重传次数上限，或对端发来的多分片消息超过MAX_FRAGMENTS个分片
+    bool isDead() const { return dead_; }
+    // 尚未被确认的分片数（包括还在发送队列中的）
+    size_t pendingCount() const { return sendQueue_.size() + sendBuffer_.size(); }
+    uint32_t rto() const { return rxRto_; }
+    uint32_t srtt() const { return rxSrtt_; }
+    // 累计重传次数（超时与快速重传）
+    uint64_t retransmitCount() const { return retransmits_; }
+
+private:
+    enum Command : uint8_t {
+        CMD_PUSH = 1,           // 可靠有序
+        CMD_PUSH_UNORDERED = 2, // 可靠无序
+        CMD_ACK = 3,
+        CMD_UNRELIABLE = 4
+    };
+
+    struct Segment {
+        uint8_t cmd = CMD_PUSH;
+        uint8_t frg = 0;        // 同一消息中后面还有几个分片
+        uint32_t sn = 0;
+        uint32_t ts = 0;
+        uint32_t resendTs = 0;
+        uint32_t rto = 0;
+        uint32_t fastAck = 0;
+        uint32_t xmit = 0;
+        BufferSlice data;
+    };
+
+    // 接收窗口中的一个位置；可靠无序分片到达时已交付，只占位用于去重和推进rcvNext_
+    struct ReceiveSlot {
+        uint8_t frg = 0;
+        bool delivered = false;
+        BufferSlice data;
+    };
+
+    size_t mss() const { return mtu_ - HEADER_SIZE; }
+    uint16_t freeReceiveWindow() const;
+
+    void parseUna(uint32_t una);
+    void parseAck(uint32_t sn);
+    void parseFastAck(uint32_t sn);
+    void updateRtt(uint32_t rtt);
+    void receiveSegment(uint8_t cmd, uint8_t frg, uint32_t sn, const char* data, size_t size);
+    // 把接收窗口头部连续的分片按序交付
+    void deliverOrdered();
+
+    // 把分片追加到待发数据报中，放不下时先发出当前数据报
+    void writeSegment(uint8_t cmd, uint8_t frg, uint32_t sn, uint32_t ts, uint32_t una, const BufferSlice& data);
+    void flushDatagram();
+
+    uint32_t conv_;
+    uint32_t mtu_;
+    uint32_t intervalMs_;
+    uint32_t minRto_;
+    uint32_t maxRto_;
+    uint32_t sendWindow_;
+    uint32_t receiveWindow_;
+    uint32_t fastResend_;
+    uint32_t deadLink_;
+
+    uint32_t sndNext_ = 0;      // 下一个分配的序号
+    uint32_t rcvNext_ = 0;      // 下一个待按序交付的序号
+    uint32_t remoteWindow_;
+    uint32_t rxSrtt_ = 0;
+    uint32_t rxRttVar_ = 0;
+    uint32_t rxRto_ = 200;
+    uint32_t nextFlush_ = 0;
+    bool updated_ = false;
+    bool dead_ = false;
+    uint64_t retransmits_ = 0;
+
+    std::deque<Segment> sendQueue_;     // 等待进入发送窗口
+    std::deque<Segment> sendBuffer_;    // 已发出、等待确认，按序号排列
+    std::vector<BufferSlice> unreliableQueue_;
+    std::vector<std::pair<uint32_t, uint32_t>> ackList_;    // (sn, ts)
+    std::vector<std::optional<ReceiveSlot>> receiveRing_;   // 按sn % receiveWindow索引
+    size_t receivedCount_ = 0;
+    std::string assembling_;            // 正在拼接的多分片消息
+    size_t assemblingFragments_ = 0;    // assembling_中的分片数，超过MAX_FRAGMENTS视为对端异常
+
+    std::string datagram_;              // 正在组装的待发数据报
+    OutputCallback output_;
+    MessageCallback onMessage_;
+};
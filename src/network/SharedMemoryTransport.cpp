@@ -0,0 +1,579 @@
+#include "SharedMemoryTransport.h"
+#include "Log.h"
+#include "ThreadPlacement.h"
+
+#include <cstring>
+#include <vector>
+
+#ifdef __linux__
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+
+namespace {
+
+// 握手消息，随SCM_RIGHTS一起发送
+struct Handshake {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t ringBytes;
+};
+
+constexpr int HANDSHAKE_FDS = 3;    // memfd、网关->服务端门铃、服务端->网关门铃
+
+// epoll事件的data.u64：高32位为类型，低32位为通道ID
+enum EventKind : uint64_t {
+    EVENT_LISTEN = 1,
+    EVENT_WAKE = 2,
+    EVENT_DOORBELL = 3,
+    EVENT_CONTROL = 4
+};
+
+inline uint64_t eventData(EventKind kind, uint32_t channelId) {
+    return (static_cast<uint64_t>(kind) << 32) | channelId;
+}
+
+uint64_t roundUpPowerOfTwo(size_t value) {
+    uint64_t result = 4096;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+bool fillUnixAddress(const std::string& path, struct sockaddr_un& address) {
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        LOG_ERROR("Invalid unix socket path '{}'", path);
+        return false;
+    }
+    memcpy(address.sun_path, path.c_str(), path.size());
+    return true;
+}
+
+} // namespace
+
+SharedMemoryChannel::~SharedMemoryChannel() {
+    if (mapping_) {
+        munmap(mapping_, mappingSize_);
+    }
+    for (int fd : {memFd_, inboundBell_, outboundBell_, controlSocket_}) {
+        if (fd != -1) {
+            close(fd);
+        }
+    }
+}
+
+std::unique_ptr<SharedMemoryChannel> SharedMemoryChannel::create(size_t ringBytes) {
+    std::unique_ptr<SharedMemoryChannel> channel(new SharedMemoryChannel());
+    channel->ringBytes_ = roundUpPowerOfTwo(ringBytes);
+    channel->mappingSize_ = 2 * ShmRing::regionSize(channel->ringBytes_);
+
+    channel->memFd_ = memfd_create("gameserver-shm", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (channel->memFd_ == -1 || ftruncate(channel->memFd_, static_cast<off_t>(channel->mappingSize_)) == -1) {
+        LOG_ERROR("Failed to create shared memory: {}", strerror(errno));
+        return nullptr;
+    }
+    // 封住大小，网关无法截断共享内存让服务端访问时触发SIGBUS
+    if (fcntl(channel->memFd_, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) == -1) {
+        LOG_WARN("Failed to seal shared memory: {}", strerror(errno));
+    }
+
+    // 服务端等待网关->服务端的门铃，敲响服务端->网关的门铃
+    channel->inboundBell_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    channel->outboundBell_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (channel->inboundBell_ == -1 || channel->outboundBell_ == -1) {
+        LOG_ERROR("Failed to create shared memory doorbell: {}", strerror(errno));
+        return nullptr;
+    }
+
+    if (!channel->map(true, true)) {
+        return nullptr;
+    }
+    return channel;
+}
+
+std::unique_ptr<SharedMemoryChannel> SharedMemoryChannel::connect(const std::string& path) {
+    struct sockaddr_un address;
+    if (!fillUnixAddress(path, address)) {
+        return nullptr;
+    }
+
+    std::unique_ptr<SharedMemoryChannel> channel(new SharedMemoryChannel());
+    channel->controlSocket_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (channel->controlSocket_ == -1 ||
+        ::connect(channel->controlSocket_, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) == -1) {
+        LOG_ERROR("Failed to connect to shared memory socket {}: {}", path, strerror(errno));
+        return nullptr;
+    }
+
+    Handshake handshake;
+    struct iovec iov;
+    iov.iov_base = &handshake;
+    iov.iov_len = sizeof(handshake);
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int) * HANDSHAKE_FDS)];
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    ssize_t received;
+    do {
+        received = recvmsg(channel->controlSocket_, &message, MSG_CMSG_CLOEXEC | MSG_WAITALL);
+    } while (received == -1 && errno == EINTR);
+
+    // 先收下描述符，之后任何校验失败都由析构函数关闭
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+    if (cmsg && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS &&
+        cmsg->cmsg_len == CMSG_LEN(sizeof(int) * HANDSHAKE_FDS)) {
+        int fds[HANDSHAKE_FDS];
+        memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+        channel->memFd_ = fds[0];
+        channel->outboundBell_ = fds[1];
+        channel->inboundBell_ = fds[2];
+    }
+
+    if (received != static_cast<ssize_t>(sizeof(handshake)) || channel->memFd_ == -1 ||
+        handshake.magic != ShmRingHeader::MAGIC || handshake.version != ShmRingHeader::VERSION ||
+        handshake.ringBytes == 0 || (handshake.ringBytes & (handshake.ringBytes - 1)) != 0) {
+        LOG_ERROR("Invalid shared memory handshake from {}", path);
+        return nullptr;
+    }
+
+    channel->ringBytes_ = handshake.ringBytes;
+    channel->mappingSize_ = 2 * ShmRing::regionSize(channel->ringBytes_);
+    struct stat info;
+    if (fstat(channel->memFd_, &info) == -1 || static_cast<size_t>(info.st_size) != channel->mappingSize_) {
+        LOG_ERROR("Shared memory from {} has unexpected size", path);
+        return nullptr;
+    }
+
+    if (!channel->map(false, false)) {
+        return nullptr;
+    }
+    return channel;
+}
+
+bool SharedMemoryChannel::map(bool server, bool initialize) {
+    mapping_ = mmap(nullptr, mappingSize_, PROT_READ | PROT_WRITE, MAP_SHARED, memFd_, 0);
+    if (mapping_ == MAP_FAILED) {
+        mapping_ = nullptr;
+        LOG_ERROR("Failed to map shared memory: {}", strerror(errno));
+        return false;
+    }
+
+    // 环0为网关->服务端，环1为服务端->网关
+    char* base = static_cast<char*>(mapping_);
+    ShmRing toServer(base, ringBytes_, initialize);
+    ShmRing toClient(base + ShmRing::regionSize(ringBytes_), ringBytes_, initialize);
+    if (!toServer.isValid() || !toClient.isValid()) {
+        LOG_ERROR("Shared memory rings are not initialized");
+        return false;
+    }
+    inbound_ = server ? toServer : toClient;
+    outbound_ = server ? toClient : toServer;
+    return true;
+}
+
+bool SharedMemoryChannel::handshake(int controlSocket) {
+    Handshake handshake;
+    handshake.magic = ShmRingHeader::MAGIC;
+    handshake.version = ShmRingHeader::VERSION;
+    handshake.ringBytes = ringBytes_;
+
+    struct iovec iov;
+    iov.iov_base = &handshake;
+    iov.iov_len = sizeof(handshake);
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int) * HANDSHAKE_FDS)];
+    memset(control, 0, sizeof(control));
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * HANDSHAKE_FDS);
+    // 网关端的入站门铃是服务端的出站门铃
+    int fds[HANDSHAKE_FDS] = {memFd_, inboundBell_, outboundBell_};
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    controlSocket_ = controlSocket;
+    if (sendmsg(controlSocket, &message, MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(handshake))) {
+        LOG_ERROR("Failed to send shared memory handshake: {}", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool SharedMemoryChannel::send(const void* data, size_t size) {
+    bool wake = false;
+    if (!outbound_.write(data, size, wake)) {
+        return false;
+    }
+    if (wake) {
+        uint64_t one = 1;
+        if (write(outboundBell_, &one, sizeof(one)) != sizeof(one) && errno != EAGAIN) {
+            LOG_ERROR("Failed to ring shared memory doorbell: {}", strerror(errno));
+        }
+    }
+    return true;
+}
+
+bool SharedMemoryChannel::receive(const std::function<void(const char*, size_t)>& func, size_t& count) {
+    bool corrupted = false;
+    count = inbound_.drain(func, corrupted);
+    return !corrupted;
+}
+
+bool SharedMemoryChannel::prepareWait() {
+    return inbound_.prepareWait();
+}
+
+void SharedMemoryChannel::finishWait() {
+    uint64_t value;
+    while (read(inboundBell_, &value, sizeof(value)) == sizeof(value)) {
+    }
+    inbound_.finishWait();
+}
+
+SharedMemoryTransport::SharedMemoryTransport(size_t ringBytes)
+    : ringBytes_(ringBytes) {
+}
+
+SharedMemoryTransport::~SharedMemoryTransport() {
+    stop();
+}
+
+bool SharedMemoryTransport::start(const std::string& path) {
+    if (running_) {
+        return true;
+    }
+
+    struct sockaddr_un address;
+    if (!fillUnixAddress(path, address)) {
+        return false;
+    }
+
+    listenSocket_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenSocket_ == -1) {
+        LOG_ERROR("Failed to create shared memory control socket: {}", strerror(errno));
+        return false;
+    }
+    // 上次运行残留的套接字文件会导致bind失败
+    unlink(path.c_str());
+    if (bind(listenSocket_, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) == -1 ||
+        listen(listenSocket_, 16) == -1) {
+        LOG_ERROR("Failed to listen on shared memory socket {}: {}", path, strerror(errno));
+        close(listenSocket_);
+        listenSocket_ = -1;
+        return false;
+    }
+    path_ = path;
+
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u64 = eventData(EVENT_LISTEN, 0);
+    bool registered = epollFd_ != -1 && wakeFd_ != -1 &&
+                      epoll_ctl(epollFd_, EPOLL_CTL_ADD, listenSocket_, &ev) == 0;
+    ev.data.u64 = eventData(EVENT_WAKE, 0);
+    if (!registered || epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &ev) == -1) {
+        LOG_ERROR("Failed to set up shared memory transport: {}", strerror(errno));
+        running_ = true;
+        stop();
+        return false;
+    }
+
+    running_ = true;
+    thread_ = std::thread(&SharedMemoryTransport::eventLoop, this);
+    LOG_INFO("Shared memory transport listening on {}", path);
+    return true;
+}
+
+void SharedMemoryTransport::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (wakeFd_ != -1) {
+        uint64_t one = 1;
+        if (write(wakeFd_, &one, sizeof(one)) != sizeof(one)) {
+            LOG_ERROR("Failed to wake up shared memory transport: {}", strerror(errno));
+        }
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(channelsMutex_);
+        channels_.clear();
+    }
+    for (int* fd : {&listenSocket_, &epollFd_, &wakeFd_}) {
+        if (*fd != -1) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+    if (!path_.empty()) {
+        unlink(path_.c_str());
+        path_.clear();
+    }
+}
+
+bool SharedMemoryTransport::send(uint32_t channelId, const BufferSlice& frame) {
+    std::shared_ptr<Channel> channel;
+    {
+        std::lock_guard<std::mutex> lock(channelsMutex_);
+        auto it = channels_.find(channelId);
+        if (it == channels_.end()) {
+            return false;
+        }
+        channel = it->second;
+    }
+
+    std::lock_guard<std::mutex> lock(channel->sendMutex);
+    if (!channel->shm->send(frame.data(), frame.size())) {
+        LOG_WARN("Shared memory channel {} is full, dropping frame of {} bytes", channelId, frame.size());
+        return false;
+    }
+    return true;
+}
+
+size_t SharedMemoryTransport::getChannelCount() const {
+    std::lock_guard<std::mutex> lock(channelsMutex_);
+    return channels_.size();
+}
+
+void SharedMemoryTransport::eventLoop() {
+    if (!ThreadPlacement::apply(ThreadRole::TRANSPORT, "shm-transport")) {
+        LOG_WARN("Failed to pin shared memory transport thread to its configured CPUs");
+    }
+    LOG_INFO("Shared memory transport thread started");
+
+    struct epoll_event events[64];
+    while (running_) {
+        int count = epoll_wait(epollFd_, events, 64, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ERROR("Shared memory transport epoll_wait failed: {}", strerror(errno));
+            break;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            EventKind kind = static_cast<EventKind>(events[i].data.u64 >> 32);
+            uint32_t channelId = static_cast<uint32_t>(events[i].data.u64);
+            if (kind == EVENT_WAKE) {
+                continue;
+            }
+            if (kind == EVENT_LISTEN) {
+                acceptChannels();
+                continue;
+            }
+
+            std::shared_ptr<Channel> channel;
+            {
+                std::lock_guard<std::mutex> lock(channelsMutex_);
+                auto it = channels_.find(channelId);
+                if (it == channels_.end()) {
+                    continue;   // 本批事件中已关闭
+                }
+                channel = it->second;
+            }
+
+            if (kind == EVENT_DOORBELL) {
+                drainChannel(channelId, *channel);
+            } else {
+                // 控制连接上不应有数据，可读即表示网关断开
+                char buffer[64];
+                ssize_t received = recv(channel->shm->controlSocket(), buffer, sizeof(buffer), MSG_DONTWAIT);
+                if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK) ||
+                    (events[i].events & (EPOLLHUP | EPOLLERR | EPOLLRDHUP))) {
+                    // 先取走网关关闭前写入的帧
+                    drainChannel(channelId, *channel);
+                    closeChannel(channelId, "gateway disconnected");
+                }
+            }
+        }
+    }
+
+    LOG_INFO("Shared memory transport thread stopped");
+}
+
+void SharedMemoryTransport::acceptChannels() {
+    for (;;) {
+        int controlSocket = accept4(listenSocket_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (controlSocket == -1) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                LOG_ERROR("Shared memory accept failed: {}", strerror(errno));
+            }
+            return;
+        }
+
+        auto shm = SharedMemoryChannel::create(ringBytes_);
+        if (!shm || !shm->handshake(controlSocket)) {
+            if (!shm) {
+                close(controlSocket);
+            }
+            continue;
+        }
+        fcntl(controlSocket, F_SETFL, fcntl(controlSocket, F_GETFL, 0) | O_NONBLOCK);
+
+        auto channel = std::make_shared<Channel>();
+        channel->shm = std::move(shm);
+        uint32_t channelId = nextChannelId_++;
+        if (nextChannelId_ == 0) {
+            nextChannelId_ = 1;
+        }
+
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.u64 = eventData(EVENT_DOORBELL, channelId);
+        bool registered = epoll_ctl(epollFd_, EPOLL_CTL_ADD, channel->shm->doorbellFd(), &ev) == 0;
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.u64 = eventData(EVENT_CONTROL, channelId);
+        registered = registered && epoll_ctl(epollFd_, EPOLL_CTL_ADD, controlSocket, &ev) == 0;
+        if (!registered) {
+            LOG_ERROR("Failed to register shared memory channel: {}", strerror(errno));
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(channelsMutex_);
+            channels_[channelId] = channel;
+        }
+        LOG_INFO("Shared memory channel {} opened", channelId);
+
+        // 网关可能在握手后立即写入，先检查一次再开始等待门铃
+        drainChannel(channelId, *channel);
+    }
+}
+
+void SharedMemoryTransport::drainChannel(uint32_t channelId, Channel& channel) {
+    channel.shm->finishWait();
+    auto deliver = [this, channelId](const char* data, size_t size) {
+        // 环中的空间在回调返回后即被复用，帧需复制出来再交给主循环
+        if (onMessage_) {
+            onMessage_(channelId, BufferSlice::copyFrom(data, size));
+        }
+    };
+
+    // 取空后登记等待，登记期间又有新数据时继续取，不会漏掉门铃
+    do {
+        size_t count = 0;
+        if (!channel.shm->receive(deliver, count)) {
+            closeChannel(channelId, "corrupted ring");
+            return;
+        }
+    } while (!channel.shm->prepareWait());
+}
+
+void SharedMemoryTransport::closeChannel(uint32_t channelId, const char* reason) {
+    std::shared_ptr<Channel> channel;
+    {
+        std::lock_guard<std::mutex> lock(channelsMutex_);
+        auto it = channels_.find(channelId);
+        if (it == channels_.end()) {
+            return;
+        }
+        channel = std::move(it->second);
+        channels_.erase(it);
+    }
+
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, channel->shm->doorbellFd(), nullptr);
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, channel->shm->controlSocket(), nullptr);
+    LOG_INFO("Shared memory channel {} closed: {}", channelId, reason);
+    if (onChannelClosed_) {
+        onChannelClosed_(channelId);
+    }
+}
+
+#else // !__linux__
+
+SharedMemoryChannel::~SharedMemoryChannel() {}
+
+std::unique_ptr<SharedMemoryChannel> SharedMemoryChannel::create(size_t ringBytes) {
+    (void)ringBytes;
+    LOG_ERROR("Shared memory transport is only supported on Linux");
+    return nullptr;
+}
+
+std::unique_ptr<SharedMemoryChannel> SharedMemoryChannel::connect(const std::string& path) {
+    (void)path;
+    LOG_ERROR("Shared memory transport is only supported on Linux");
+    return nullptr;
+}
+
+bool SharedMemoryChannel::map(bool server, bool initialize) {
+    (void)server;
+    (void)initialize;
+    return false;
+}
+
+bool SharedMemoryChannel::handshake(int controlSocket) {
+    (void)controlSocket;
+    return false;
+}
+
+bool SharedMemoryChannel::send(const void* data, size_t size) {
+    (void)data;
+    (void)size;
+    return false;
+}
+
+bool SharedMemoryChannel::receive(const std::function<void(const char*, size_t)>& func, size_t& count) {
+    (void)func;
+    count = 0;
+    return false;
+}
+
+bool SharedMemoryChannel::prepareWait() {
+    return true;
+}
+
+void SharedMemoryChannel::finishWait() {}
+
+SharedMemoryTransport::SharedMemoryTransport(size_t ringBytes) : ringBytes_(ringBytes) {}
+
+SharedMemoryTransport::~SharedMemoryTransport() {}
+
+bool SharedMemoryTransport::start(const std::string& path) {
+    (void)path;
+    LOG_ERROR("Shared memory transport is only supported on Linux");
+    return false;
+}
+
+void SharedMemoryTransport::stop() {}
+
+bool SharedMemoryTransport::send(uint32_t channelId, const BufferSlice& frame) {
+    (void)channelId;
+    (void)frame;
+    return false;
+}
+
+size_t SharedMemoryTransport::getChannelCount() const {
+    return 0;
+}
+
+#endif // __linux__
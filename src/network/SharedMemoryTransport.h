@@ -0,0 +1,122 @@
+#pragma once
+
+#include "SocketTypes.h"
+#include "ShmRing.h"
+#include "../messaging/buffer_slice.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+// 同机进程（前置网关）与GameServer之间的共享内存通道
+// 一块memfd中放两个ShmRing（网关->服务端、服务端->网关），每个方向一个eventfd门铃；
+// 网关连接服务端的AF_UNIX控制套接字，服务端创建通道后用SCM_RIGHTS把memfd和两个eventfd传给网关，
+// 控制连接在通道存续期间保持打开，任一方关闭即拆除通道
+// 环中的每条记录是一个完整的MessageHeader帧，与TCP上的格式相同
+// 目前只支持Linux（memfd_create/eventfd），其他平台上创建和连接均失败
+class SharedMemoryChannel {
+public:
+    ~SharedMemoryChannel();
+
+    SharedMemoryChannel(const SharedMemoryChannel&) = delete;
+    SharedMemoryChannel& operator=(const SharedMemoryChannel&) = delete;
+
+    // 服务端：创建共享内存和门铃，ringBytes为每个方向的容量（向上取整为2的幂）
+    static std::unique_ptr<SharedMemoryChannel> create(size_t ringBytes);
+    // 网关端：连接服务端的控制套接字，接收描述符并映射共享内存（阻塞直到握手完成）
+    static std::unique_ptr<SharedMemoryChannel> connect(const std::string& path);
+
+    // 服务端：通过已接受的控制连接把描述符发给网关，之后通道的生命周期跟随该连接
+    bool handshake(int controlSocket);
+
+    // 写入一帧，对端在等待时敲门铃；环已满或帧过大时返回false
+    // 同一时刻只能有一个线程调用
+    bool send(const void* data, size_t size);
+
+    // 取出对端写入的所有帧，func(const char* data, size_t size)中的指针只在回调期间有效
+    // 返回取出的帧数；环中数据损坏时返回false
+    bool receive(const std::function<void(const char*, size_t)>& func, size_t& count);
+
+    // 准备在doorbellFd上等待：对端已有新数据时返回false，应继续receive而不是睡眠
+    bool prepareWait();
+    // 门铃可读后调用，清空计数并清除等待标志
+    void finishWait();
+
+    // 对端写入后变为可读，可加入epoll/poll
+    int doorbellFd() const { return inboundBell_; }
+    int controlSocket() const { return controlSocket_; }
+    size_t maxFrameSize() const { return outbound_.maxRecordSize(); }
+
+private:
+    SharedMemoryChannel() = default;
+
+    // 映射memfd并初始化两个环，server为true时环0为入站方向
+    bool map(bool server, bool initialize);
+
+    int memFd_ = -1;
+    int inboundBell_ = -1;      // 本端等待的门铃
+    int outboundBell_ = -1;     // 通知对端的门铃
+    int controlSocket_ = -1;
+    uint64_t ringBytes_ = 0;
+    void* mapping_ = nullptr;
+    size_t mappingSize_ = 0;
+    ShmRing inbound_;
+    ShmRing outbound_;
+};
+
+// 服务端共享内存传输：监听AF_UNIX控制套接字，为每个网关连接创建一个通道，
+// 由一个线程在epoll中等待各通道的门铃和控制连接；消息回调在该线程中调用
+class SharedMemoryTransport {
+public:
+    using MessageCallback = std::function<void(uint32_t channelId, const BufferSlice& frame)>;
+    using ChannelCallback = std::function<void(uint32_t channelId)>;
+
+    explicit SharedMemoryTransport(size_t ringBytes);
+    ~SharedMemoryTransport();
+
+    SharedMemoryTransport(const SharedMemoryTransport&) = delete;
+    SharedMemoryTransport& operator=(const SharedMemoryTransport&) = delete;
+
+    // 回调需在start之前设置
+    void setMessageCallback(MessageCallback callback) { onMessage_ = std::move(callback); }
+    void setChannelClosedCallback(ChannelCallback callback) { onChannelClosed_ = std::move(callback); }
+
+    bool start(const std::string& path);
+    void stop();
+
+    // 写入通道的出站环，可从任意线程调用；通道不存在或环已满时返回false
+    bool send(uint32_t channelId, const BufferSlice& frame);
+
+    size_t getChannelCount() const;
+
+private:
+    struct Channel {
+        std::unique_ptr<SharedMemoryChannel> shm;
+        std::mutex sendMutex;   // 出站环只允许一个生产者，多个业务线程发送时在此串行
+    };
+
+    void eventLoop();
+    void acceptChannels();
+    void drainChannel(uint32_t channelId, Channel& channel);
+    void closeChannel(uint32_t channelId, const char* reason);
+
+    size_t ringBytes_;
+    std::string path_;
+    int listenSocket_ = -1;
+    int epollFd_ = -1;
+    int wakeFd_ = -1;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+
+    uint32_t nextChannelId_ = 1;
+    std::unordered_map<uint32_t, std::shared_ptr<Channel>> channels_;
+    mutable std::mutex channelsMutex_;
+
+    MessageCallback onMessage_;
+    ChannelCallback onChannelClosed_;
+};
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// 共享内存中的单生产者单消费者环形缓冲区，两个进程各持有一端
+// 每条记录为4字节长度加数据，按8字节对齐；记录不跨越缓冲区末尾，放不下时写入填充标记并从头开始，
+// 因此消费者拿到的每条记录都是连续内存，可以直接解析
+// 门铃：消费者准备睡眠前置位consumerWaiting并复查head，生产者发布head后检查该标志，
+// 只有消费者确实在等待时才需要写eventfd，持续收发时不产生系统调用
+struct ShmRingHeader {
+    static constexpr uint32_t MAGIC = 0x53484d52;   // "SHMR"
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;                              // 数据区字节数，2的幂
+
+    alignas(64) std::atomic<uint64_t> head;         // 生产者写入位置（单调递增）
+    alignas(64) std::atomic<uint64_t> tail;         // 消费者读取位置（单调递增）
+    alignas(64) std::atomic<uint32_t> consumerWaiting;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "shared memory ring needs address-free atomics");
+
+class ShmRing {
+public:
+    ShmRing() = default;
+
+    // base指向regionSize(capacity)字节的共享内存；initialize为true时由创建方初始化头部
+    ShmRing(void* base, uint64_t capacity, bool initialize)
+        : header_(static_cast<ShmRingHeader*>(base)),
+          data_(static_cast<char*>(base) + sizeof(ShmRingHeader)),
+          capacity_(capacity), mask_(capacity - 1) {
+        if (initialize) {
+            header_->magic = ShmRingHeader::MAGIC;
+            header_->version = ShmRingHeader::VERSION;
+            header_->capacity = capacity;
+            header_->head.store(0, std::memory_order_relaxed);
+            header_->tail.store(0, std::memory_order_relaxed);
+            header_->consumerWaiting.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    static size_t regionSize(uint64_t capacity) {
+        return sizeof(ShmRingHeader) + static_cast<size_t>(capacity);
+    }
+
+    // 映射方检查对端初始化的头部与约定的容量一致
+    bool isValid() const {
+        return header_ && header_->magic == ShmRingHeader::MAGIC &&
+               header_->version == ShmRingHeader::VERSION && header_->capacity == capacity_;
+    }
+
+    // 单条记录的上限，保证任意时刻都能放下一条最大记录和一段填充
+    size_t maxRecordSize() const { return static_cast<size_t>(capacity_ / 2) - LENGTH_SIZE; }
+
+    // 生产者：写入一条记录，空间不足或记录过大时返回false；wakeConsumer返回是否需要敲门铃
+    bool write(const void* data, size_t size, bool& wakeConsumer) {
+        wakeConsumer = false;
+        if (size > maxRecordSize()) {
+            return false;
+        }
+
+        uint64_t head = header_->head.load(std::memory_order_relaxed);
+        uint64_t tail = header_->tail.load(std::memory_order_acquire);
+        uint64_t need = alignedSize(size);
+        uint64_t offset = head & mask_;
+        uint64_t contiguous = capacity_ - offset;
+        uint64_t padding = need > contiguous ? contiguous : 0;
+        if (head + padding + need - tail > capacity_) {
+            return false;
+        }
+
+        if (padding > 0) {
+            // 剩余空间至少8字节（所有记录8字节对齐），足够写入填充标记
+            storeLength(offset, PADDING);
+            head += padding;
+            offset = 0;
+        }
+        storeLength(offset, static_cast<uint32_t>(size));
+        if (size > 0) {
+            memcpy(data_ + offset + LENGTH_SIZE, data, size);
+        }
+
+        // 发布与检查等待标志之间需要全序，与消费者的prepareWait配对，避免丢失唤醒
+        header_->head.store(head + need, std::memory_order_seq_cst);
+        wakeConsumer = header_->consumerWaiting.load(std::memory_order_seq_cst) != 0;
+        return true;
+    }
+
+    // 消费者：依次取出所有已发布的记录，func(const char* data, size_t size)中的指针只在回调期间有效
+    // 返回取出的记录数；发现损坏的记录时停止并把corrupted置为true
+    // head由对端写入，不可信：超前tail超过容量、未对齐，或记录/填充越过head，都按损坏处理，不会空转
+    template <typename Func>
+    size_t drain(Func&& func, bool& corrupted) {
+        corrupted = false;
+        size_t count = 0;
+        uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+        uint64_t head = header_->head.load(std::memory_order_acquire);
+        while (tail != head) {
+            uint64_t available = head - tail;
+            if (available > capacity_ || (available & 7) != 0) {
+                corrupted = true;
+                break;
+            }
+            uint64_t offset = tail & mask_;
+            uint32_t length = loadLength(offset);
+            if (length == PADDING) {
+                uint64_t padding = capacity_ - offset;
+                if (padding > available) {
+                    corrupted = true;
+                    break;
+                }
+                tail += padding;
+                header_->tail.store(tail, std::memory_order_release);
+                continue;
+            }
+            if (LENGTH_SIZE + static_cast<uint64_t>(length) > capacity_ - offset || alignedSize(length) > available) {
+                corrupted = true;
+                break;
+            }
+            func(data_ + offset + LENGTH_SIZE, static_cast<size_t>(length));
+            // 回调返回后才释放空间，生产者不会覆盖回调正在读取的数据
+            tail += alignedSize(length);
+            header_->tail.store(tail, std::memory_order_release);
+            ++count;
+        }
+        return count;
+    }
+
+    // 消费者：准备睡眠，已有新数据时返回false（不需要睡眠）
+    bool prepareWait() {
+        header_->consumerWaiting.store(1, std::memory_order_seq_cst);
+        if (header_->head.load(std::memory_order_seq_cst) != header_->tail.load(std::memory_order_relaxed)) {
+            header_->consumerWaiting.store(0, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    // 消费者：被唤醒后清除等待标志
+    void finishWait() {
+        header_->consumerWaiting.store(0, std::memory_order_relaxed);
+    }
+
+    bool empty() const {
+        return header_->head.load(std::memory_order_acquire) == header_->tail.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr uint32_t PADDING = UINT32_MAX;
+    static constexpr uint64_t LENGTH_SIZE = sizeof(uint32_t);
+
+    static uint64_t alignedSize(size_t size) {
+        return (LENGTH_SIZE + size + 7) & ~static_cast<uint64_t>(7);
+    }
+
+    void storeLength(uint64_t offset, uint32_t length) {
+        memcpy(data_ + offset, &length, sizeof(length));
+    }
+
+    uint32_t loadLength(uint64_t offset) const {
+        uint32_t length;
+        memcpy(&length, data_ + offset, sizeof(length));
+        return length;
+    }
+
+    ShmRingHeader* header_ = nullptr;
+    char* data_ = nullptr;
+    uint64_t capacity_ = 0;
+    uint64_t mask_ = 0;
+};
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+// 分层时间轮 - 4层、每层64个槽，定时器为侵入式双向链表节点，设置与取消均为O(1)
+// 第0层每槽一个tick，上层每槽覆盖下层整圈；上层槽位到期时把其中的定时器按剩余时间重新放入下层（级联）
+// 超出最高层范围的定时器放在最高层最远的槽中，级联时再按实际到期时间重新放置
+// 非线程安全：定时器只能在驱动advance的线程中设置和取消
+class TimingWheel {
+private:
+    struct Link {
+        Link* prev = this;
+        Link* next = this;
+    };
+
+public:
+    // 定时器节点，嵌入在所属对象中；销毁时自动从时间轮中取消
+    class Timer : private Link {
+    public:
+        Timer() = default;
+        ~Timer() { cancel(); }
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        bool isScheduled() const { return wheel_ != nullptr; }
+
+        void cancel() {
+            if (wheel_) {
+                wheel_->unlink(this);
+            }
+        }
+
+        // 到期回调，在advance中调用；回调中可以重新设置本定时器，但不能销毁它
+        std::function<void()> callback;
+
+    private:
+        friend class TimingWheel;
+        TimingWheel* wheel_ = nullptr;
+        uint64_t expireTick_ = 0;
+    };
+
+    // tickMs为时间精度，nowMs为起始时间（与之后传给advance的时间使用同一时钟）
+    explicit TimingWheel(uint32_t tickMs = 1000, uint64_t nowMs = 0)
+        : tickMs_(tickMs > 0 ? tickMs : 1), startMs_(nowMs), nowMs_(nowMs) {}
+
+    ~TimingWheel() {
+        for (auto& level : levels_) {
+            for (Link& slot : level) {
+                while (slot.next != &slot) {
+                    unlink(static_cast<Timer*>(slot.next));
+                }
+            }
+        }
+    }
+
+    TimingWheel(const TimingWheel&) = delete;
+    TimingWheel& operator=(const TimingWheel&) = delete;
+
+    // 在delayMs后触发定时器（实际触发时间在[delayMs, delayMs + tickMs)内），已设置的定时器先被取消
+    void schedule(Timer& timer, uint64_t delayMs) {
+        timer.cancel();
+        uint64_t ticks = (delayMs + tickMs_ - 1) / tickMs_;
+        timer.expireTick_ = currentTick_ + (ticks > 0 ? ticks : 1);
+        timer.wheel_ = this;
+        place(&timer);
+        ++size_;
+    }
+
+    void cancel(Timer& timer) {
+        if (timer.wheel_ == this) {
+            unlink(&timer);
+        }
+    }
+
+    // 推进到nowMs，依次触发所有已到期的定时器，返回触发的数量
+    size_t advance(uint64_t nowMs) {
+        if (nowMs < nowMs_) {
+            return 0;
+        }
+        nowMs_ = nowMs;
+
+        size_t fired = 0;
+        uint64_t targetTick = (nowMs - startMs_) / tickMs_;
+        while (currentTick_ <= targetTick) {
+            // 第0层转完一圈时，从上层取出覆盖接下来64个tick的槽位下放
+            if ((currentTick_ & SLOT_MASK) == 0) {
+                for (int level = 1; level < LEVELS; ++level) {
+                    uint64_t index = (currentTick_ >> (level * SLOT_BITS)) & SLOT_MASK;
+                    cascade(levels_[level][index]);
+                    if (index != 0) {
+                        break;
+                    }
+                }
+            }
+
+            // 先把当前槽移到局部链表，回调中重新设置的定时器不会在本tick再次触发
+            Link expired;
+            splice(levels_[0][currentTick_ & SLOT_MASK], expired);
+            while (expired.next != &expired) {
+                Timer* timer = static_cast<Timer*>(expired.next);
+                unlink(timer);
+                ++fired;
+                if (timer->callback) {
+                    timer->callback();
+                }
+            }
+            ++currentTick_;
+        }
+        return fired;
+    }
+
+    // 最近一次advance的时间，可作为低精度的当前时间使用
+    uint64_t now() const { return nowMs_; }
+    uint32_t tickMs() const { return tickMs_; }
+
+    // 已设置的定时器数量
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 6;
+    static constexpr uint64_t SLOTS = 1ULL << SLOT_BITS;
+    static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+    static constexpr uint64_t MAX_DELTA = (1ULL << (LEVELS * SLOT_BITS)) - 1;
+
+    // 按距当前tick的剩余tick数选择层，在该层中按到期tick的对应位选择槽
+    void place(Timer* timer) {
+        uint64_t expire = timer->expireTick_;
+        uint64_t delta = expire > currentTick_ ? expire - currentTick_ : 0;
+        if (delta > MAX_DELTA) {
+            delta = MAX_DELTA;
+            expire = currentTick_ + MAX_DELTA;
+        }
+
+        int level = 0;
+        while (level < LEVELS - 1 && delta >= (1ULL << ((level + 1) * SLOT_BITS))) {
+            ++level;
+        }
+        // 已过期的定时器放在当前槽中，在本tick触发
+        uint64_t index = delta == 0 ? (currentTick_ & SLOT_MASK) : (expire >> (level * SLOT_BITS)) & SLOT_MASK;
+        linkBefore(&levels_[level][index], timer);
+    }
+
+    void cascade(Link& slot) {
+        Link pending;
+        splice(slot, pending);
+        while (pending.next != &pending) {
+            Timer* timer = static_cast<Timer*>(pending.next);
+            removeLink(timer);
+            place(timer);
+        }
+    }
+
+    void unlink(Timer* timer) {
+        removeLink(timer);
+        timer->wheel_ = nullptr;
+        --size_;
+    }
+
+    static void linkBefore(Link* head, Link* node) {
+        node->prev = head->prev;
+        node->next = head;
+        head->prev->next = node;
+        head->prev = node;
+    }
+
+    static void removeLink(Link* node) {
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+        node->prev = node;
+        node->next = node;
+    }
+
+    // 把from中的全部节点移到空链表to中
+    static void splice(Link& from, Link& to) {
+        if (from.next == &from) {
+            return;
+        }
+        to.next = from.next;
+        to.prev = from.prev;
+        to.next->prev = &to;
+        to.prev->next = &to;
+        from.next = &from;
+        from.prev = &from;
+    }
+
+    uint32_t tickMs_;
+    uint64_t startMs_;
+    uint64_t nowMs_;
+    uint64_t currentTick_ = 0;      // 下一个待处理的tick
+    size_t size_ = 0;
+    Link levels_[LEVELS][SLOTS];
+};
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "SocketTypes.h"
+#include "ReliableUdp.h"
+#include "MpscQueue.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// 可靠UDP传输：一个UDP套接字和一个I/O线程承载所有会话
+// 会话以数据报头部的conv区分，服务端在收到未知conv的数据报时创建会话，并只接受来自同一地址的后续数据报；
+// 收发使用recvmmsg/sendmmsg批量处理，每次系统调用最多处理BATCH_SIZE个数据报
+// 线程模型与LinuxEpoll相同：会话只由I/O线程访问，其他线程的send/close封装为命令投递到MPSC队列，由eventfd唤醒
+// conv由对端选择，会话关闭后可能被新会话复用；每个会话另分配一个代数，send/close携带的代数不符时丢弃，
+// 发给已关闭会话的消息不会落到复用同一conv的新会话上
+// 目前只支持Linux，其他平台上start返回false
+class UdpTransport {
+public:
+    using MessageCallback = std::function<void(uint32_t conv, uint32_t generation, const BufferSlice& message, UdpChannel channel)>;
+    using SessionCallback = std::function<void(uint32_t conv, uint32_t generation)>;
+
+    static constexpr size_t BATCH_SIZE = 64;
+    // 会话代数只用低30位且不为0，可以直接放入ConnectionId::datagram
+    static constexpr uint32_t GENERATION_MASK = 0x3fffffffu;
+
+    explicit UdpTransport(const ReliableUdpOptions& options = ReliableUdpOptions());
+    ~UdpTransport();
+
+    UdpTransport(const UdpTransport&) = delete;
+    UdpTransport& operator=(const UdpTransport&) = delete;
+
+    // 回调在I/O线程中调用，需在start之前设置
+    void setMessageCallback(MessageCallback callback) { onMessage_ = std::move(callback); }
+    void setSessionClosedCallback(SessionCallback callback) { onSessionClosed_ = std::move(callback); }
+
+    // 绑定端口（0为任意端口）并启动I/O线程
+    bool start(const std::string& bindAddress, uint16_t port);
+    void stop();
+    bool isRunning() const { return running_.load(); }
+
+    // 实际绑定的端口
+    uint16_t getLocalPort() const { return localPort_; }
+
+    // 作为客户端向远端建立会话（conv由调用方分配，不能为0），可从任意线程调用；返回会话代数，失败时返回0
+    uint32_t connect(uint32_t conv, const std::string& host, uint16_t port);
+    // 以下可从任意线程调用，会话不存在或代数不符（conv已被新会话复用）时在I/O线程中丢弃
+    bool send(uint32_t conv, uint32_t generation, const BufferSlice& message, UdpChannel channel = UdpChannel::RELIABLE);
+    void closeSession(uint32_t conv, uint32_t generation);
+
+    size_t getSessionCount() const { return sessionCount_.load(std::memory_order_relaxed); }
+
+private:
+    struct Peer {
+        struct sockaddr_in address{};
+        uint32_t generation = 0;
+        std::unique_ptr<ReliableUdpSession> session;
+        uint32_t lastReceiveMs = 0;
+        bool dirty = false;     // 本轮有新数据或新消息，轮末立即flush
+    };
+
+    struct Command {
+        enum Type { CONNECT, SEND, CLOSE } type = SEND;
+        uint32_t conv = 0;
+        uint32_t generation = 0;
+        UdpChannel channel = UdpChannel::RELIABLE;
+        BufferSlice data;
+        struct sockaddr_in address{};
+    };
+
+    struct Datagram {
+        struct sockaddr_in address{};
+        std::string data;
+    };
+
+    void eventLoop();
+    void receiveBatch(uint32_t nowMs);
+    void runCommands(uint32_t nowMs);
+    void tick(uint32_t nowMs);
+    void flushDirty(uint32_t nowMs);
+    void sendBatch();
+
+    Peer* createPeer(uint32_t conv, uint32_t generation, const struct sockaddr_in& address, uint32_t nowMs);
+    uint32_t allocateGeneration();
+    void removePeer(uint32_t conv, const char* reason);
+    // 会话的数据报先暂存，本轮结束时一次sendmmsg发出
+    void queueDatagram(const struct sockaddr_in& address, const char* data, size_t size);
+
+    void postCommand(Command command);
+    void wakeup();
+    uint32_t nowMs() const;
+
+    ReliableUdpOptions options_;
+    socket_t socket_ = INVALID_SOCKET_VALUE;
+    int wakeFd_ = -1;
+    uint16_t localPort_ = 0;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> wakeupPending_{false};
+    std::thread thread_;
+
+    std::unordered_map<uint32_t, Peer> peers_;
+    std::vector<uint32_t> dirtyPeers_;
+    std::atomic<size_t> sessionCount_{0};
+    // connect在调用线程分配代数，被动创建的会话在I/O线程分配，因此为原子变量
+    std::atomic<uint32_t> nextGeneration_{1};
+    MpscQueue<Command> commands_;
+
+    // 发送暂存区，Datagram的字符串容量在各轮之间复用
+    std::vector<Datagram> outbox_;
+    size_t outboxSize_ = 0;
+    std::vector<char> receiveBuffer_;   // BATCH_SIZE个mtu大小的接收缓冲区
+    std::minstd_rand lossRandom_;
+
+    MessageCallback onMessage_;
+    SessionCallback onSessionClosed_;
+};
@@ -145,12 +145,12 @@ bool WindowsIOCP::asyncRead(socket_t socket, const std::string& buffer, EventCal
     return false;
 }
 
-bool WindowsIOCP::asyncWrite(socket_t socket, const std::string& data, EventCallback callback) {
+bool WindowsIOCP::asyncWrite(socket_t socket, const BufferSlice& data, EventCallback callback) {
     std::lock_guard<std::mutex> lock(contextsMutex_);
     auto it = socketContexts_.find(socket);
     if (it != socketContexts_.end()) {
         it->second->callback = callback;
-        it->second->writeBuffer = data;
+        it->second->writeBuffer = data.toString();
         return postWrite(it->second.get());
     }
     return false;
@@ -43,7 +43,7 @@ public:
     bool modifySocket(socket_t socket, IOEventType events) override;
     
     bool asyncRead(socket_t socket, const std::string& buffer, EventCallback callback) override;
-    bool asyncWrite(socket_t socket, const std::string& data, EventCallback callback) override;
+    bool asyncWrite(socket_t socket, const BufferSlice& data, EventCallback callback) override;
     bool asyncAccept(socket_t serverSocket, EventCallback callback) override;
     
     bool startEventLoop() override;
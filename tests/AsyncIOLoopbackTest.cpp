@@ -0,0 +1,335 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <future>
+#include <sys/time.h>
+#include <netinet/tcp.h>
+#include "spdlog/spdlog.h"
+
+#include "../src/network/LinuxEpoll.h"
+#include "../src/network/LinuxIoUring.h"
+
+// 异步I/O后端回环测试：在127.0.0.1上启动回显服务端，检查
+//   1. 事件循环线程内的回显（读回调中asyncWrite）按序完整到达
+//   2. 其他线程的asyncWrite/asyncWriteBatch经命令队列投递，数据完整、同一连接内保持顺序
+//   3. 其他线程removeSocket后立即关闭fd、fd被新连接复用时，新连接不受影响
+// 后端由参数选择，同一组检查对epoll和io_uring都执行
+class AsyncIOLoopbackTest
+{
+private:
+    AsyncIOOptions options;
+    int clientCount;
+    int rounds;
+
+    std::unique_ptr<AsyncIO> io;
+    socket_t listenSocket = INVALID_SOCKET_VALUE;
+    uint16_t port = 0;
+
+    std::mutex mutex;
+    std::vector<socket_t> accepted;     // 服务端连接，按接受顺序
+    std::atomic<int> closedCount{0};
+
+public:
+    AsyncIOLoopbackTest(AsyncIOBackend backend, int clients, int roundCount)
+        : clientCount(clients), rounds(roundCount)
+    {
+        options.backend = backend;
+    }
+
+    static const char* backendName(AsyncIOBackend backend)
+    {
+        return backend == AsyncIOBackend::IO_URING ? "io_uring" : "epoll";
+    }
+
+    // 第i条消息，长度覆盖单个接收缓冲区和跨多次发送两种情况
+    static std::string makeMessage(int client, int i)
+    {
+        size_t length = 32 + (static_cast<size_t>(client * 131 + i) * 7919) % 48000;
+        std::string message(length, static_cast<char>('a' + (client + i) % 26));
+        std::string tag = std::to_string(client) + ":" + std::to_string(i) + ";";
+        message.replace(0, tag.size(), tag);
+        return message;
+    }
+
+    bool startServer()
+    {
+        io = AsyncIOFactory::createAsyncIO(options);
+        if (!io || !io->initialize()) {
+            return false;
+        }
+
+        listenSocket = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        struct sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        if (listenSocket == INVALID_SOCKET_VALUE ||
+            bind(listenSocket, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0 ||
+            ::listen(listenSocket, 128) != 0 ||
+            getsockname(listenSocket, reinterpret_cast<struct sockaddr*>(&address), &length) != 0) {
+            spdlog::error("Failed to create listening socket: {}", strerror(errno));
+            return false;
+        }
+        port = ntohs(address.sin_port);
+
+        io->addSocket(listenSocket, IOEventType::READ);
+        io->asyncAccept(listenSocket, [this](const IOEvent& event) { onAccept(event); });
+        return io->startEventLoop();
+    }
+
+    // 运行在事件循环线程中
+    void onAccept(const IOEvent& event)
+    {
+        for (;;) {
+            socket_t clientSocket = event.acceptedSocket;
+            if (clientSocket == INVALID_SOCKET_VALUE) {
+                clientSocket = accept4(event.socket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (clientSocket == INVALID_SOCKET_VALUE) {
+                    return;
+                }
+            }
+            io->addSocket(clientSocket, IOEventType::READ | IOEventType::IOERROR);
+            io->asyncRead(clientSocket, "", [this](const IOEvent& readEvent) { onRead(readEvent); });
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                accepted.push_back(clientSocket);
+            }
+            // 后端已完成accept时每个事件只有一个连接
+            if (event.acceptedSocket != INVALID_SOCKET_VALUE) {
+                return;
+            }
+        }
+    }
+
+    // 运行在事件循环线程中：收到的数据原样写回
+    void onRead(const IOEvent& event)
+    {
+        if (event.eventType == IOEventType::IOERROR) {
+            io->removeSocket(event.socket);
+            CLOSE_SOCKET(event.socket);
+            closedCount++;
+            return;
+        }
+        if (event.eventType == IOEventType::READ && !event.data.empty()) {
+            io->asyncWrite(event.socket, event.data, nullptr);
+        }
+    }
+
+    socket_t connectClient()
+    {
+        socket_t clientSocket = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        struct sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(port);
+        if (connect(clientSocket, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0) {
+            CLOSE_SOCKET(clientSocket);
+            return INVALID_SOCKET_VALUE;
+        }
+        struct timeval timeout{5, 0};
+        setsockopt(clientSocket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        int noDelay = 1;
+        setsockopt(clientSocket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        return clientSocket;
+    }
+
+    static bool sendAll(socket_t socket, const std::string& data)
+    {
+        size_t offset = 0;
+        while (offset < data.size()) {
+            ssize_t sent = send(socket, data.data() + offset, data.size() - offset, MSG_NOSIGNAL);
+            if (sent <= 0) {
+                return false;
+            }
+            offset += static_cast<size_t>(sent);
+        }
+        return true;
+    }
+
+    static bool receiveExactly(socket_t socket, const std::string& expected)
+    {
+        std::string received(expected.size(), '\0');
+        size_t offset = 0;
+        while (offset < received.size()) {
+            ssize_t count = recv(socket, &received[offset], received.size() - offset, 0);
+            if (count <= 0) {
+                return false;
+            }
+            offset += static_cast<size_t>(count);
+        }
+        return received == expected;
+    }
+
+    // 等待服务端接受到total个连接，返回其中最后count个
+    bool waitAccepted(size_t total, size_t count, std::vector<socket_t>& servers)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (std::chrono::steady_clock::now() < deadline) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (accepted.size() >= total) {
+                    servers.assign(accepted.end() - count, accepted.end());
+                    return true;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+    // 各客户端交替发送，随后依次读回
+    bool echoRounds(const std::vector<socket_t>& clients, int roundCount)
+    {
+        for (int round = 0; round < roundCount; ++round) {
+            for (size_t c = 0; c < clients.size(); ++c) {
+                if (!sendAll(clients[c], makeMessage(static_cast<int>(c), round))) {
+                    spdlog::error("Client {} failed to send round {}", c, round);
+                    return false;
+                }
+            }
+            for (size_t c = 0; c < clients.size(); ++c) {
+                if (!receiveExactly(clients[c], makeMessage(static_cast<int>(c), round))) {
+                    spdlog::error("Client {} got a wrong echo in round {}", c, round);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // 从测试线程（非事件循环线程）向服务端连接推送：逐个asyncWrite后再整批asyncWriteBatch
+    bool crossThreadWrites(const std::vector<socket_t>& clients, const std::vector<socket_t>& servers)
+    {
+        std::string broadcast(20000, 'B');
+        for (size_t c = 0; c < servers.size(); ++c) {
+            io->asyncWrite(servers[c], BufferSlice(makeMessage(static_cast<int>(c), -1)), nullptr);
+        }
+        io->asyncWriteBatch(servers, BufferSlice(broadcast), nullptr);
+
+        for (size_t c = 0; c < clients.size(); ++c) {
+            if (!receiveExactly(clients[c], makeMessage(static_cast<int>(c), -1) + broadcast)) {
+                spdlog::error("Client {} got wrong cross-thread data", c);
+                return false;
+            }
+        }
+
+        // runInLoop在事件循环线程中执行，并排在之前投递的命令之后
+        std::promise<bool> inLoop;
+        std::future<bool> result = inLoop.get_future();
+        if (!io->runInLoop([this, &inLoop, &servers]() { inLoop.set_value(io->isSocketRegistered(servers[0])); }) ||
+            result.wait_for(std::chrono::seconds(5)) != std::future_status::ready || !result.get()) {
+            spdlog::error("runInLoop did not run on the event loop");
+            return false;
+        }
+        return true;
+    }
+
+    // 测试线程移除服务端连接并立即关闭fd，随后的新连接会复用这些fd
+    bool removeAndReuse(std::vector<socket_t>& clients, const std::vector<socket_t>& servers)
+    {
+        for (socket_t server : servers) {
+            io->removeSocket(server);
+            CLOSE_SOCKET(server);
+        }
+        for (socket_t& client : clients) {
+            CLOSE_SOCKET(client);
+            client = connectClient();
+            if (client == INVALID_SOCKET_VALUE) {
+                spdlog::error("Reconnect failed");
+                return false;
+            }
+        }
+
+        std::vector<socket_t> reused;
+        if (!waitAccepted(servers.size() * 2, servers.size(), reused)) {
+            spdlog::error("Server did not accept reconnected clients");
+            return false;
+        }
+        return echoRounds(clients, 2);
+    }
+
+    bool run()
+    {
+        spdlog::info("=== Async I/O Loopback Test ({}, {} clients, {} rounds) ===",
+                     backendName(options.backend), clientCount, rounds);
+
+        if (!startServer()) {
+            spdlog::error("Failed to start {} backend", backendName(options.backend));
+            return false;
+        }
+
+        std::vector<socket_t> clients;
+        for (int i = 0; i < clientCount; ++i) {
+            socket_t client = connectClient();
+            if (client == INVALID_SOCKET_VALUE) {
+                spdlog::error("Connect failed: {}", strerror(errno));
+                return false;
+            }
+            clients.push_back(client);
+        }
+
+        auto startTime = std::chrono::steady_clock::now();
+        std::vector<socket_t> servers;
+        bool passed = waitAccepted(clients.size(), clients.size(), servers);
+        passed = passed && echoRounds(clients, rounds);
+        passed = passed && crossThreadWrites(clients, servers);
+        passed = passed && removeAndReuse(clients, servers);
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+
+        for (socket_t client : clients) {
+            CLOSE_SOCKET(client);
+        }
+        io->stopEventLoop();
+        io->shutdown();
+        CLOSE_SOCKET(listenSocket);
+
+        if (passed) {
+            spdlog::info("{} loopback test passed, {} ms", backendName(options.backend), elapsed.count());
+        } else {
+            spdlog::error("{} loopback test failed", backendName(options.backend));
+        }
+        return passed;
+    }
+};
+
+int main(int argc, char* argv[])
+{
+    std::vector<AsyncIOBackend> backends;
+    int clientCount = 8;
+    int rounds = 50;
+
+    // 解析命令行参数，未指定后端时依次测试所有后端
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if ((arg == "-b" || arg == "--backend") && i + 1 < argc)
+        {
+            std::string name = argv[++i];
+            backends.push_back(name == "io_uring" ? AsyncIOBackend::IO_URING : AsyncIOBackend::EPOLL);
+        }
+        else if ((arg == "-c" || arg == "--clients") && i + 1 < argc)
+        {
+            clientCount = std::stoi(argv[++i]);
+        }
+        else if ((arg == "-n" || arg == "--rounds") && i + 1 < argc)
+        {
+            rounds = std::stoi(argv[++i]);
+        }
+    }
+    if (backends.empty())
+    {
+        backends = {AsyncIOBackend::EPOLL, AsyncIOBackend::IO_URING};
+    }
+
+    bool passed = true;
+    for (AsyncIOBackend backend : backends)
+    {
+        AsyncIOLoopbackTest test(backend, clientCount, rounds);
+        passed = test.run() && passed;
+    }
+    return passed ? 0 : 1;
+}
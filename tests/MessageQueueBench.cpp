@@ -0,0 +1,169 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <queue>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "spdlog/spdlog.h"
+
+#include "../src/messaging/message.h"
+
+// MessageQueue竞争基准：多个生产者线程（模拟reactor）同时入队，一个消费者线程（模拟主循环）取出，
+// 对比无锁队列与原先std::mutex + condition_variable的实现
+namespace {
+
+// 原先的实现，作为对照
+class LockedMessageQueue {
+public:
+    void push(MessagePtr message) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push(std::move(message));
+        condition_.notify_one();
+    }
+
+    MessagePtr pop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this] { return !queue_.empty(); });
+        MessagePtr message = std::move(queue_.front());
+        queue_.pop();
+        return message;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::queue<MessagePtr> queue_;
+};
+
+MessagePtr makeMessage(int producer) {
+    return std::make_unique<Message>(MessageType::CUSTOM, BufferSlice(), ConnectionId(static_cast<uint32_t>(producer), 1));
+}
+
+struct Result {
+    double millionsPerSecond = 0;
+    uint64_t fullRetries = 0;
+    bool complete = false;
+};
+
+// 生产者同时开始，消费者收齐所有消息后计时结束
+template <typename ProduceFunc, typename ConsumeFunc>
+Result runBenchmark(int producers, int messagesPerProducer, ProduceFunc produce, ConsumeFunc consume) {
+    std::atomic<bool> go{false};
+    std::atomic<uint64_t> fullRetries{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            uint64_t retries = 0;
+            for (int i = 0; i < messagesPerProducer; ++i) {
+                retries += produce(p);
+            }
+            fullRetries += retries;
+        });
+    }
+
+    uint64_t total = static_cast<uint64_t>(producers) * messagesPerProducer;
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    uint64_t received = consume(total);
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    Result result;
+    result.millionsPerSecond = received / elapsed / 1e6;
+    result.fullRetries = fullRetries.load();
+    result.complete = received == total;
+    return result;
+}
+
+Result benchLocked(int producers, int messagesPerProducer) {
+    LockedMessageQueue queue;
+    return runBenchmark(producers, messagesPerProducer,
+        [&queue](int p) -> uint64_t {
+            queue.push(makeMessage(p));
+            return 0;
+        },
+        [&queue](uint64_t total) {
+            uint64_t received = 0;
+            while (received < total && queue.pop()) {
+                ++received;
+            }
+            return received;
+        });
+}
+
+Result benchLockFree(int producers, int messagesPerProducer, size_t batchSize) {
+    MessageQueue queue;
+    return runBenchmark(producers, messagesPerProducer,
+        [&queue](int p) -> uint64_t {
+            // 队列满时让出CPU重试，统计重试次数
+            uint64_t retries = 0;
+            while (!queue.push(makeMessage(p))) {
+                ++retries;
+                std::this_thread::yield();
+            }
+            return retries;
+        },
+        [&queue, batchSize](uint64_t total) {
+            std::vector<MessagePtr> batch;
+            batch.reserve(batchSize);
+            uint64_t received = 0;
+            while (received < total) {
+                received += queue.popBatch(batch, batchSize, 1000);
+                batch.clear();
+            }
+            return received;
+        });
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int messagesPerProducer = 200000;
+    int maxProducers = 8;
+    size_t batchSize = 64;
+
+    // 解析命令行参数
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if ((arg == "-n" || arg == "--count") && i + 1 < argc)
+        {
+            messagesPerProducer = std::stoi(argv[++i]);
+        }
+        else if ((arg == "-p" || arg == "--producers") && i + 1 < argc)
+        {
+            maxProducers = std::stoi(argv[++i]);
+        }
+        else if ((arg == "-b" || arg == "--batch") && i + 1 < argc)
+        {
+            batchSize = static_cast<size_t>(std::max(1, std::stoi(argv[++i])));
+        }
+    }
+
+    spdlog::info("{} messages per producer, consumer batch {}", messagesPerProducer, batchSize);
+    bool passed = true;
+    for (int producers = 1; producers <= maxProducers; producers *= 2)
+    {
+        Result locked = benchLocked(producers, messagesPerProducer);
+        Result lockFree = benchLockFree(producers, messagesPerProducer, batchSize);
+        spdlog::info("{} producer(s): mutex/condvar {:.2f} M msg/s, lock-free {:.2f} M msg/s ({:.1f}x), {} full retries",
+                     producers, locked.millionsPerSecond, lockFree.millionsPerSecond,
+                     lockFree.millionsPerSecond / locked.millionsPerSecond, lockFree.fullRetries);
+        passed = passed && locked.complete && lockFree.complete;
+    }
+
+    if (!passed) {
+        spdlog::error("Message queue benchmark lost messages");
+    }
+    return passed ? 0 : 1;
+}
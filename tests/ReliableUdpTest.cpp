@@ -0,0 +1,140 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "spdlog/spdlog.h"
+
+#include "../src/network/UdpTransport.h"
+
+// 可靠UDP回环测试：服务端与客户端在127.0.0.1上各自模拟丢包，
+// 检查可靠有序消息全部按序到达、可靠无序消息全部到达，不可靠消息只统计到达率
+class ReliableUdpTest
+{
+private:
+    ReliableUdpOptions options;
+    int messageCount;
+
+    std::mutex mutex;
+    std::vector<std::string> received;
+    std::atomic<int> unorderedCount{0};
+    std::atomic<int> unreliableCount{0};
+
+public:
+    ReliableUdpTest(uint32_t lossPercent, int count)
+        : messageCount(count)
+    {
+        options.simulatedLossPercent = lossPercent;
+        options.idleTimeoutMs = 0;
+    }
+
+    // 第i条可靠消息，长度覆盖单分片和多分片两种情况
+    static std::string makeMessage(int i)
+    {
+        size_t length = 16 + (static_cast<size_t>(i) * 997) % 4000;
+        std::string message(length, static_cast<char>('a' + i % 26));
+        message.replace(0, std::to_string(i).size(), std::to_string(i));
+        return message;
+    }
+
+    bool run()
+    {
+        spdlog::info("=== Reliable UDP Loopback Test (loss {}%, {} messages) ===", options.simulatedLossPercent, messageCount);
+
+        UdpTransport server(options);
+        UdpTransport client(options);
+
+        server.setMessageCallback([this](uint32_t conv, uint32_t generation, const BufferSlice& message, UdpChannel channel) {
+            (void)conv;
+            (void)generation;
+            if (channel == UdpChannel::RELIABLE) {
+                std::lock_guard<std::mutex> lock(mutex);
+                received.push_back(message.toString());
+            } else if (channel == UdpChannel::UNORDERED) {
+                unorderedCount++;
+            } else {
+                unreliableCount++;
+            }
+        });
+
+        if (!server.start("127.0.0.1", 0) || !client.start("127.0.0.1", 0)) {
+            spdlog::error("Failed to start UDP transports");
+            return false;
+        }
+
+        const uint32_t conv = 1;
+        uint32_t generation = client.connect(conv, "127.0.0.1", server.getLocalPort());
+        if (generation == 0) {
+            spdlog::error("Failed to connect UDP session");
+            return false;
+        }
+
+        auto startTime = std::chrono::steady_clock::now();
+        for (int i = 0; i < messageCount; ++i) {
+            client.send(conv, generation, BufferSlice(makeMessage(i)), UdpChannel::RELIABLE);
+            client.send(conv, generation, BufferSlice("unordered " + std::to_string(i)), UdpChannel::UNORDERED);
+            client.send(conv, generation, BufferSlice("unreliable " + std::to_string(i)), UdpChannel::UNRELIABLE);
+        }
+
+        // 等待全部可靠消息到达，最多30秒
+        while (std::chrono::steady_clock::now() - startTime < std::chrono::seconds(30)) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (static_cast<int>(received.size()) == messageCount && unorderedCount == messageCount) {
+                    break;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+
+        client.stop();
+        server.stop();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        bool ordered = static_cast<int>(received.size()) == messageCount;
+        for (size_t i = 0; ordered && i < received.size(); ++i) {
+            if (received[i] != makeMessage(static_cast<int>(i))) {
+                spdlog::error("Reliable message {} arrived out of order or corrupted", i);
+                ordered = false;
+            }
+        }
+
+        spdlog::info("Reliable: {}/{} in order, unordered: {}/{}, unreliable: {}/{}, {} ms",
+                     received.size(), messageCount, unorderedCount.load(), messageCount,
+                     unreliableCount.load(), messageCount, elapsed.count());
+
+        bool passed = ordered && unorderedCount == messageCount;
+        if (passed) {
+            spdlog::info("Reliable UDP test passed");
+        } else {
+            spdlog::error("Reliable UDP test failed");
+        }
+        return passed;
+    }
+};
+
+int main(int argc, char* argv[])
+{
+    uint32_t lossPercent = 20;
+    int messageCount = 2000;
+
+    // 解析命令行参数
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if ((arg == "-l" || arg == "--loss") && i + 1 < argc)
+        {
+            lossPercent = static_cast<uint32_t>(std::stoi(argv[++i]));
+        }
+        else if ((arg == "-n" || arg == "--count") && i + 1 < argc)
+        {
+            messageCount = std::stoi(argv[++i]);
+        }
+    }
+
+    ReliableUdpTest test(lossPercent, messageCount);
+    return test.run() ? 0 : 1;
+}